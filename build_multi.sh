@@ -0,0 +1,76 @@
+#!/bin/bash
+# build_multi.sh
+# 2018-03-27  Markku-Juhani O. Saarinen <mjos@iki.fi>
+#
+# Builds every candidate in the list into a static library of its own and
+# links them all into one runner, so that candidates can be selected with
+# -r <regex> and run in a single process without recompiling.
+
+if [ "$#" -lt 1 ]; then
+	echo "Usage: build_multi.sh <kem implementation list file> [build dir]"
+	exit
+fi
+
+export XKEM_CC=${XKEM_CC:-gcc}
+export CFLAGS=${CFLAGS:-'-Ofast -pthread'}
+base_dir=`pwd`
+out_dir=`mkdir -p ${2:-build_multi} && cd ${2:-build_multi} && pwd`
+
+# build_test.sh scripts call $CC on $XKEM_SRC + the candidate sources
+
+export CC="$base_dir/src/xkem_cc.sh"
+export XKEM_SRC="$base_dir/src/xkem_entry.c"
+export XKEM_BIN='./xkem_test'
+
+reg="$out_dir/xkem_reg.h"
+ents=""
+libs=""
+rm -f $out_dir/lib*.a
+
+for x in `cat $1 | tr '\n' ' '`
+do
+	kem=`basename $x`
+	id=`echo -n $kem | tr -c 'A-Za-z0-9_' '_'`
+	obj="$out_dir/$id.o"
+	echo -n "== $kem ==  "
+
+	rm -f $obj
+	(cd $x && XKEM_OBJ=$obj XKEM_ENTRY=xkem_$id \
+		./build_test.sh 2> $out_dir/$id.err)
+	if [ ! -s $obj ]; then
+		echo "build failed, see $out_dir/$id.err"
+		continue
+	fi
+
+	# hide everything but the registry entry; prefix the API for profiling
+
+	objcopy --redefine-sym crypto_kem_keypair=${id}_crypto_kem_keypair \
+		--redefine-sym crypto_kem_enc=${id}_crypto_kem_enc \
+		--redefine-sym crypto_kem_dec=${id}_crypto_kem_dec \
+		--keep-global-symbol=xkem_$id $obj
+	ar rcs $out_dir/lib$id.a $obj
+	ents="$ents $id"
+	libs="$libs `cat $obj.libs`"
+	rm -f $obj $obj.libs
+	echo "ok"
+done
+
+# registry for kem_test.c
+
+echo "// xkem_reg.h -- generated by build_multi.sh" > $reg
+for id in $ents
+do
+	echo "extern const xkem_t xkem_$id;" >> $reg
+done
+echo "static const xkem_t *xkem_reg[] = {" >> $reg
+for id in $ents
+do
+	echo "    &xkem_$id," >> $reg
+done
+echo "    NULL };" >> $reg
+
+libs=`echo $libs | tr ' ' '\n' | sort -u | tr '\n' ' '`
+$XKEM_CC $CFLAGS -DXKEM_MULTI -I$out_dir -o $out_dir/xkem_multi \
+	src/kem_test.c `for id in $ents; do echo $out_dir/lib$id.a; done` \
+	$libs -lcrypto || exit 1
+echo "Runner: $out_dir/xkem_multi [-l] [-r <regex>] [-t [threads]]"
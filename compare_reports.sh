@@ -0,0 +1,115 @@
+#!/bin/bash
+# compare_reports.sh
+# 2018-03-27  Markku-Juhani O. Saarinen <mjos@iki.fi>
+#
+# Compares two JSON Lines reports written by kem_test.c (-j) and flags
+# latency changes that are both statistically significant (Welch's t-test
+# at 95%) and larger than the threshold percentage. Operations that are
+# only in the old report (build failures, timeouts) are listed as removed.
+# Exit status is 1 if there were any regressions or removals.
+
+if [ "$#" -lt 2 ]; then
+	echo "Usage: compare_reports.sh <old.jsonl> <new.jsonl> [threshold %]"
+	exit 2
+fi
+
+awk -v thr=${3:-2} '
+
+# value of "key" in a flat JSON record
+
+function val(rec, key,    r) {
+	if (match(rec, "\"" key "\":(\"([^\"\\\\]|\\\\.)*\"|[^,}]*)") == 0)
+		return ""
+	r = substr(rec, RSTART + length(key) + 3, RLENGTH - length(key) - 3)
+	gsub(/^"|"$/, "", r)
+	return r
+}
+
+# two-sided 95% critical value of Student t with df degrees of freedom
+
+function tcrit(df) {
+	if (df < 1.5)	return 12.71
+	if (df < 2.5)	return 4.303
+	if (df < 3.5)	return 3.182
+	if (df < 4.5)	return 2.776
+	if (df < 5.5)	return 2.571
+	if (df < 7.5)	return 2.447
+	if (df < 10.5)	return 2.262
+	if (df < 15.5)	return 2.145
+	if (df < 20.5)	return 2.093
+	if (df < 30.5)	return 2.045
+	if (df < 60.5)	return 2.000
+	if (df < 120.5)	return 1.980
+	return 1.960
+}
+
+{
+	if (val($0, "stddev") == "")
+		next
+	key = val($0, "candidate") "\t" val($0, "operation")
+	f = (FNR == NR) ? 0 : 1
+	if (!((f, key) in n) && f == 1)
+		keys[++nkeys] = key
+	if (!((f, key) in n) && f == 0)
+		okeys[++nokeys] = key
+	n[f, key] = val($0, "iterations") + 0
+	m[f, key] = val($0, "mean") + 0
+	s[f, key] = val($0, "stddev") + 0
+	if (f == 0)
+		seen[key] = 1
+	else
+		kept[key] = 1
+}
+
+END {
+	regr = 0
+	printf("%-28s %-7s %12s %12s %8s %8s  %s\n", "candidate", "op",
+		"old clk", "new clk", "change", "t", "verdict")
+	for (i = 1; i <= nkeys; i++) {
+		key = keys[i]
+		split(key, kv, "\t")
+		if (!(key in seen)) {
+			printf("%-28s %-7s %12s %12.0f %8s %8s  new\n",
+				kv[1], kv[2], "-", m[1, key], "-", "-")
+			continue
+		}
+		n0 = n[0, key];	m0 = m[0, key];	v0 = s[0, key] ^ 2
+		n1 = n[1, key];	m1 = m[1, key];	v1 = s[1, key] ^ 2
+		chg = m0 > 0 ? 100.0 * (m1 - m0) / m0 : 0
+		se = (n0 > 0 ? v0 / n0 : 0) + (n1 > 0 ? v1 / n1 : 0)
+
+		# Welch-Satterthwaite degrees of freedom
+
+		if (se > 0 && n0 > 1 && n1 > 1) {
+			t = (m1 - m0) / sqrt(se)
+			df = se ^ 2 / ((v0 / n0) ^ 2 / (n0 - 1) + \
+				(v1 / n1) ^ 2 / (n1 - 1) + 1E-300)
+			sig = (t > tcrit(df) || -t > tcrit(df))
+		} else {
+			t = 0
+			sig = 0
+		}
+
+		verdict = "-"
+		if (sig && chg > thr) {
+			verdict = "REGRESSION"
+			regr++
+		} else if (sig && -chg > thr) {
+			verdict = "improved"
+		} else if (sig) {
+			verdict = "(< " thr "%)"
+		}
+		printf("%-28s %-7s %12.0f %12.0f %+7.2f%% %8.2f  %s\n",
+			kv[1], kv[2], m0, m1, chg, t, verdict)
+	}
+	for (i = 1; i <= nokeys; i++) {
+		key = okeys[i]
+		if (key in kept)
+			continue
+		split(key, kv, "\t")
+		printf("%-28s %-7s %12.0f %12s %8s %8s  removed\n",
+			kv[1], kv[2], m[0, key], "-", "-", "-")
+		regr++
+	}
+	exit(regr > 0)
+}' "$1" "$2"
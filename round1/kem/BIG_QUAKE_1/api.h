@@ -26,6 +26,17 @@
 
 #define CRYPTO_ALGNAME "BIG_QUAKE_1"
 
+//Expanded keys for kem_expand.h: pk as it is; sk loaded into a decoder
+//(goppa_dec_t, see goppa.h) with its syndrome table
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES PUBLICKEY_BYTES
+#define CRYPTO_EXPANDEDSKBYTES DECODER_BYTES
+
+//each cache entry holds pk twice
+#ifndef KEM_CACHE_WAYS
+#define KEM_CACHE_WAYS 2
+#endif
+
 
 #define CHECK_STATUS(stat) {if(stat != SUCCESS) {goto EXIT;}}
 //$Elise : Ajouter le types d'erreurs ici
@@ -58,4 +69,24 @@ int crypto_kem_dec(OUT unsigned char *ss,
                    IN unsigned char *ct,
                    IN unsigned char *sk);
 
+////////////////////////////////////////////////////////////////
+//Expanded keys (kem_expand.h):
+////////////////////////////////////////////////////////////////
+//Expand pk - a copy of pk
+int crypto_kem_expand_pk(OUT unsigned char *epk, IN unsigned char *pk);
+
+//Encapsulate to an expanded public key epk
+int crypto_kem_enc_expanded(OUT unsigned char *ct,
+                            OUT unsigned char *ss,
+                            IN unsigned char *epk);
+
+//Expand sk - sk loaded once into esk, CRYPTO_EXPANDEDSKBYTES bytes
+//              and 8-byte aligned
+int crypto_kem_expand_sk(OUT unsigned char *esk, IN unsigned char *sk);
+
+//Decapsulate with an expanded secret key esk, which is only read
+int crypto_kem_dec_expanded(OUT unsigned char *ss,
+                            IN unsigned char *ct,
+                            IN unsigned char *esk);
+
 #endif
@@ -1,5 +1,5 @@
 #!/bin/bash
 
-gcc -g -o $XKEM_BIN -I. \
+$CC -g -o $XKEM_BIN -I. \
 	-I../../nist \
-	-DXBENCH_REPS=5 ../../nist/rng.c $XKEM_SRC *.c -lcrypto
+	-DXBENCH_REPS=5 ../../nist/rng.c ../../nist/keccakx.c ../../nist/kem_cache.c $XKEM_SRC *.c -lcrypto
@@ -42,10 +42,8 @@ void shift_cols(unsigned char * in, unsigned char * out, int d) {
 int encrypt_nied(OUT unsigned char *syndrome, IN int * e, unsigned char * pk) {
 
     int i;
-    unsigned char *perm_cols, *syn_aux;
-    
-    perm_cols = malloc(BITS_TO_BYTES(CODIMENSION)*sizeof(unsigned char));
-    syn_aux = malloc(BITS_TO_BYTES(CODIMENSION)*sizeof(unsigned char));
+    unsigned char perm_cols[BITS_TO_BYTES(CODIMENSION)];
+    unsigned char syn_aux[BITS_TO_BYTES(CODIMENSION)];
     
 
     memset(perm_cols, 0, BITS_TO_BYTES(CODIMENSION));
@@ -63,47 +61,52 @@ int encrypt_nied(OUT unsigned char *syndrome, IN int * e, unsigned char * pk) {
     }
     
     memcpy(syndrome, syn_aux, SYNDROME_BYTES);
-
-    free(perm_cols);
-    free(syn_aux);
     
     return SUCCESS;
 }
 
 
+/* decoding scratch, one per thread */
+static __thread goppa_ws_t kem_ws;
+
 /**
-   Store in 'error' a decryption of 'syndrome', using secret key 'sk'.
+   Load secret key 'sk' into 'dec'. With 'parity', the syndrome table is
+   precomputed too.
  */
-int decrypt_nied(IN unsigned char *syndrome, OUT int * error, IN unsigned char * sk) {
-    int i;
-    goppa_t gamma;
-    
-    //Initialisation of gamma from sk
-    gf_init(EXT_DEGREE);
+static void kem_load_sk(goppa_dec_t * dec, IN unsigned char * sk, int parity) {
     
     //Support L
-    gfelt_t * L = (gfelt_t *) sk;
+    const gfelt_t * L = (const gfelt_t *) sk;
     
     //Polynome g
     sk += LENGTH * sizeof (gfelt_t);    
-    poly_t g = poly_alloc_from_string(NB_ERRORS, sk);
-    poly_set_deg(g, NB_ERRORS);
+    const gfelt_t * g = (const gfelt_t *) sk;
     
     //Polynome sqrtzmod
     sk += (NB_ERRORS + 1) * sizeof (gfelt_t);
-    poly_t sqrtzmod = poly_alloc_from_string(NB_ERRORS - 1, sk);
-    poly_calcule_deg(sqrtzmod);
+    const gfelt_t * sqrtzmod = (const gfelt_t *) sk;
+    
+    goppa_dec_init(dec, L, g, sqrtzmod, parity);
+}
+
+
+/**
+   Store in 'error' a decryption of 'syndrome', using secret key 'sk'.
+ */
+int decrypt_nied(IN unsigned char *syndrome, OUT int * error, IN unsigned char * sk) {
+    int i;
+    goppa_dec_t * dec;
     
-    //Goppa code gamma
-    gamma = goppa_init(L, g, LENGTH, NB_ERRORS, ORDER, sqrtzmod);
+    // a single use does not pay for the syndrome table
+    dec = malloc(sizeof (goppa_dec_t));
+    if (dec == NULL)
+        return FAIL;
+    kem_load_sk(dec, sk, 0);
 
     //Decode
-    i = goppa_decode(syndrome, error, gamma);
+    i = goppa_decode_ctx(syndrome, error, dec, &kem_ws);
     
-    free(gamma->Linv);
-    free(gamma);
-    free(sqrtzmod);
-    free(g);
+    free(dec);
 
     if (i<0)
        return FAIL;
@@ -150,31 +153,33 @@ int crypto_kem_keypair(OUT unsigned char *pk, OUT unsigned char *sk) {
 int crypto_kem_enc(OUT unsigned char *ct, OUT unsigned char *ss, IN unsigned char *pk) {
 
     int i;
+    unsigned char m[RANDOM_BYTES];
+    int error[NB_ERRORS];
+    unsigned char syndrome[SYNDROME_BYTES];
+    unsigned char e[BITS_TO_BYTES(LENGTH)];
+    unsigned char m_xor_hash_e[HASH_SIZE];
+    unsigned char hash_m[HASH_SIZE];
+    unsigned char m_ct[RANDOM_BYTES + CIPHERTEXT_BYTES];
     
     //Random bits sequence m
-    unsigned char* m = malloc(RANDOM_BYTES * sizeof(unsigned char));
     randombytes(m, RANDOM_BYTES);
     
     //Construct an error e from m
-    int *error = (int *) malloc(NB_ERRORS*sizeof(int));
     m2error(m, error);
     
     //Encrypt e (Niederrieter)
-    unsigned char *syndrome = malloc(SYNDROME_BYTES*sizeof(unsigned char));
     encrypt_nied(syndrome, error, (unsigned char *) pk);
     
     //m XOR Hash(e)
-    unsigned char * e = calloc(BITS_TO_BYTES(LENGTH),sizeof(unsigned char));
+    memset(e, 0, sizeof (e));
     for (i = 0; i < NB_ERRORS; i++) {
         e[error[i]/8] ^= (1 << (error[i]%8));
     }
     
-    unsigned char * m_xor_hash_e = malloc(HASH_SIZE *sizeof(unsigned char));    
     FIPS202_SHA3_256(e, BITS_TO_BYTES(LENGTH), m_xor_hash_e);
     xor(m_xor_hash_e, m, RANDOM_BYTES); //$Elise : Tronquer les hashs?
     
     //Hash(m)
-    unsigned char * hash_m = malloc(HASH_SIZE *sizeof(unsigned char));
     FIPS202_SHA3_256(m, RANDOM_BYTES, hash_m); //$Elise : Tronquer les hashs?
     
     //Copy into ct
@@ -184,72 +189,51 @@ int crypto_kem_enc(OUT unsigned char *ct, OUT unsigned char *ss, IN unsigned cha
         
         
     // Create shared secret
-    unsigned char *m_ct = malloc((RANDOM_BYTES + CIPHERTEXT_BYTES)* sizeof(unsigned char));
-    
     memcpy(m_ct, m, RANDOM_BYTES);
     memcpy(m_ct + RANDOM_BYTES, ct, CIPHERTEXT_BYTES);        
     FIPS202_SHA3_256(m_ct, RANDOM_BYTES + CIPHERTEXT_BYTES, ss);
     
-    
-    //Free
-    free(m);
-    free(syndrome);
-    free(e);
-    free(m_xor_hash_e);
-    free(hash_m);
-    free(m_ct);
-    free(error);
-    
     return SUCCESS;
 }
 
 
 
 /**
-  Decapsulation:
+  Decapsulation, once the error vector 'error' has been decoded from
+  the syndrome in ct:
     - ct is a key encapsulation message (ciphertext),
-    - sk is the private key,
     - ss is the shared secret
 */
-int crypto_kem_dec(OUT unsigned char *ss, IN unsigned char *ct, IN unsigned char *sk) {
+static int kem_dec_check(OUT unsigned char *ss, IN unsigned char *ct, IN int * error) {
     
     int i;
-    int error[NB_ERRORS], error_bis[NB_ERRORS];
+    int error_bis[NB_ERRORS];
     int testing = TRUE;
+    unsigned char e[BITS_TO_BYTES(LENGTH)], e_bis[BITS_TO_BYTES(LENGTH)];
+    unsigned char c1_xor_hash_e[HASH_SIZE];
+    unsigned char m[RANDOM_BYTES];
+    unsigned char hash_m[HASH_SIZE];
+    unsigned char m_ct[RANDOM_BYTES + CIPHERTEXT_BYTES];
     
-    // Copy ct into ct_aux
-    unsigned char * ct_aux = malloc(CIPHERTEXT_BYTES* sizeof(unsigned char));
-    memcpy(ct_aux, ct, CIPHERTEXT_BYTES);
-    
-    // Split ct_aux into 3 parts
-    unsigned char * c1 = malloc(HASH_SIZE*sizeof(unsigned char));
-    unsigned char * c2 = malloc (SYNDROME_BYTES * sizeof(unsigned char));
-    unsigned char * c3 = malloc (HASH_SIZE * sizeof(unsigned char));
-    
-    memcpy(c1, ct_aux, HASH_SIZE);
-    memcpy(c2, ct_aux + HASH_SIZE, SYNDROME_BYTES);
-    memcpy(c3, ct_aux + HASH_SIZE + SYNDROME_BYTES, HASH_SIZE);
-    
-    // Decrypt c2 (syndrome)    
-    decrypt_nied(c2, error, sk); 
+    // ct is c1 || c2 || c3
+    IN unsigned char * c1 = ct;
+    IN unsigned char * c3 = ct + HASH_SIZE + SYNDROME_BYTES;
     
     // c1 XOR Hash(e) (= m)
-    unsigned char * e = calloc(BITS_TO_BYTES(LENGTH),sizeof(unsigned char));
+    memset(e, 0, sizeof (e));
     for (i = 0; i < NB_ERRORS; i++) {
         e[error[i]/8] ^= (1 << (error[i] % 8));
     }
     
-    unsigned char * c1_xor_hash_e = malloc(HASH_SIZE *sizeof(unsigned char));
     FIPS202_SHA3_256(e, BITS_TO_BYTES(LENGTH), c1_xor_hash_e);
-    xor(c1_xor_hash_e, c1, RANDOM_BYTES);
+    xor(c1_xor_hash_e, (unsigned char *) c1, RANDOM_BYTES);
     
-    unsigned char * m = malloc(RANDOM_BYTES*sizeof(unsigned char));
     memcpy(m, c1_xor_hash_e, RANDOM_BYTES);
 
     // Test correctness of 'e'    
     m2error(m, error_bis);
     
-    unsigned char * e_bis = calloc(BITS_TO_BYTES(LENGTH),sizeof(unsigned char));
+    memset(e_bis, 0, sizeof (e_bis));
     for (i = 0; i < NB_ERRORS; i++) {
         e_bis[error[i]/8] ^= (1 << (error[i] % 8));
     }
@@ -259,7 +243,6 @@ int crypto_kem_dec(OUT unsigned char *ss, IN unsigned char *ct, IN unsigned char
         testing = testing && (e[i] == e_bis[i]);
 
     // Test correctness of 'm'
-    unsigned char * hash_m = malloc(HASH_SIZE *sizeof(unsigned char));
     FIPS202_SHA3_256(m, RANDOM_BYTES, hash_m);
       
     for (i = 0; i < HASH_SIZE && testing; i++)
@@ -267,26 +250,67 @@ int crypto_kem_dec(OUT unsigned char *ss, IN unsigned char *ct, IN unsigned char
     
     // Construct the shared secret
     if (testing){
-        unsigned char * m_ct = malloc((RANDOM_BYTES + CIPHERTEXT_BYTES)* sizeof(unsigned char));
-        
        memcpy(m_ct, m, RANDOM_BYTES);
-       memcpy(m_ct + RANDOM_BYTES, ct_aux, CIPHERTEXT_BYTES);
+       memcpy(m_ct + RANDOM_BYTES, ct, CIPHERTEXT_BYTES);
        FIPS202_SHA3_256(m_ct, RANDOM_BYTES + CIPHERTEXT_BYTES, ss);
-			 free(m_ct);
     }
-    
-
-    // Free
-    free(m);
-    free(c1);
-    free(c2);
-    free(c3);
-    free(ct_aux);
-    free(e);
-    free(e_bis);
-    free(c1_xor_hash_e);
-    free(hash_m);
            
     return testing ? SUCCESS: FAIL;
 
 }
+
+
+/**
+  Decapsulation:
+    - ct is a key encapsulation message (ciphertext),
+    - sk is the private key,
+    - ss is the shared secret
+*/
+int crypto_kem_dec(OUT unsigned char *ss, IN unsigned char *ct, IN unsigned char *sk) {
+    
+    // positions that are not decoded stay 0
+    int error[NB_ERRORS] = { 0 };
+    
+    // Decrypt c2 (syndrome)    
+    decrypt_nied(ct + HASH_SIZE, error, (unsigned char *) sk); 
+    
+    return kem_dec_check(ss, ct, error);
+}
+
+
+/**
+   Expanded public key, which is pk itself.
+*/
+int crypto_kem_expand_pk(OUT unsigned char *epk, IN unsigned char *pk) {
+    memcpy(epk, pk, PUBLICKEY_BYTES);
+    return SUCCESS;
+}
+
+
+int crypto_kem_enc_expanded(OUT unsigned char *ct, OUT unsigned char *ss, IN unsigned char *epk) {
+    return crypto_kem_enc(ct, ss, epk);
+}
+
+
+/**
+   Expanded secret key: sk loaded into a goppa_dec_t, with the syndrome
+   table.
+*/
+int crypto_kem_expand_sk(OUT unsigned char *esk, IN unsigned char *sk) {
+    kem_load_sk((goppa_dec_t *) esk, sk, 1);
+    return SUCCESS;
+}
+
+
+/**
+  Decapsulation with an expanded secret key. Allocates nothing; esk is
+  only read, so threads can share it.
+*/
+int crypto_kem_dec_expanded(OUT unsigned char *ss, IN unsigned char *ct, IN unsigned char *esk) {
+    
+    int error[NB_ERRORS] = { 0 };
+    
+    goppa_decode_ctx(ct + HASH_SIZE, error, (const goppa_dec_t *) esk, &kem_ws);
+    
+    return kem_dec_check(ss, ct, error);
+}
@@ -6,10 +6,16 @@
 
 typedef uint16_t index_t;
 
+/* hash chain from which m2error() draws, kept by the caller */
+typedef struct m2e_hash {
+    unsigned char buff[HASH_SIZE];
+    int buff_size;
+} m2e_hash_t;
+
 void swap_m2e(int * permutation, int a, int b);
-void init_hash(IN unsigned char *m);
-unsigned char * hash_trunc(int s); 
-int uniform_m2e(int s, int module);
+void init_hash(m2e_hash_t * h, IN unsigned char *m);
+void hash_trunc(m2e_hash_t * h, unsigned char * out, int s);
+int uniform_m2e(m2e_hash_t * h, int s, int module);
 int m2error(IN unsigned char *m, OUT int * error);
 
 
@@ -31,6 +31,7 @@ int poly_calcule_deg(poly_t p);
 int poly_adjust_deg(poly_t p);
 poly_t poly_alloc(int d);
 poly_t poly_alloc_from_string(int d, const unsigned char * s);
+poly_t poly_init(poly_t p, gfelt_t * coeff, int d);
 poly_t poly_copy(poly_t p);
 void poly_free(poly_t p);
 void poly_set_to_zero(poly_t p);
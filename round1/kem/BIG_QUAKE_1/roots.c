@@ -2,6 +2,7 @@
 #include <string.h>
 #include "gf.h"
 #include "poly.h"
+#include "goppa.h"
 
 int roots_kernel(gfindex_t * M, gfindex_t * K) {
 	int i, j, k;
@@ -155,125 +156,62 @@ gfindex_t roots_mulmv(gfindex_t * M, gfindex_t a) {
 	return b;
 }
 
-gfindex_t * F, * R2, ** R3;
-poly_t * tr, * aux1, * aux2, * aux3, * tr_aux, * sq_aux ;
-int * level_flag;
-int roots_init_done = 0;
-
-int roots_precomp_init_done = 0;
-
-void roots_precomp_clear() {
-	int i;
+/*
+	All the scratch of roots_berl() is in a roots_ws_t (goppa.h). The
+	global one below is only used by roots_berl(), roots_berl_ws() runs
+	with a workspace of the caller.
+*/
+static roots_ws_t roots_global_ws;
 
-	if (roots_precomp_init_done) {
-		for (i = 0; i < roots_init_done; ++i) {
-			poly_free(tr_aux[i]);
-			if (tr[i] != NULL) {
-				poly_free(tr[i]);
-				poly_free(aux1[i]);
-				poly_free(aux2[i]);
-				poly_free(aux3[i]);
-			}
-		}
-		for (i = 0; i < roots_precomp_init_done; ++i) {
-			poly_free(sq_aux[i]);
-		}
-		free(sq_aux);
-		roots_precomp_init_done = 0;
-	}
+void roots_clear() {
 }
 
-void roots_precomp_init(int t) {
-	if (roots_precomp_init_done < t) {
-		int i;
-
-		if (roots_precomp_init_done) {
-			roots_precomp_clear();
-		}
-		sq_aux = malloc(t * sizeof (poly_t));
-		for (i = 0; i < t; ++i)
-			sq_aux[i] = poly_alloc(t + 1);
-		for (i = 0; i < gf_extd(); ++i)
-			tr_aux[i] = poly_alloc(t - 1);
-
-		roots_precomp_init_done = t;
-	}
+void roots_init() {
 }
 
-void roots_clear() {
+/*
+	F is the inverse of the linear map z->z^2+z (on the elements of
+	trace 0), so that b=a*F is such that b^2+b=a
+*/
+static void roots_init_F(gfindex_t * F) {
+	gfindex_t M[gf_extd()], T[gf_extd()];
 	int i;
+	gf_t a;
 
-	if (roots_init_done) {
-		free(F);
-		free(R2);
-		for (i = 0; i < (1 << roots_init_done); ++i) {
-			if (R3[i] != NULL) {
-				free(R3[i]);
-			}
-		}
-		free(R3);
-		roots_precomp_clear();
-		free(tr);
-		free(tr_aux);
-		free(aux1);
-		free(aux2);
-		free(aux3);
-		free(level_flag);
-		roots_init_done = 0;
+	// solve z^2+z=0
+	for (i = 0; i < gf_extd(); ++i) {
+		gf_from_index(a, 1 << i);
+		gf_square(a, a);
+		M[i] = (1 << i) ^ gf_to_index(a);
 	}
+	roots_transpose(M, T);
+	roots_invert(T, M, NULL);
+	roots_transpose(M, F);
 }
 
-void roots_init() {
-	gfindex_t M[gf_extd()], T[gf_extd()];
+static void roots_ws_init(roots_ws_t * ws) {
 	int i;
-	gf_t a;
 
-	if (roots_init_done != gf_extd()) {
-		if (roots_init_done > 0) {
-			roots_clear();
-		}
-		F = malloc(gf_extd() * sizeof (gfindex_t));
-
-		// solve z^2+z=0
-		for (i = 0; i < gf_extd(); ++i) {
-			gf_from_index(a, 1 << i);
-			gf_square(a, a);
-			M[i] = (1 << i) ^ gf_to_index(a);
-		}
-		roots_transpose(M, T);
-		roots_invert(T, M, NULL);
-		roots_transpose(M, F);
-		R2 = calloc(1 << gf_extd(), sizeof (gfindex_t));
-		R3 = calloc(1 << gf_extd(), sizeof (gfindex_t *));
-		roots_init_done = gf_extd();
-
-		tr = calloc(gf_extd(), sizeof (poly_t));
-		tr_aux = calloc(gf_extd(), sizeof (poly_t));
-		aux1 = calloc(gf_extd(), sizeof (poly_t));
-		aux2 = calloc(gf_extd(), sizeof (poly_t));
-		aux3 = calloc(gf_extd(), sizeof (poly_t));
-		level_flag = calloc(gf_extd(), sizeof (int));
+	for (i = 0; i < gf_extd(); ++i) {
+		poly_init(ws->tr + i, ws->tr_c[i], NB_ERRORS - 1);
+		poly_init(ws->tr_aux + i, ws->tr_aux_c[i], NB_ERRORS - 1);
+		poly_init(ws->aux1 + i, ws->aux1_c[i], NB_ERRORS);
+		poly_init(ws->aux2 + i, ws->aux2_c[i], NB_ERRORS);
+		poly_init(ws->aux3 + i, ws->aux3_c[i], NB_ERRORS - 1);
+		ws->level_flag[i] = 0;
 	}
+	for (i = 0; i < NB_ERRORS; ++i)
+		ws->sq_aux[i] = poly_init(ws->sq_poly + i, ws->sq_aux_c[i], NB_ERRORS + 1);
+	roots_init_F(ws->F);
 }
 
 /*
-	Compute and store one of the two solutions R2[a] of the equation
-	z^2+z=a in the finite field. The other solution is R2[a]+1.  If
-	z^2+z=a has no solutions in the finite field, the result is
-	unspecified.
+	One of the two solutions of the equation z^2+z=a in the finite
+	field. The other solution is the result plus 1. If z^2+z=a has no
+	solutions in the finite field, the result is unspecified.
 */
-gfindex_t roots2_linear(gfindex_t a) {
-	if (R2[a] == 0) {
-		if (a == 0) {
-			R2[a] = 1;
-		}
-		/*
-			The matrix F contains an inverse of z->z^2+z, so that b=a*F is
-			such that b^2+b=a
-		*/
-		R2[a] = roots_mulvm(a, F);
-	}
-	return R2[a];
+static gfindex_t roots2_linear(gfindex_t a, const gfindex_t * F) {
+	return roots_mulvm(a, (gfindex_t *) F);
 }
 
 /*
@@ -281,7 +219,7 @@ gfindex_t roots2_linear(gfindex_t a) {
 	in the finite field, those roots are placed in the table res.
 	Else, the result is unspecified.
 */
-int roots2(gfelt_t * coeff, gfelt_t * res) {
+int roots2(gfelt_t * coeff, gfelt_t * res, const gfindex_t * F) {
   gf_t a, b, c;
 
 	// coeff[2] != 0 because the degree is 2
@@ -290,7 +228,7 @@ int roots2(gfelt_t * coeff, gfelt_t * res) {
 	gf_mul_fast(b, coeff + 2, coeff);
 	gf_mul_fast(c, coeff + 1, coeff + 1);
 	gf_div(b, b, c);
-	gf_from_index(c, roots2_linear(gf_to_index(b)));
+	gf_from_index(c, roots2_linear(gf_to_index(b), F));
 	gf_mul_fast(res, a, c);
 	gf_add(res + 1, res, a); // =a*(c+1)
 
@@ -402,24 +340,18 @@ int roots4(gfelt_t * coeff, gfelt_t * res) {
 
 #define BZ_LIMIT 4
 
-void roots_precomp_init_level(int e) {
-  if (level_flag[e] == 0) {
-		int i, j, t = roots_precomp_init_done;
+static void roots_precomp_init_level(roots_ws_t * ws, int e, int t) {
+  if (ws->level_flag[e] == 0) {
+		int i, j;
 		gf_t a, b;
-		if (tr[e] == NULL) {
-			tr[e] = poly_alloc(t - 1);
-			aux1[e] = poly_alloc(t);
-			aux2[e] = poly_alloc(t);
-			aux3[e] = poly_alloc(t - 1);
-		}
-		else {
-			poly_set_to_zero(tr[e]);
-		}
+		poly_t tr = ws->tr + e;
+
+		poly_set_to_zero(tr);
 		if (e == 0) { // level 0 is much simpler
-			poly_set_coeff_to_unit(tr[0], 1);
+			poly_set_coeff_to_unit(tr, 1);
 			for (i = 1; i < gf_extd(); ++i) {
 				for (j = 0; j < t; ++j) {
-					poly_addto_coeff(tr[0], j, poly_coeff(tr_aux[i], j));
+					poly_addto_coeff(tr, j, poly_coeff(ws->tr_aux + i, j));
 				}
 			}
 		}
@@ -427,20 +359,21 @@ void roots_precomp_init_level(int e) {
 			gf_from_index(a, 1 << e);
 			for (i = 0; i < gf_extd(); ++i) {
 				for (j = 0; j < t; ++j) {
-					gf_mul_fast(b, a, poly_coeff(tr_aux[i], j));
-					poly_addto_coeff(tr[e], j, b);
+					gf_mul_fast(b, a, poly_coeff(ws->tr_aux + i, j));
+					poly_addto_coeff(tr, j, b);
 				}
 				gf_square(a, a);
 			}
 		}
-    poly_calcule_deg(tr[e]);
-		level_flag[e] = 1;
+    poly_calcule_deg(tr);
+		ws->level_flag[e] = 1;
   }
 }
 
-// destructive for sigma
-int roots_berl_aux(poly_t sigma, int d, int e, gfelt_t * res) {
-	poly_t gcd1, gcd2;
+// destructive for sigma, t is the degree of the initial sigma
+static int roots_berl_aux(poly_t sigma, int d, int e, gfelt_t * res,
+													roots_ws_t * ws, int t) {
+	poly_t gcd1, gcd2, aux1, aux2, aux3;
 	int i, j;
 
   if (d == 0) {
@@ -454,7 +387,7 @@ int roots_berl_aux(poly_t sigma, int d, int e, gfelt_t * res) {
 
 #if BZ_LIMIT >= 2
   if (d == 2) {
-		return roots2(sigma->coeff, res);
+		return roots2(sigma->coeff, res, ws->F);
   }
 #endif
 
@@ -475,49 +408,53 @@ int roots_berl_aux(poly_t sigma, int d, int e, gfelt_t * res) {
     return 0;
   }
 
-	roots_precomp_init_level(e);
-	poly_set(aux3[e], tr[e]);
+	roots_precomp_init_level(ws, e, t);
+	aux1 = ws->aux1 + e;
+	aux2 = ws->aux2 + e;
+	aux3 = ws->aux3 + e;
+	poly_set(aux3, ws->tr + e);
 	/* poly_ee_aux() is destructive - the value of sigma is changed - we
-		 will use either (aux1[e], aux3[e]) or (aux2[e], sigma) */
-	if (poly_deg(aux3[e]) >= poly_deg(sigma)) {
-		poly_rem(aux3[e], sigma);
+		 will use either (aux1, aux3) or (aux2, sigma) */
+	if (poly_deg(aux3) >= poly_deg(sigma)) {
+		poly_rem(aux3, sigma);
 	}
-	i = poly_ee_aux(aux1[e], aux2[e], sigma, aux3[e], 0);
+	i = poly_ee_aux(aux1, aux2, sigma, aux3, 0);
 	if (i & 1) {
-		gcd1 = aux1[e];
-		gcd2 = aux3[e];
+		gcd1 = aux1;
+		gcd2 = aux3;
 	}
 	else {
-		gcd1 = aux2[e];
+		gcd1 = aux2;
 		gcd2 = sigma;
 	}
 	poly_set_deg(gcd2, d - poly_deg(gcd1));
 
   i = poly_deg(gcd1);
-  j = roots_berl_aux(gcd1, i, e + 1, res);
-  j += roots_berl_aux(gcd2, d - i, e + 1, res + j);
+  j = roots_berl_aux(gcd1, i, e + 1, res, ws, t);
+  j += roots_berl_aux(gcd2, d - i, e + 1, res + j, ws, t);
 
   return j;
 }
 
-int roots_berl(poly_t sigma, gfelt_t * res) {
-	int i, d, t;
+// destructive for sigma, of degree at most NB_ERRORS
+int roots_berl_ws(poly_t sigma, gfelt_t * res, roots_ws_t * ws) {
+	int i, t;
 
 	t = poly_calcule_deg(sigma);
-	roots_init();
-	roots_precomp_init(t);
+	roots_ws_init(ws);
 
-	poly_sqmod_init(sigma, sq_aux);
-	poly_set_to_zero(tr_aux[0]);
-	poly_set_coeff_to_unit(tr_aux[0], 1);
-	poly_set_deg(tr_aux[0], 1);
+	poly_sqmod_init(sigma, ws->sq_aux);
+	poly_set_to_zero(ws->tr_aux);
+	poly_set_coeff_to_unit(ws->tr_aux, 1);
+	poly_set_deg(ws->tr_aux, 1);
 	for (i = 1; i < gf_extd(); ++i) {
-		poly_sqmod(tr_aux[i], tr_aux[i - 1], sq_aux, t);
+		poly_sqmod(ws->tr_aux + i, ws->tr_aux + i - 1, ws->sq_aux, t);
 	}
 
-	for (i = 0; i < gf_extd(); ++i) {
-		level_flag[i] = 0;
-	}
-	d = roots_berl_aux(sigma, t, 0, res);
-	return d;
+	return roots_berl_aux(sigma, t, 0, res, ws, t);
+}
+
+// not thread-safe, see roots_berl_ws()
+int roots_berl(poly_t sigma, gfelt_t * res) {
+	return roots_berl_ws(sigma, res, &roots_global_ws);
 }
@@ -48,11 +48,13 @@ int partition(int * tableau, int gauche, int droite, int pivot) {
     return gauche;
 }
 
+/* sorts the values of tableau[gauche..droite-1], which are in [min, max],
+   equal values (from an invalid syndrome) included */
 void quickSort(int * tableau, int gauche, int droite, int min, int max) {
-  if (gauche < droite - 1) {
+  if (gauche < droite - 1 && min < max) {
     int milieu = partition(tableau, gauche, droite, (max + min) / 2);
     quickSort(tableau, gauche, milieu, min, (max + min) / 2);
-    quickSort(tableau, milieu, droite, (max + min) / 2, max);
+    quickSort(tableau, milieu, droite, (max + min) / 2 + 1, max);
   }
 }
 
@@ -296,18 +298,173 @@ int goppa_decode(const unsigned char * b, int * e, goppa_t gamma) {
 }
 
 
+_Static_assert(sizeof (goppa_dec_t) <= DECODER_BYTES, "DECODER_BYTES too small");
 
+/*
+	Loads a secret key (support L, Goppa polynomial g of degree
+	NB_ERRORS and sqrtzmod = z^(1/2) mod g) into dec. If parity is non
+	zero, the syndrome table of goppa_decode_init() is precomputed as well:
+	building it takes longer than one decoding, and then saves most of the
+	time of each one.
+*/
+void goppa_dec_init(goppa_dec_t * dec, const gfelt_t * L, const gfelt_t * g,
+                    const gfelt_t * sqrtzmod, int parity) {
+	int i;
+	struct polynome gp, p;
+	gfelt_t f[NB_ERRORS];
+
+	memcpy(dec->L, L, sizeof (dec->L));
+	memcpy(dec->g, g, sizeof (dec->g));
+	poly_init(&gp, dec->g, NB_ERRORS);
+	poly_set_deg(&gp, NB_ERRORS);
+
+	memcpy(dec->sqrtmod[0], sqrtzmod, sizeof (dec->sqrtmod[0]));
+	for (i = 1; i < NB_ERRORS / 2; ++i) {
+		memcpy(dec->sqrtmod[i], dec->sqrtmod[i - 1], sizeof (dec->sqrtmod[i]));
+		poly_shiftmod(poly_init(&p, dec->sqrtmod[i], NB_ERRORS - 1), &gp);
+	}
+
+	memset(dec->Linv, 0, sizeof (dec->Linv));
+	for (i = 0; i < LENGTH; ++i)
+		dec->Linv[gf_to_index(dec->L + i)] = i;
+
+	dec->has_parity = parity;
+	if (parity) {
+		memset(dec->parity, 0, sizeof (dec->parity));
+		poly_init(&p, f, NB_ERRORS - 1);
+		for (i = 0; i < CODIMENSION; i++) {
+			poly_syndrome_patterson(&p, dec->L + (LENGTH - CODIMENSION) + i, &gp);
+			poly_to_bin_addto(&p, dec->parity[i], NB_ERRORS);
+		}
+	}
+}
+
+/* poly_eeaux() in the workspace: r0, r1, u0 and u1 of ws are overwritten */
+static void goppa_eeaux_ws(poly_t * u, poly_t * v, poly_t p, poly_t g, int t,
+                           goppa_ws_t * ws) {
+	int count;
+	poly_t r0, r1, u0, u1;
+
+	r0 = poly_init(&ws->r0, ws->r0_c, NB_ERRORS);
+	r1 = poly_init(&ws->r1, ws->r1_c, NB_ERRORS);
+	u0 = poly_init(&ws->u0, ws->u0_c, NB_ERRORS);
+	u1 = poly_init(&ws->u1, ws->u1_c, NB_ERRORS);
+	poly_set(r0, g);
+	poly_set(r1, p);
+
+	count = poly_ee_aux(u0, u1, r0, r1, t);
+	if (count & 1) {
+		*u = u0;
+		*v = r0;
+	}
+	else {
+		*u = u1;
+		*v = r1;
+	}
+}
 
+/* goppa_keyequation_patterson() with the precomputed sqrtmod of dec */
+static poly_t goppa_keyequation_ws(poly_t R, poly_t g, const goppa_dec_t * dec,
+                                   goppa_ws_t * ws) {
+	int i, j;
+	poly_t u, v, h, sigma, S, aux;
+	gf_t a, b;
 
+	sigma = poly_init(&ws->sigma, ws->sigma_c, NB_ERRORS);
+	poly_set_to_zero(sigma);
+	if (poly_deg(R) < 0) {
+		poly_set_coeff_to_unit(sigma, 0);
+		poly_set_deg(sigma, 0);
+		return sigma;
+	}
 
+	goppa_eeaux_ws(&h, &aux, R, g, 1, ws);
+	gf_inv(a, poly_coeff(aux, 0));
+	for (i = 0; i <= poly_deg(h); ++i) {
+		gf_mul_fast(b, a, poly_coeff(h, i));
+		poly_set_coeff(h, i, b);
+	}
 
+	//  compute h(z) += z
+	gf_set_to_unit(a);
+	poly_addto_coeff(h, 1, a);
 
+	// compute S square root of h (using sqrtmod)
+	S = poly_init(&ws->S, ws->S_c, NB_ERRORS - 1);
+	poly_set_to_zero(S);
+	for (i = 0; i < NB_ERRORS; i++) {
+		gf_sqrt(a, poly_coeff(h, i));
+		if (i & 1) {
+			if (!gf_is_zero(a)) {
+				for (j = 0; j < NB_ERRORS; j++) {
+					gf_mul_fast(b, a, dec->sqrtmod[i / 2] + j);
+					poly_addto_coeff(S, j, b);
+				}
+			}
+		}
+		else {
+			poly_addto_coeff(S, i / 2, a);
+		}
+	}
+	poly_calcule_deg(S);
 
+	// solve the key equation u(z) = v(z)*S(z) mod g(z)
+	goppa_eeaux_ws(&v, &u, S, g, NB_ERRORS / 2 + 1, ws);
 
+	// sigma = u^2+z*v^2
+	for (i = 0; i <= poly_deg(u); ++i) {
+		gf_square(b, poly_coeff(u, i));
+		poly_set_coeff(sigma, 2 * i, b);
+	}
+	for (i = 0; i <= poly_deg(v); ++i) {
+		gf_square(b, poly_coeff(v, i));
+		poly_set_coeff(sigma, 2 * i + 1, b);
+	}
+	poly_calcule_deg(sigma);
 
+	return sigma;
+}
 
+/*
+	goppa_decode() with a key loaded by goppa_dec_init(). dec is only
+	read, and all the scratch is in ws, so nothing is allocated and
+	threads can share dec, each with its own ws.
+*/
+int goppa_decode_ctx(const unsigned char * s, int * e,
+                     const goppa_dec_t * dec, goppa_ws_t * ws) {
+	int i, d;
+	struct polynome g;
+	poly_t R, sigma;
 
+	poly_init(&g, (gfelt_t *) dec->g, NB_ERRORS);
+	poly_set_deg(&g, NB_ERRORS);
 
+	// syndrome
+	R = poly_init(&ws->R, ws->R_c, NB_ERRORS);
+	poly_set_to_zero(R);
+	memset(ws->synd, 0, sizeof (ws->synd));
+	for (i = 0; i < CODIMENSION; i++) {
+		if ((s[i / 8] >> (i % 8)) & 1) {
+			if (dec->has_parity) {
+				xor_long(ws->synd, (unsigned long *) dec->parity[i], GOPPA_SYND_LONGS);
+			}
+			else {
+				poly_syndrome_patterson(R, (gfelt_t *) dec->L + (LENGTH - CODIMENSION) + i, &g);
+				poly_to_bin_addto(R, ws->synd, NB_ERRORS);
+			}
+		}
+	}
+	bin_to_poly(ws->synd, R, NB_ERRORS);
+	poly_calcule_deg(R);
 
+	sigma = goppa_keyequation_ws(R, &g, dec, ws);
 
+	// error positions, sorted in increasing order
+	d = roots_berl_ws(sigma, ws->roots, &ws->rws);
+	for (i = 0; i < d; ++i) {
+		e[i] = dec->Linv[gf_to_index(ws->roots + i)];
+	}
+	quickSort(e, 0, d, 0, LENGTH);
 
+	return d;
+}
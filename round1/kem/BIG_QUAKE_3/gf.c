@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include "api.h"
 #include "gf.h"
 #include "rng.h"
 
@@ -101,69 +102,61 @@ void gf_inv(gf_t a, gf_t x) {
 }
 */
 
+/*
+  The field is fixed by GF_EXT_DEGREE (api.h), so the tables have a
+  static size. They are filled by a constructor before main() and are
+  only read afterwards: all threads share them, and gf_init() does not
+  rebuild anything. (With 2^18 entries for BIG_QUAKE_3 and _5 they are
+  too large to be spelled out in the source.)
+*/
+static gfindex_t gf_log_tab[1 << GF_EXT_DEGREE];
+static gfelt_t gf_exp_tab[1 << GF_EXT_DEGREE];
+
+const int gf_extension_degree = GF_EXT_DEGREE;
+const int gf_cardinality = 1 << GF_EXT_DEGREE;
+const int gf_multiplicative_order = (1 << GF_EXT_DEGREE) - 1;
+const gfindex_t * const gf_log = gf_log_tab;
+const gfelt_t * const gf_exp = gf_exp_tab;
+
 // construct the table gf_exp[i]=alpha^i
-void gf_init_exp() {
+static void gf_init_exp() {
   int i;
 
-  gf_exp[0] = 1;
+  gf_exp_tab[0] = 1;
   for (i = 1; i < gf_ord(); ++i) {
-    gf_exp[i] = gf_exp[i - 1] << 1;
-    if (gf_exp[i - 1] & (1 << (gf_extd()-1)))
-      gf_exp[i] ^= prim_poly[gf_extd()];
+    gf_exp_tab[i] = gf_exp_tab[i - 1] << 1;
+    if (gf_exp_tab[i - 1] & (1 << (gf_extd()-1)))
+      gf_exp_tab[i] ^= prim_poly[gf_extd()];
   }
   // hack for the multiplication
-  gf_exp[gf_ord()] = 1;
+  gf_exp_tab[gf_ord()] = 1;
 }
 
 // construct the table gf_log[alpha^i]=i
-void gf_init_log() {
+static void gf_init_log() {
   int i;
 
-  gf_log[0] = gf_ord();// log of 0 by convention
+  gf_log_tab[0] = gf_ord();// log of 0 by convention
   for (i = 0; i < gf_ord() ; ++i)
-    gf_log[gf_exp[i]] = i;
+    gf_log_tab[gf_exp_tab[i]] = i;
 }
 
-int init_done = 0;
+static void __attribute__ ((constructor)) gf_init_tables() {
+  gf_init_exp();
+  gf_init_log();
+}
 
+// the tables are already there, only the extension degree is checked
 int gf_init(int extdeg) {
-  if ((extdeg < MIN_EXT_DEG) || (extdeg > MAX_EXT_DEG)) {
+  if (extdeg != GF_EXT_DEGREE) {
     fprintf(stderr,"Extension degree %d not implemented !\n", extdeg);
     exit(0);
   }
-  if (init_done != extdeg) {
-    if (init_done) {
-      free(gf_exp);
-      free(gf_log);
-    }
-		gf_extension_degree = extdeg;
-    gf_cardinality = 1 << extdeg;
-    gf_multiplicative_order = gf_cardinality - 1;
-		gf_log = (gfindex_t *) malloc((1 << gf_extd()) * sizeof (gfindex_t));
-		if (gf_log == NULL) {
-			fprintf(stderr,"allocation failed for gf_log!\n");
-			return 0;
-		}
-		gf_exp = (gfelt_t *) malloc((1 << gf_extd()) * sizeof (gfelt_t));
-		if (gf_exp == NULL) {
-			fprintf(stderr,"allocation failed for gf_exp!\n");
-			free(gf_log);
-			return 0;
-		}
-    gf_init_exp();
-    gf_init_log();
-		init_done = extdeg;
-  }
 
   return extdeg;
 }
 
 void gf_clear() {
-	if (init_done) {
-		free(gf_exp);
-		free(gf_log);
-	}
-	init_done = 0;
 }
 
 // we suppose i >= 0. By convention 0^0 = 1
@@ -8,9 +8,11 @@
 
 typedef uint32_t gfelt_t;
 typedef uint32_t gfindex_t;
-int gf_extension_degree, gf_cardinality, gf_multiplicative_order;
-gfindex_t * gf_log;
-gfelt_t * gf_exp;
+/* the field GF(2^GF_EXT_DEGREE) of api.h, its tables are built once
+   before main() and are read-only afterwards (see gf.c) */
+extern const int gf_extension_degree, gf_cardinality, gf_multiplicative_order;
+extern const gfindex_t * const gf_log;
+extern const gfelt_t * const gf_exp;
 
 typedef gfelt_t gf_t[1];
 
@@ -2,6 +2,7 @@
 #define GOPPA_H
 #define GOPPA_NO_PRECOMP
 
+#include "api.h"
 #include "gf.h"
 #include "poly.h"
 #include "permutation.h"
@@ -35,6 +36,51 @@ typedef struct goppa {
 #endif
 } * goppa_t;
 
+/* a secret key loaded once for goppa_decode_ctx(), for the parameters
+   of api.h: the precomputed data of goppa_decode_init() in fixed-size
+   arrays. It holds no pointers, so it can be copied, kept in an expanded
+   secret key, and shared by threads (decoding only reads it). */
+
+// number of longs of a binary syndrome
+#define GOPPA_SYND_LONGS BITS_TO_LONG(CODIMENSION)
+
+typedef struct goppa_dec {
+    /* syndromes of the last CODIMENSION support elements, only if
+       has_parity, else goppa_decode_ctx() computes them from L */
+    unsigned long parity[CODIMENSION][GOPPA_SYND_LONGS];
+    gfelt_t L[LENGTH];
+    gfelt_t g[NB_ERRORS + 1];
+    /* sqrtmod[i] = z^(i+1/2) mod g(z) */
+    gfelt_t sqrtmod[NB_ERRORS / 2][NB_ERRORS];
+    gfindex_t Linv[1 << EXT_DEGREE];
+    int has_parity;
+} goppa_dec_t;
+
+/* scratch of roots_berl_ws(), for a locator of degree <= NB_ERRORS */
+typedef struct roots_ws {
+    gfindex_t F[EXT_DEGREE];
+    int level_flag[EXT_DEGREE];
+    struct polynome tr[EXT_DEGREE], tr_aux[EXT_DEGREE];
+    struct polynome aux1[EXT_DEGREE], aux2[EXT_DEGREE], aux3[EXT_DEGREE];
+    struct polynome sq_poly[NB_ERRORS];
+    poly_t sq_aux[NB_ERRORS];
+    gfelt_t tr_c[EXT_DEGREE][NB_ERRORS], tr_aux_c[EXT_DEGREE][NB_ERRORS];
+    gfelt_t aux1_c[EXT_DEGREE][NB_ERRORS + 1], aux2_c[EXT_DEGREE][NB_ERRORS + 1];
+    gfelt_t aux3_c[EXT_DEGREE][NB_ERRORS];
+    gfelt_t sq_aux_c[NB_ERRORS][NB_ERRORS + 2];
+} roots_ws_t;
+
+/* scratch of goppa_decode_ctx(), one per thread */
+typedef struct goppa_ws {
+    unsigned long synd[GOPPA_SYND_LONGS];
+    struct polynome R, S, sigma, r0, r1, u0, u1;
+    gfelt_t R_c[NB_ERRORS + 1], S_c[NB_ERRORS], sigma_c[NB_ERRORS + 1];
+    gfelt_t r0_c[NB_ERRORS + 1], r1_c[NB_ERRORS + 1];
+    gfelt_t u0_c[NB_ERRORS + 1], u1_c[NB_ERRORS + 1];
+    gfelt_t roots[NB_ERRORS];
+    roots_ws_t rws;
+} goppa_ws_t;
+
 // goppa.c
 #define coeff(M, i, j) (M[i][(j) / __WORDSIZE] >> ((j) % __WORDSIZE) & 1)
 #define addrowto(M, i, l) xor_long(M[l], M[i], rwdcnt)
@@ -53,10 +99,15 @@ goppa_t goppa_keygen_rand(int n, int l, int m, int t, unsigned char ** pk);
 // decode.c
 void xor_long(unsigned long * a, unsigned long * b, int n);
 int goppa_decode(const unsigned char * s, int * e, goppa_t gamma);
+void goppa_dec_init(goppa_dec_t * dec, const gfelt_t * L, const gfelt_t * g,
+                    const gfelt_t * sqrtzmod, int parity);
+int goppa_decode_ctx(const unsigned char * s, int * e,
+                     const goppa_dec_t * dec, goppa_ws_t * ws);
 
 // roots.c
 void roots_init();
 void roots_clear();
 int roots_berl(poly_t sigma, gfelt_t * res);
+int roots_berl_ws(poly_t sigma, gfelt_t * res, roots_ws_t * ws);
 
 #endif // GOPPA_H
@@ -8,9 +8,6 @@ void FIPS202_SHA3_256(const unsigned char *input, unsigned int inputByteLen, uns
 
 
 
-static unsigned char * buff = NULL;
-static int buff_size = 0;
-
 void swap_m2e(int * permutation, int a, int b) {
     int tmp = permutation[a];
     permutation[a] = permutation[b];
@@ -18,31 +15,29 @@ void swap_m2e(int * permutation, int a, int b) {
 }
 
 
-void init_hash(IN unsigned char *m) {
-    buff_size = HASH_SIZE;
-    buff = realloc(buff, buff_size*sizeof(unsigned char));
-    FIPS202_SHA3_256(m, RANDOM_BYTES, buff);
+void init_hash(m2e_hash_t * h, IN unsigned char *m) {
+    h->buff_size = HASH_SIZE;
+    FIPS202_SHA3_256(m, RANDOM_BYTES, h->buff);
 }
 
 /*
-
+   Take s bytes from the hash chain h into out.
  */
-unsigned char * hash_trunc(int s) {
+void hash_trunc(m2e_hash_t * h, unsigned char * out, int s) {
     
-	unsigned char* aux = malloc(HASH_SIZE*sizeof(unsigned char));
-	buff_size -= s;
+	unsigned char aux[HASH_SIZE];
+	h->buff_size -= s;
     
-	if (buff_size < 0) {
-		memcpy(aux, buff, HASH_SIZE);
-		init_hash(aux);
-		buff_size -= s;
+	if (h->buff_size < 0) {
+		memcpy(aux, h->buff, HASH_SIZE);
+		init_hash(h, aux);
+		h->buff_size -= s;
 
-	
-		return realloc(aux, s*sizeof(unsigned char));
+		memcpy(out, aux, s*sizeof(unsigned char));
+		return;
 	}
     
-	memcpy(aux, buff + buff_size - 1, s*sizeof(unsigned char));
-	return aux;
+	memcpy(out, h->buff + h->buff_size - 1, s*sizeof(unsigned char));
 }
 
 
@@ -60,18 +55,16 @@ static int ucharToInt(unsigned char * c, int s) {
 
 /*
  */
-int uniform_m2e(int s, int module) {
+int uniform_m2e(m2e_hash_t * h, int s, int module) {
 	int res;
-	unsigned char * aux;
+	unsigned char aux[sizeof (int)];
 	while(1) {
-		aux = hash_trunc(s);
+		hash_trunc(h, aux, s);
 		res = ucharToInt(aux, s);
         
 		if (res > ((1 << (s*8)) - ((1 << (s*8)) % module))) {
-	    free(aux);
 			continue;
 		}
-		free(aux);
 		return res % module;
 	}
 }
@@ -82,33 +75,31 @@ int m2error(IN unsigned char *m, OUT int * error) {
     
     int i, j, s = 3; //$Elise : À modifier???
     int permutation[LENGTH];
-    unsigned char * aux = malloc(HASH_SIZE*sizeof(unsigned char));
+    unsigned char aux[HASH_SIZE];
+    m2e_hash_t h;
     
     for (i = 0; i < LENGTH; ++i) {
         permutation[i] = i;
     }
     
-    init_hash(m);
+    init_hash(&h, m);
     /*
     for (int i = 0; i<buff_size; i++)
 	    printf("%u", buff[i]);
     */
     for(i = 0; i < NB_ERRORS; i++) {
-        j = uniform_m2e(s, LENGTH - i-1);
+        j = uniform_m2e(&h, s, LENGTH - i-1);
         //printf("j = %d\n", j);
         swap_m2e(permutation, i, i + j);
         //printf("permutation[%d] = %d\n", i, permutation[i]);
         
-        memcpy(aux, buff, HASH_SIZE);
-        init_hash(aux);   
+        memcpy(aux, h.buff, HASH_SIZE);
+        init_hash(&h, aux);   
     }
     for (i = 0; i < NB_ERRORS; ++i) {
         error[i] = permutation[i];
     }
     
-    free(aux);
-    //free(buff);
-    
     return SUCCESS;
 }
 
@@ -25,6 +25,14 @@ poly_t poly_alloc_from_string(int d, const unsigned char * s) {
   return p;
 }
 
+// p uses the d + 1 coefficients at coeff, which are not cleared
+poly_t poly_init(poly_t p, gfelt_t * coeff, int d) {
+  p->deg = -1;
+  p->size = d + 1;
+  p->coeff = coeff;
+  return p;
+}
+
 poly_t poly_copy(poly_t p) {
   poly_t q;
 
@@ -29,6 +29,10 @@
 // sizes of keys  and ciphertexts
 #define SECRETKEY_BYTES ((LENGTH + 1 + 2 * NB_ERRORS) * sizeof (gfelt_t))
 #define PUBLICKEY_BYTES (BITS_TO_BYTES(CODIMENSION) * ((DIMENSION) / (ORDER)))
+// upper bound on sizeof (goppa_dec_t), a loaded secret key (goppa.h)
+#define DECODER_BYTES (CODIMENSION * BITS_TO_LONG(CODIMENSION) * sizeof (long) + \
+    (LENGTH + NB_ERRORS + 1 + (NB_ERRORS / 2) * NB_ERRORS + (1 << EXT_DEGREE) + 2) * \
+    sizeof (gfelt_t))
 #define CIPHERTEXT_LENGTH (2*(8*HASH_SIZE) + SYNDROME_LENGTH)
 #define CIPHERTEXT_BYTES BITS_TO_BYTES(CIPHERTEXT_LENGTH)
 
@@ -2,4 +2,4 @@
 
 $CC $CFLAGS -DXBENCH_REPS=1 -o $XKEM_BIN -I. \
 	-I../../nist \
-	-DXBENCH_REPS=1 ../../nist/rng.c $XKEM_SRC *.c -lcrypto
+	-DXBENCH_REPS=1 ../../nist/rng.c ../../nist/keccakx.c ../../nist/kem_cache.c $XKEM_SRC *.c -lcrypto
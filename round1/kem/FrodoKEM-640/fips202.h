@@ -14,6 +14,7 @@ void shake128(unsigned char *output, unsigned long long outlen, const unsigned c
 void cshake128_simple_absorb(uint64_t *s, uint16_t cstm, const unsigned char *in, unsigned long long inlen);
 void cshake128_simple_squeezeblocks(unsigned char *output, unsigned long long nblocks, uint64_t *s);
 void cshake128_simple(unsigned char *output, unsigned long long outlen, uint16_t cstm, const unsigned char *in, unsigned long long inlen);
+void cshake128_simple4x(unsigned char *out0, unsigned char *out1, unsigned char *out2, unsigned char *out3, unsigned long long outlen, uint16_t cstm, const unsigned char *in, unsigned long long inlen);
 
 void shake256_absorb(uint64_t *s, const unsigned char *input, unsigned int inputByteLen);
 void shake256_squeezeblocks(unsigned char *output, unsigned long long nblocks, uint64_t *s);
@@ -0,0 +1,38 @@
+/********************************************************************************************
+* FrodoKEM: Learning with Errors Key Encapsulation
+*
+* Abstract: AES-NI matrix generation and AVX2 generate-and-multiply kernels
+*********************************************************************************************/
+
+#ifndef _FRODO_AVX2_H_
+#define _FRODO_AVX2_H_
+
+#include <stdint.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(FRODO_MUL_REF)
+    #define FRODO_AVX2
+#endif
+
+// Rows of A generated and multiplied at a time. A stripe and s (N x 8) stay in L1.
+#define FRODO_STRIPE_ROWS 8
+
+#ifdef FRODO_AVX2
+
+// Nonzero if the CPU has AVX2 and AES-NI
+int frodo_avx2_init(void);
+
+// Rows i0 .. i0+nrows-1 of A (N x N) from an AES128_load_schedule() schedule, row r at a + r*n.
+// nrows*n must be a multiple of 64.
+void frodo_gen_rows_aesni(uint16_t *a, const uint8_t *schedule, int i0, int nrows, int n);
+
+// out[r*8 + k] += <a + r*n, s + k*n> for r < nrows, k < 8; n a multiple of 16
+void frodo_mul_as_avx2(uint16_t *out, const uint16_t *a, const uint16_t *s, int nrows, int n);
+
+// out[k*n + c] += sum_r s[k*n + j0 + r] * a[r*n + c] for r < nrows, k < 8; n a multiple of 16
+void frodo_mul_sa_avx2(uint16_t *out, const uint16_t *a, const uint16_t *s, int j0, int nrows, int n);
+
+#else
+    #define frodo_avx2_init() 0
+#endif
+
+#endif
@@ -17,9 +17,24 @@
 #define CRYPTO_ALGNAME "FrodoKEM-976"           
 
 
+// Expanded keys for kem_expand.h: the generator of A (seed_A and its AES key schedule, 192 bytes),
+// B unpacked (2*PARAMS_N*PARAMS_NBAR) and pk; S unpacked and s. -DFRODO_EXPAND_A adds all of A.
+#ifdef FRODO_EXPAND_A
+#define CRYPTO_EXPANDEDABYTES 1905152     // 2*PARAMS_N*PARAMS_N
+#else
+#define CRYPTO_EXPANDEDABYTES       0
+#endif
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES (192 + 15616 + CRYPTO_PUBLICKEYBYTES + CRYPTO_EXPANDEDABYTES)
+#define CRYPTO_EXPANDEDSKBYTES (CRYPTO_EXPANDEDPKBYTES + 15616 + CRYPTO_BYTES)
+
 int crypto_kem_keypair(unsigned char *pk, unsigned char *sk);
 int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk);
 int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk);
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk);
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk);
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk);
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk);
 
 
 #endif
@@ -6,4 +6,4 @@ $CC $CFLAGS -o $XKEM_BIN \
 	-DUSING_OPENSSL=_USE_OPENSSL_\
 	-DUSE_GENERATION_A=_AES128_FOR_A_\
 	-I. -I../../nist \
-	../../nist/rng.c $XKEM_SRC *.c -lcrypto
+	../../nist/rng.c ../../nist/keccakx.c ../../nist/kem_cache.c $XKEM_SRC *.c -lcrypto
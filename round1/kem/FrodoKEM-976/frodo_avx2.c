@@ -0,0 +1,119 @@
+/********************************************************************************************
+* FrodoKEM: Learning with Errors Key Encapsulation
+*
+* Abstract: AES-NI matrix generation and AVX2 generate-and-multiply kernels
+*********************************************************************************************/
+
+#include "frodo_avx2.h"
+
+#ifdef FRODO_AVX2
+#include <immintrin.h>
+
+#define FRODO_TARGET __attribute__ ((target("avx2,aes")))
+
+static int frodo_avx2_ready = 0;    // 1: AVX2 and AES-NI, -1: not; set before main()
+
+
+__attribute__ ((constructor)) static void frodo_avx2_setup(void)
+{
+    __builtin_cpu_init();
+    frodo_avx2_ready = (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("aes")) ? 1 : -1;
+}
+
+
+int frodo_avx2_init(void)
+{
+    return frodo_avx2_ready > 0;
+}
+
+
+FRODO_TARGET void frodo_gen_rows_aesni(uint16_t *a, const uint8_t *schedule, int i0, int nrows, int n)
+{ // A[i][j..j+7] = AES128(seed_A, i || j || 0), as in frodo_macrify.c.inc. Eight blocks are in flight.
+    __m128i rk[11], b[8];
+    int i, k, r, nblk = nrows*n/8;
+    uint32_t row = i0, col = 0;
+
+    for (r = 0; r < 11; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i*)(schedule + 16*r));
+    }
+
+    for (i = 0; i < nblk; i += 8) {
+        for (k = 0; k < 8; k++) {
+            b[k] = _mm_xor_si128(_mm_cvtsi32_si128((int)(row | (col << 16))), rk[0]);
+            col += 8;
+            if (col == (uint32_t)n) {
+                col = 0;
+                row++;
+            }
+        }
+        for (r = 1; r < 10; r++) {
+            for (k = 0; k < 8; k++) {
+                b[k] = _mm_aesenc_si128(b[k], rk[r]);
+            }
+        }
+        for (k = 0; k < 8; k++) {
+            _mm_storeu_si128((__m128i*)(a + 8*(i + k)), _mm_aesenclast_si128(b[k], rk[10]));
+        }
+    }
+}
+
+
+FRODO_TARGET void frodo_mul_as_avx2(uint16_t *out, const uint16_t *a, const uint16_t *s, int nrows, int n)
+{ // Eight dot products per row, one accumulator per column of s; hadd leaves the 8 sums in order
+    __m256i c[8], x, h[4];
+    __m128i t;
+    int r, j, k;
+
+    for (r = 0; r < nrows; r++) {
+        for (k = 0; k < 8; k++) {
+            c[k] = _mm256_setzero_si256();
+        }
+        for (j = 0; j < n; j += 16) {
+            x = _mm256_loadu_si256((const __m256i*)(a + r*n + j));
+            for (k = 0; k < 8; k++) {
+                c[k] = _mm256_add_epi16(c[k], _mm256_mullo_epi16(x, _mm256_loadu_si256((const __m256i*)(s + k*n + j))));
+            }
+        }
+        for (k = 0; k < 4; k++) {
+            h[k] = _mm256_hadd_epi16(c[2*k], c[2*k+1]);
+        }
+        h[0] = _mm256_hadd_epi16(h[0], h[1]);
+        h[2] = _mm256_hadd_epi16(h[2], h[3]);
+        h[0] = _mm256_hadd_epi16(h[0], h[2]);
+        t = _mm_add_epi16(_mm256_castsi256_si128(h[0]), _mm256_extracti128_si256(h[0], 1));
+        t = _mm_add_epi16(t, _mm_loadu_si128((const __m128i*)(out + 8*r)));
+        _mm_storeu_si128((__m128i*)(out + 8*r), t);
+    }
+}
+
+
+FRODO_TARGET void frodo_mul_sa_avx2(uint16_t *out, const uint16_t *a, const uint16_t *s, int j0, int nrows, int n)
+{ // Row r of the stripe scaled by s[k][j0 + r] is added to row k of out, 16 columns at a time
+    __m256i c[8], x, sb[FRODO_STRIPE_ROWS*8];
+    int r, j, k, m, rr;
+
+    for (m = 0; m < nrows; m += FRODO_STRIPE_ROWS) {
+        rr = (nrows - m < FRODO_STRIPE_ROWS) ? nrows - m : FRODO_STRIPE_ROWS;
+        for (r = 0; r < rr; r++) {
+            for (k = 0; k < 8; k++) {
+                sb[8*r + k] = _mm256_set1_epi16((short)s[k*n + j0 + m + r]);
+            }
+        }
+        for (j = 0; j < n; j += 16) {
+            for (k = 0; k < 8; k++) {
+                c[k] = _mm256_loadu_si256((const __m256i*)(out + k*n + j));
+            }
+            for (r = 0; r < rr; r++) {
+                x = _mm256_loadu_si256((const __m256i*)(a + (m + r)*n + j));
+                for (k = 0; k < 8; k++) {
+                    c[k] = _mm256_add_epi16(c[k], _mm256_mullo_epi16(x, sb[8*r + k]));
+                }
+            }
+            for (k = 0; k < 8; k++) {
+                _mm256_storeu_si256((__m256i*)(out + k*n + j), c[k]);
+            }
+        }
+    }
+}
+
+#endif
@@ -17,8 +17,21 @@ void frodo_unpack(uint16_t *out, const size_t outlen, const unsigned char *in, c
 void frodo_sample_n(uint16_t *s, const size_t n, const uint8_t *seed, const size_t s_seed, const uint16_t ctr);
 void clear_words(void* mem, unsigned int nwords);
 
+// What generates A from seed_A, set up once per seed_A (a public key) and reusable across calls
+typedef struct {
+    uint8_t seed_A[16];                         // BYTES_SEED_A
+    uint8_t aes_key_schedule[16*11];            // AES128_load_schedule(seed_A); unused with OpenSSL or cSHAKE
+} frodo_a_t;
+
+void frodo_a_init(frodo_a_t *ctx, const uint8_t *seed_A);
+void frodo_a_expand(uint16_t *A, const frodo_a_t *ctx);
+
 int frodo_mul_add_as_plus_e(uint16_t *b, const uint16_t *s, const uint16_t *e, const uint8_t *seed_A);
 int frodo_mul_add_sa_plus_e(uint16_t *b, const uint16_t *s, const uint16_t *e, const uint8_t *seed_A);
+int frodo_mul_add_as_plus_e_a(uint16_t *b, const uint16_t *s, const uint16_t *e, const frodo_a_t *ctx, const uint16_t *A);
+int frodo_mul_add_sa_plus_e_a(uint16_t *b, const uint16_t *s, const uint16_t *e, const frodo_a_t *ctx, const uint16_t *A);
+int frodo_mul_add_as_plus_e_ref(uint16_t *b, const uint16_t *s, const uint16_t *e, const uint8_t *seed_A);
+int frodo_mul_add_sa_plus_e_ref(uint16_t *b, const uint16_t *s, const uint16_t *e, const uint8_t *seed_A);
 void frodo_mul_add_sb_plus_e(uint16_t *out, const uint16_t *b, const uint16_t *s, const uint16_t *e);
 void frodo_mul_bs(uint16_t *out, const uint16_t *b, const uint16_t *s);
 
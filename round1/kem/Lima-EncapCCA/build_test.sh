@@ -1,6 +1,6 @@
 #!/bin/bash
 
-gcc -g -o $XKEM_BIN -I. \
+$CC -g -o $XKEM_BIN -I. \
 	-I../../../KeccakCodePackage/bin/generic64 \
 	-I../../nist \
 	../../nist/rng.c $XKEM_SRC *.c \
@@ -222,6 +222,16 @@ extern void GF_print_log(int m);
 #define GF_regmul(x,y,m) ((x)?GF_mulx(x,y,m):0)
 //#define GF_mul(x,y,m) ((GFMULTAB)?GF_tablemul(x,y,m):GF_regmul(x,y,m))
 
+/* GaloisField_avx2.c: VPSHUFB nibble-table products for m <= 12, selected *
+ * at run time if the CPU has AVX2. -DRLCE_GF_REF: table-only reference.  */
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(RLCE_GF_REF)
+#define RLCE_GF_AVX2
+int GF_avx2_init(void); /* nonzero if the CPU has AVX2 */
+void GF_mulvec_avx2(field_t x, const field_t vec[], field_t dest[], int dsize, unsigned int m);
+void GF_vecmat_avx2(const field_t V[], int vsize, field_t **B, field_t dest[], int dsize, unsigned int m);
+#define GF_avx2(m) ((m) <= 12 && GF_avx2_init())
+#endif
+
 void printArray(unsigned char toBeprint[], int len);
 
 
@@ -0,0 +1,124 @@
+/* GaloisField_avx2.c
+ *
+ * AVX2 scalar-times-vector and vector-times-matrix products over
+ * GF(2^m), m <= 12, for GF_mulvec() and matrix_vec_mat_mul_standard().
+ *
+ * Multiplication by a fixed x is linear over GF(2), so x*v is the XOR of
+ * x*(nibble j of v << 4j) over the three nibbles of v. Each of those is
+ * looked up with VPSHUFB in a 16-entry table, one table for the low byte
+ * and one for the high byte of the product. 32 elements are done at a
+ * time: their low and high bytes are packed into separate registers,
+ * looked up, and interleaved back into 16-bit words. The results are
+ * those of GFmulTable[m][x][v] for every v < 2^m.
+ *
+ * Compile with -DRLCE_GF_REF for the table-only reference code.
+ */
+
+#include "rlce.h"
+
+#ifdef RLCE_GF_AVX2
+#include <immintrin.h>
+
+#define GF_AVX2_TARGET __attribute__ ((target("avx2")))
+
+extern int poly[17];
+
+static int GF_avx2_ready = 0; /* 1: AVX2, -1: none; set before main() */
+
+__attribute__ ((constructor)) static void GF_avx2_setup(void) {
+  __builtin_cpu_init();
+  GF_avx2_ready = __builtin_cpu_supports("avx2") ? 1 : -1;
+}
+
+int GF_avx2_init(void) {
+  return GF_avx2_ready > 0;
+}
+
+/* tv[2j] and tv[2j+1]: the low and high bytes of x*(n << 4j), n=0..15, in *
+ * both lanes. Entry n is the XOR of x*2^(4j+c) over the bits c of n.       */
+static inline GF_AVX2_TARGET void GF_nibble_vec(field_t x, __m256i tv[6], unsigned int m) {
+  const __m256i idx=_mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+				     0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  __m256i bit, sel[4];
+  uint8_t b[2][12];
+  int i, j, c;
+  for (i=0; i<12; i++) {
+    b[0][i]=x & 0xff;
+    b[1][i]=x >> 8;
+    x <<= 1;
+    if (x & fieldSize[m]) x ^= poly[m];
+  }
+  for (c=0; c<4; c++) {
+    bit=_mm256_set1_epi8(1 << c);
+    sel[c]=_mm256_cmpeq_epi8(_mm256_and_si256(idx, bit), bit);
+  }
+  for (j=0; j<3; j++) {
+    tv[2*j]=_mm256_setzero_si256();
+    tv[2*j+1]=_mm256_setzero_si256();
+    for (c=0; c<4; c++) {
+      tv[2*j]=_mm256_xor_si256(tv[2*j], _mm256_and_si256(sel[c], _mm256_set1_epi8(b[0][4*j+c])));
+      tv[2*j+1]=_mm256_xor_si256(tv[2*j+1], _mm256_and_si256(sel[c], _mm256_set1_epi8(b[1][4*j+c])));
+    }
+  }
+}
+
+/* dest[0..31] = x*vec[0..31], or dest[0..31] ^= x*vec[0..31] if add */
+static inline GF_AVX2_TARGET void GF_mul32_avx2(const field_t vec[], field_t dest[],
+						const __m256i tv[6], int add) {
+  const __m256i lo8=_mm256_set1_epi16(0x00ff);
+  const __m256i lo4=_mm256_set1_epi8(0x0f);
+  __m256i a, b, lo, hi, n0, n1, n2, pl, ph;
+  a=_mm256_loadu_si256((const __m256i *) vec);
+  b=_mm256_loadu_si256((const __m256i *) &vec[16]);
+  lo=_mm256_packus_epi16(_mm256_and_si256(a, lo8), _mm256_and_si256(b, lo8));
+  hi=_mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+  n0=_mm256_and_si256(lo, lo4);
+  n1=_mm256_and_si256(_mm256_srli_epi16(lo, 4), lo4);
+  n2=_mm256_and_si256(hi, lo4);
+  pl=_mm256_xor_si256(_mm256_shuffle_epi8(tv[0], n0),
+		      _mm256_xor_si256(_mm256_shuffle_epi8(tv[2], n1), _mm256_shuffle_epi8(tv[4], n2)));
+  ph=_mm256_xor_si256(_mm256_shuffle_epi8(tv[1], n0),
+		      _mm256_xor_si256(_mm256_shuffle_epi8(tv[3], n1), _mm256_shuffle_epi8(tv[5], n2)));
+  /* packus and unpack both work within 128-bit lanes, so this is the inverse of the packing */
+  a=_mm256_unpacklo_epi8(pl, ph);
+  b=_mm256_unpackhi_epi8(pl, ph);
+  if (add) {
+    a=_mm256_xor_si256(a, _mm256_loadu_si256((const __m256i *) dest));
+    b=_mm256_xor_si256(b, _mm256_loadu_si256((const __m256i *) &dest[16]));
+  }
+  _mm256_storeu_si256((__m256i *) dest, a);
+  _mm256_storeu_si256((__m256i *) &dest[16], b);
+}
+
+static inline GF_AVX2_TARGET void GF_mulrow_avx2(field_t x, const field_t vec[], field_t dest[],
+						 int dsize, unsigned int m, int add) {
+  field_t t[2][32];
+  __m256i tv[6];
+  int i, r;
+  GF_nibble_vec(x, tv, m);
+  for (i=0; i+32<=dsize; i+=32) GF_mul32_avx2(&vec[i], &dest[i], tv, add);
+  r=dsize-i;
+  if (r > 0) { /* the last r < 32 elements, zero padded */
+    memset(t, 0, sizeof(t));
+    memcpy(t[0], &vec[i], r*sizeof(field_t));
+    memcpy(t[1], &dest[i], r*sizeof(field_t));
+    GF_mul32_avx2(t[0], t[1], tv, add);
+    memcpy(&dest[i], t[1], r*sizeof(field_t));
+  }
+}
+
+GF_AVX2_TARGET void GF_mulvec_avx2(field_t x, const field_t vec[], field_t dest[],
+				   int dsize, unsigned int m) {
+  GF_mulrow_avx2(x, vec, dest, dsize, m, 0);
+}
+
+GF_AVX2_TARGET void GF_vecmat_avx2(const field_t V[], int vsize, field_t **B,
+				   field_t dest[], int dsize, unsigned int m) {
+  int i;
+  memset(dest, 0, dsize*sizeof(field_t));
+  for (i=0; i<vsize; i++) {
+    if (V[i] != 0) GF_mulrow_avx2(V[i], B[i], dest, dsize, m, 1);
+  }
+}
+
+#endif
@@ -50,6 +50,12 @@ int vector_copy(vector_t v, vector_t dest) {
 int matrix_vec_mat_mul_standard(field_t V[], int vsize, matrix_t B, field_t dest[], int dsize, unsigned int m) {
   if ((vsize>B->numR)||(B->numC<dsize)) return VECMATRIXMULERROR;
   int i;
+#ifdef RLCE_GF_AVX2
+  if (GF_avx2(m)) {
+    GF_vecmat_avx2(V, vsize, B->data, dest, dsize, m);
+    return 0;
+  }
+#endif
   field_t *X;
   X=calloc(dsize, sizeof(field_t));
   memset(dest, 0, dsize*sizeof(field_t));
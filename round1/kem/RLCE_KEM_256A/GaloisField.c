@@ -191,6 +191,12 @@ void GF_mulvec(field_t x, field_t vec[], field_t dest[],int dsize, unsigned int
   /* multiply each element in a range of memory by x  */
   int i;
   if (dest==NULL) dest=vec;
+#ifdef RLCE_GF_AVX2
+  if (GF_avx2(m)) {
+    GF_mulvec_avx2(x, vec, dest, dsize, m);
+    return;
+  }
+#endif
   if (GFMULTAB==1) {
     GF_init_mult_table(m);
     for (i=0; i<dsize; i++) dest[i]=GFmulTable[m][x][vec[i]];
@@ -392,17 +398,26 @@ void GF_evalpoly(int log, poly_t p, field_t input[], field_t output[], int size,
     for (i=0; i<size; i++) inpute[i]=GFlogTable[m][input[i]];
   }
   field_t *row=calloc(size, sizeof(field_t));
+  /* step[j]=inpute[j] mod fieldOrder, ilog[j]=i*inpute[j] mod fieldOrder */
+  field_t *step=calloc(size, sizeof(field_t));
+  field_t *ilog=calloc(size, sizeof(field_t));
   field_t tmp;
   for (j=0; j<size; j++) output[j]=p->coeff[0];
+  for (j=0; j<size; j++) step[j]=inpute[j] % fieldOrder[m];
   for (i=1; i<1+p->deg; i++) {
+    for (j=0; j<size; j++) {
+      ilog[j] += step[j];
+      if (ilog[j] >= fieldOrder[m]) ilog[j] -= fieldOrder[m];
+    }
     if (p->coeff[i] !=0) {      
       tmp=GFlogTable[m][p->coeff[i]];
-      for (j=0; j<size; j++)
-	row[j]=GFexpTable[m][(tmp+i*inpute[j]) % fieldOrder[m]];
+      for (j=0; j<size; j++) row[j]=GFexpTable[m][tmp+ilog[j]];
       GF_addvec(row, output,NULL,size);
     }
   }
   free(row);
+  free(step);
+  free(ilog);
   if (log==0) free(inpute);
   return;
 }
@@ -3,6 +3,16 @@
 #include <math.h>
 #include "gf.h"
 
+static gf_t gf_log_sf_tab[gf_card_sf];
+static gf_t gf_antilog_sf_tab[gf_card_sf];
+static gf gf_log_tab[gf_card];
+static gf gf_antilog_tab[2 * gf_ord];
+
+const gf_t *const gf_log_sf = gf_log_sf_tab;
+const gf_t *const gf_antilog_sf = gf_antilog_sf_tab;
+const gf *const gf_log = gf_log_tab;
+const gf *const gf_antilog = gf_antilog_tab;
+
 /*
  ~~~~~~~~ARITHMETIC FIELD ELEMENT CONSTRUCTION ~~~~~~~~~~~~~~~~
  We define arithmetic field in  F[2][x]/(f), where f is an m-irreducible polynomial.
@@ -20,18 +30,17 @@ static void gf_init_antilog_sf()
     */
     int i = 1;
     int temp = 1 << (gf_extd_sf - 1);
-    gf_antilog_sf = (gf_t *)malloc((gf_card_sf * sizeof(gf_t)));
-    gf_antilog_sf[0] = 1;
+    gf_antilog_sf_tab[0] = 1;
     for (i = 1; i < gf_ord_sf; ++i)
     {
-        gf_antilog_sf[i] = gf_antilog_sf[i - 1] << 1;
-        if ((gf_antilog_sf[i - 1]) & temp)
+        gf_antilog_sf_tab[i] = gf_antilog_sf_tab[i - 1] << 1;
+        if ((gf_antilog_sf_tab[i - 1]) & temp)
         {
             // XOR with 67: X^6 + x + 1
-            gf_antilog_sf[i] ^= poly_primitive_subfield;
+            gf_antilog_sf_tab[i] ^= poly_primitive_subfield;
         }
     }
-    gf_antilog_sf[gf_ord_sf] = 1;
+    gf_antilog_sf_tab[gf_ord_sf] = 1;
 }
 
 static void gf_init_log_sf()
@@ -42,12 +51,11 @@ static void gf_init_log_sf()
     In memory access is faster than calculating.
     */
     int i = 1;
-    gf_log_sf = (gf_t *)malloc((gf_card_sf * sizeof(gf_t)));
-    gf_log_sf[0] = -1;
-    gf_log_sf[1] = 0;
+    gf_log_sf_tab[0] = -1;
+    gf_log_sf_tab[1] = 0;
     for (i = 1; i < gf_ord_sf; ++i)
     {
-        gf_log_sf[gf_antilog_sf[i]] = i;
+        gf_log_sf_tab[gf_antilog_sf[i]] = i;
     }
 }
 
@@ -59,14 +67,13 @@ static void gf_init_antilog()
     In memory access is faster than calculating.
     */
     int i = 1;
-    gf_antilog = (gf *)malloc(gf_card * sizeof(gf));
     gf p = 1;
-    gf_antilog[0] = 1;
-    // gf_card = 4096
-    for (i = 1; i < gf_card; i++)
+    gf_antilog_tab[0] = 1;
+    // 64 is primitive, so this is two periods of 4095
+    for (i = 1; i < 2 * gf_ord; i++)
     {
         p = gf_mult(p, 64);
-        gf_antilog[i] = p;
+        gf_antilog_tab[i] = p;
     }
 }
 
@@ -78,12 +85,11 @@ static void gf_init_log()
     In memory access is faster than calculating.
     */
     int i = 1;
-    gf_log = (gf *)malloc((gf_card * sizeof(gf)));
-    gf_log[0] = -1;
-    gf_log[1] = 0;
+    gf_log_tab[0] = -1;
+    gf_log_tab[1] = 0;
     for (i = 1; i < gf_ord; ++i)
     {
-        gf_log[gf_antilog[i]] = i;
+        gf_log_tab[gf_antilog[i]] = i;
     }
 }
 
@@ -193,7 +199,14 @@ gf gf_inv(gf in)
     return gf_sq(out);
 }
 
-int init_done = 0;
+// The tables are read-only after this runs, so threads can share them
+__attribute__((constructor)) static void gf_init_tables(void)
+{
+    gf_init_antilog_sf();
+    gf_init_log_sf();
+    gf_init_antilog();
+    gf_init_log();
+}
 
 int gf_init(int extdeg)
 {
@@ -203,22 +216,6 @@ int gf_init(int extdeg)
         exit(0);
     }
 
-    if (init_done != extdeg)
-    {
-        if (init_done)
-        {
-            free(gf_antilog_sf);
-            free(gf_log_sf);
-            free(gf_antilog);
-            free(gf_log);
-        }
-        init_done = extdeg;
-        gf_init_antilog_sf();
-        gf_init_log_sf();
-        gf_init_antilog();
-        gf_init_log();
-    }
-
     return 1;
 }
 
@@ -30,11 +30,14 @@ typedef uint16_t gf_t;
 #define poly_primitive_subfield 67
 
 //int gf_extension_degree, gf_cardinality, gf_multiplicative_order;
-gf_t *gf_log_sf;
-gf_t *gf_antilog_sf;
+// Log and antilog tables, built once when the program is loaded (gf.c).
+// gf_antilog has 2 * gf_ord entries, so the sum of two logs needs no
+// reduction.
+extern const gf_t *const gf_log_sf;
+extern const gf_t *const gf_antilog_sf;
 
-gf *gf_log;
-gf *gf_antilog;
+extern const gf *const gf_log;
+extern const gf *const gf_antilog;
 
 #define gf_unit() 1
 #define gf_zero() 0
@@ -113,7 +116,7 @@ gf gf_Pow1(gf f, int n);
 // Propose gf_Ppw
 gf gf_pow(gf f, int n);
 
-// Un-nessary use antilog and log table
+// Only checks extdeg; the tables are built at load time
 int gf_init(int extdeg);
 
 #endif
@@ -43,8 +43,20 @@ unsigned char *random_e(int size, int q, int w, unsigned char *sigma)
 {
 	unsigned char *e = (unsigned char *)calloc(size, sizeof(unsigned char));
 	unsigned int *v = (unsigned int *)calloc(size, sizeof(unsigned int));
+
+	random_e_ws(size, q, w, sigma, e, v);
+	free(v);
+	return e;
+}
+
+//random_e into e, with v as scratch; both have size entries
+void random_e_ws(int size, int q, int w, const unsigned char *sigma,
+				 unsigned char *e, unsigned int *v)
+{
 	int i, j = 0, k = 0, jeton = 0;
 
+	memset(e, 0, size * sizeof(unsigned char));
+	memset(v, 0, size * sizeof(unsigned int));
 	for (i = 0; i < size; i++)
 	{
 		if (sigma[i] % q == 0)
@@ -65,8 +77,6 @@ unsigned char *random_e(int size, int q, int w, unsigned char *sigma)
 		jeton = 0;
 		j++;
 	}
-	free(v);
-	return e;
 }
 
 //TODO Gustavo can this be simpler like the function for store_sk
@@ -14,6 +14,9 @@ int indice_in_vec(unsigned int *v, int j, int size);
 
 unsigned char *random_e(int size, int q, int w, unsigned char *sigma);
 
+void random_e_ws(int size, int q, int w, const unsigned char *sigma,
+                 unsigned char *e, unsigned int *v);
+
 void recup_pk(const unsigned char *pk, binmat_t G);
 
 void store_pk(binmat_t M, unsigned char *pk);
@@ -14,6 +14,13 @@
 
 #define CRYPTO_ALGNAME "DAGS_5"
 
+// Expanded keys for kem_expand.h: pk as it is; sk loaded into a decoder
+// (dags_dec_t, see decoding.h) of 2 * code_length * (st_len + 3) + gf_card
+// bytes
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES CRYPTO_PUBLICKEYBYTES
+#define CRYPTO_EXPANDEDSKBYTES (2 * 2112 * (64 * 11 + 3) + 4096)
+
 int crypto_kem_keypair(
     unsigned char *pk,
     unsigned char *sk);
@@ -28,4 +35,22 @@ int crypto_kem_dec(
     const unsigned char *ct,
     const unsigned char *sk);
 
+int crypto_kem_expand_pk(
+    unsigned char *epk,
+    const unsigned char *pk);
+
+int crypto_kem_enc_expanded(
+    unsigned char *ct,
+    unsigned char *ss,
+    const unsigned char *epk);
+
+int crypto_kem_expand_sk(
+    unsigned char *esk,
+    const unsigned char *sk);
+
+int crypto_kem_dec_expanded(
+    unsigned char *ss,
+    const unsigned char *ct,
+    const unsigned char *esk);
+
 #endif
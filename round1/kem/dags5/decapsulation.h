@@ -20,3 +20,13 @@
  */
 int decapsulation(unsigned char *ss, const unsigned char *ct,
                   const unsigned char *sk);
+
+/**
+ * @brief decapsulation() with a decoder built by dags_dec_init(). Allocates
+ * nothing and only reads dec, so threads can share it.
+ * @param ss secret shared
+ * @param ct
+ * @param dec decoder of the secret key
+ */
+int decapsulation_ctx(unsigned char *ss, const unsigned char *ct,
+                      const dags_dec_t *dec);
@@ -5,6 +5,7 @@
  **********************************************************************************************
  */
 #include "decoding.h"
+#include "api.h"
 
 //Bulding of decoding fuction
 
@@ -282,3 +283,289 @@ int decoding_H(binmat_t H_alt, const unsigned char *c, unsigned char *error,
 
     return 1;
 }
+
+/*
+ * DECODER FROM AN EXPANDED SECRET KEY: decoding_H() with H_alt read once.
+ * Field products go through the log tables of gf.c, which give the same
+ * values as gf_mult(), and the only buffers are those of dags_ws_t.
+ */
+
+_Static_assert(sizeof(dags_dec_t) == CRYPTO_EXPANDEDSKBYTES,
+               "CRYPTO_EXPANDEDSKBYTES in api.h");
+_Static_assert(code_length % 8 == 0, "roots are searched 8 at a time");
+
+static inline gf gf_mul_log(gf x, gf y)
+{
+    return (x && y) ? gf_antilog[gf_log[x] + gf_log[y]] : 0;
+}
+
+static inline gf gf_inv_log(gf x)
+{
+    return x ? gf_antilog[gf_ord - gf_log[x]] : 0;
+}
+
+// y[l] = p(x_l) for l < 8 and p of degree d, given lx[l] = gf_log[x_l] of
+// nonzero x_l. The eight Horner steps are independent, so their table
+// lookups overlap.
+static void poly_eval8_log(gf y[8], const gf *p, int d, const int lx[8])
+{
+    int l;
+
+    for (l = 0; l < 8; l++)
+    {
+        y[l] = 0;
+    }
+    for (; d >= 0; d--)
+    {
+        for (l = 0; l < 8; l++)
+        {
+            y[l] = (y[l] ? gf_antilog[gf_log[y[l]] + lx[l]] : 0) ^ p[d];
+        }
+    }
+}
+
+// acc ^= col, both of st_len entries
+static void syn_xor(gf *restrict acc, const gf *restrict col)
+{
+    int j;
+
+    for (j = 0; j < st_len; j++)
+    {
+        acc[j] ^= col[j];
+    }
+}
+
+// Degree of p, whose coefficients above d are zero
+static int poly_deg_below(const gf *p, int d)
+{
+    while ((d >= 0) && (p[d] == 0))
+    {
+        d--;
+    }
+    return d;
+}
+
+int dags_dec_init(dags_dec_t *dec, const unsigned char *sk)
+{
+    unsigned int rown, coln;
+    int i, j, log12[gf_card];
+    gf x, alpha;
+    const unsigned char *p;
+
+    memcpy(&rown, sk, sizeof(rown));
+    memcpy(&coln, sk + sizeof(rown), sizeof(coln));
+    if (rown != st_len || coln != code_length)
+    {
+        return -1;
+    }
+
+    // H_alt is stored by rows (store_sk)
+    p = sk + sizeof(rown) + sizeof(coln);
+    for (j = 0; j < st_len; j++)
+    {
+        for (i = 0; i < code_length; i++)
+        {
+            memcpy(&x, p, sizeof(gf));
+            p += sizeof(gf);
+            if (x >= gf_card)
+            {
+                return -1;
+            }
+            dec->h[i][j] = x;
+        }
+    }
+
+    for (i = 0; i < code_length; i++)
+    {
+        dec->y[i] = dec->h[i][0];
+        dec->ver[i] = gf_mul_log(dec->h[i][1], gf_inv_log(dec->h[i][0]));
+        dec->ver_inv[i] = gf_inv_log(dec->ver[i]);
+    }
+
+    // The LOG_12 lookup of decoding_H(), for every value
+    memset(log12, 0, sizeof(log12));
+    x = 1;
+    log12[0] = -1;
+    log12[1] = 0;
+    for (i = 1; i < gf_card; i++)
+    {
+        x = gf_mult(x, 64);
+        log12[x] = i;
+    }
+    alpha = gf_pow(64, 65);
+    for (i = 0; i < gf_card; i++)
+    {
+        dec->err_val[i] = (unsigned char)(gf_Pow_subfield(2, log12[i] / log12[alpha]));
+    }
+
+    return 0;
+}
+
+int decoding_H_ctx(const dags_dec_t *dec, const unsigned char *c,
+                   unsigned char *error, unsigned char *code_word,
+                   dags_ws_t *ws)
+{
+    int i, j, k, b, l, n, d0, dr, du0, du1, s, z, lx[8];
+    gf a, q, x, pol_gf, f, y[8], *r0, *r1, *u0, *u1, *t;
+
+    // Syndrome. gf_mult() is bilinear, so H_alt * c is the sum over the
+    // bits b of the XOR of the columns i with bit b of c[i] set, times 2^b.
+    memset(ws->acc, 0, sizeof(ws->acc));
+    for (i = 0; i < code_length; i++)
+    {
+        for (b = 0; b < 8; b++)
+        {
+            if ((c[i] >> b) & 1)
+            {
+                syn_xor(ws->acc[b], dec->h[i]);
+            }
+        }
+    }
+    r0 = ws->r0;
+    r1 = ws->r1;
+    u0 = ws->u0;
+    u1 = ws->u1;
+    for (j = 0; j < st_len; j++)
+    {
+        x = 0;
+        for (b = 0; b < 8; b++)
+        {
+            x ^= gf_mul_log(ws->acc[b][j], 1 << b);
+        }
+        r1[j] = x;
+    }
+    r1[st_len] = 0;
+    dr = poly_deg_below(r1, st_len - 1);
+    if (dr == -1)
+    {
+        return -1;
+    }
+
+    // Key equation: Euclid on x^st_len and the syndrome, with the quotient
+    // folded into r0 and u0 term by term
+    memset(r0, 0, (st_len + 1) * sizeof(gf));
+    memset(u0, 0, (st_len + 1) * sizeof(gf));
+    memset(u1, 0, (st_len + 1) * sizeof(gf));
+    r0[st_len] = 1;
+    d0 = st_len;
+    u1[0] = 1;
+    du0 = -1;
+    du1 = 0;
+    while (dr >= (st_len / 2))
+    {
+        a = gf_inv_log(r1[dr]);
+        for (k = d0 - dr; k >= 0; k--)
+        {
+            q = gf_mul_log(a, r0[dr + k]);
+            if (q != 0)
+            {
+                for (j = 0; j <= dr; j++)
+                {
+                    r0[j + k] ^= gf_mul_log(q, r1[j]);
+                }
+                for (j = 0; j <= du1; j++)
+                {
+                    u0[j + k] ^= gf_mul_log(q, u1[j]);
+                }
+            }
+        }
+        du0 = poly_deg_below(u0, du1 + d0 - dr > du0 ? du1 + d0 - dr : du0);
+        d0 = dr;
+        dr = poly_deg_below(r0, dr - 1);
+
+        t = r0;
+        r0 = r1;
+        r1 = t;
+        t = u0;
+        u0 = u1;
+        u1 = t;
+        k = du0;
+        du0 = du1;
+        du1 = k;
+    }
+
+    // Error locator sigma = u / u(0); the evaluator is r1 / u(0)
+    a = gf_inv_log(u1[0]);
+    if (a == 0)
+    {
+        return -1;
+    }
+    for (j = 0; j <= dr; j++)
+    {
+        r1[j] = gf_mul_log(r1[j], a);
+    }
+    for (j = 0; j <= du1; j++)
+    {
+        ws->sigma[j] = gf_mul_log(u1[j], a);
+    }
+
+    // Positions of the errors: sigma at 8 points at a time, so that the
+    // table lookups of their Horner steps overlap
+    n = 0;
+    for (i = 0; i < code_length; i += 8)
+    {
+        for (l = 0; l < 8; l++)
+        {
+            lx[l] = dec->ver[i + l] ? gf_log[dec->ver_inv[i + l]] : 0;
+        }
+        poly_eval8_log(y, ws->sigma, du1, lx);
+        for (l = 0; l < 8; l++)
+        {
+            if ((dec->ver[i + l] != 0) && (y[l] == 0))
+            {
+                if (n > st_len / 2)
+                {
+                    return -1;
+                }
+                ws->lv[n] = gf_log[dec->ver[i + l]];
+                ws->pos[n++] = i + l;
+            }
+        }
+    }
+    // decoding_H() keeps positions in a polynomial, so a lone error at 0
+    // counts as none
+    if ((n == 0) || ((n == 1) && (ws->pos[0] == 0)))
+    {
+        return -1;
+    }
+
+    // Values of the errors, 8 at a time for the evaluator. The product over
+    // the other positions is a sum of logs, z noting a zero factor.
+    for (k = 0; k < n; k += 8)
+    {
+        for (l = 0; l < 8; l++)
+        {
+            lx[l] = (k + l < n) ? gf_log[dec->ver_inv[ws->pos[k + l]]] : 0;
+        }
+        poly_eval8_log(y, r1, dr, lx);
+        for (l = 0; (l < 8) && (k + l < n); l++)
+        {
+            j = k + l;
+            s = 0;
+            z = 0;
+            for (i = 0; i < n; i++)
+            {
+                if (i != j)
+                {
+                    f = 1 ^ gf_antilog[ws->lv[i] + lx[l]];
+                    z |= (f == 0);
+                    s += gf_log[f];
+                }
+            }
+            pol_gf = z ? 0 : gf_antilog[s % gf_ord];
+            ws->val[j] = gf_mul_log(y[l], gf_inv_log(gf_mul_log(dec->y[ws->pos[j]], pol_gf)));
+        }
+    }
+    for (i = poly_deg_below(ws->val, n - 1); i >= 0; i--)
+    {
+        error[ws->pos[i]] = dec->err_val[ws->val[i]];
+    }
+
+    //Reconstruction of code_word
+    for (i = 0; i < code_length; i++)
+    {
+        code_word[i] = (c[i] ^ error[i]) & gf_ord_sf;
+    }
+
+    return 1;
+}
@@ -1,3 +1,6 @@
+#ifndef DECODING_H
+#define DECODING_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -35,3 +38,57 @@ binmat_t alternant_matrix(binmat_t H, gf *u);
  * @return -1 if it is not possible to compute and 1 if it is possible to compute
  */
 int decoding_H(binmat_t H_alt, const unsigned char *c, unsigned char *e, unsigned char *mot);
+
+// Rows of H_alt, the length of the syndrome
+#define st_len (order * pol_deg)
+
+/**
+ * @brief Alternant decoder derived once from the secret key. It is only
+ * read by decoding_H_ctx(), so threads can share one.
+ */
+typedef struct
+{
+    gf h[code_length][st_len];      // H_alt by columns
+    gf y[code_length];              // row 0 of H_alt
+    gf ver[code_length];            // support: row 1 / row 0
+    gf ver_inv[code_length];        // gf_inv(ver[i])
+    unsigned char err_val[gf_card]; // error value for each app coefficient
+} dags_dec_t;
+
+/**
+ * @brief Scratch for decoding_H_ctx()
+ */
+typedef struct
+{
+    gf acc[8][st_len]; // XOR of the columns with bit b of c set
+    gf r0[st_len + 1], r1[st_len + 1];
+    gf u0[st_len + 1], u1[st_len + 1];
+    gf sigma[st_len + 1];
+    gf pos[st_len / 2 + 1], val[st_len / 2 + 1];
+    gf lv[st_len / 2 + 1]; // gf_log[ver[pos[i]]]
+} dags_ws_t;
+
+/**
+ * @brief function to build the decoder from a secret key of store_sk()
+ * @param dec decoder
+ * @param sk secret key
+ *
+ * @return 0, or -1 if sk does not hold an st_len x code_length H_alt
+ */
+int dags_dec_init(dags_dec_t *dec, const unsigned char *sk);
+
+/**
+ * @brief decoding_H() with a decoder of dags_dec_init(). Allocates
+ * nothing; e must be zero on entry.
+ * @param dec decoder
+ * @param c code word
+ * @param e
+ * @param mot short IV
+ * @param ws scratch
+ *
+ * @return -1 if it is not possible to compute and 1 if it is possible to compute
+ */
+int decoding_H_ctx(const dags_dec_t *dec, const unsigned char *c,
+                   unsigned char *e, unsigned char *mot, dags_ws_t *ws);
+
+#endif
@@ -29,3 +29,30 @@ int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned ch
 
 	return decapsulation(ss, ct, sk);
 }
+
+// Expanded public key: pk itself
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+
+	memcpy(epk, pk, CRYPTO_PUBLICKEYBYTES);
+	return 0;
+}
+
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk)
+{
+
+	return encapsulation(epk, ct, ss);
+}
+
+// Expanded secret key: the decoder of dags_dec_init()
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
+{
+
+	return dags_dec_init((dags_dec_t *)esk, sk);
+}
+
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk)
+{
+
+	return decapsulation_ctx(ss, ct, (const dags_dec_t *)esk);
+}
@@ -24,22 +24,43 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
   return(0);	
 }
 
-int crypto_kem_enc(unsigned char *c, unsigned char *k, const unsigned char *pk)
+// Expanded public key: everything crypto_kem_enc needs from pk
+
+typedef struct {
+  indcpa_kem_epk ipk;
+  unsigned char hpk[32];                                // Hash(public key)
+} kem_epk;
+
+_Static_assert(sizeof(kem_epk) == CRYPTO_EXPANDEDPKBYTES, "CRYPTO_EXPANDEDPKBYTES");
+
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+  kem_epk *e = (kem_epk *) epk;
+
+  indcpa_kem_expand_pk(&e->ipk, pk);
+  sha3_256(e->hpk, pk, SABER_INDCPA_PUBLICKEYBYTES);
+  return(0);
+}
+
+int crypto_kem_enc_expanded(unsigned char *c, unsigned char *k, const unsigned char *epk)
 {
+  const kem_epk *e = (const kem_epk *) epk;
   unsigned char kr[64];                             	  // Will contain key, coins
   unsigned char buf[64];                          
+  int i;
 
   randombytes(buf, 32);
 
 	sha3_256(buf,buf,32);            			  // BUF[0:31] <-- random message (will be used as the key for client) Note: hash doesnot release system RNG output
 
-  sha3_256(buf+32, pk, SABER_INDCPA_PUBLICKEYBYTES);    // BUF[32:63] <-- Hash(public key);  Multitarget countermeasure for coins + contributory KEM 
+  for(i=0;i<32;i++)                                     // BUF[32:63] <-- Hash(public key);  Multitarget countermeasure for coins + contributory KEM 
+    buf[32+i] = e->hpk[i];
 
   sha3_512(kr, buf, 64);				// kr[0:63] <-- Hash(buf[0:63]);  	
 							  								// K^ <-- kr[0:31]
 							  								// noiseseed (r) <-- kr[32:63];	
 
-  indcpa_kem_enc(buf, kr+32, pk,  c);	// buf[0:31] contains message; kr[32:63] contains randomness r;  		
+  indcpa_kem_enc_expanded(buf, kr+32, &e->ipk,  c);	// buf[0:31] contains message; kr[32:63] contains randomness r;  		
 
   sha3_256(kr+32, c, SABER_BYTES_CCA_DEC);              
 
@@ -47,34 +68,74 @@ int crypto_kem_enc(unsigned char *c, unsigned char *k, const unsigned char *pk)
   return(0);	
 }
 
+int crypto_kem_enc(unsigned char *c, unsigned char *k, const unsigned char *pk)
+{
+  kem_epk epk;
 
-int crypto_kem_dec(unsigned char *k, const unsigned char *c, const unsigned char *sk)
+  crypto_kem_expand_pk((unsigned char *) &epk, pk);
+  return crypto_kem_enc_expanded(c, k, (unsigned char *) &epk);
+}
+
+
+// Expanded secret key: s, the expanded pk for re-encryption, and z
+
+typedef struct {
+  indcpa_kem_esk isk;
+  kem_epk epk;
+  unsigned char z[SABER_KEYBYTES];                  // output when check in crypto_kem_dec() fails
+} kem_esk;
+
+_Static_assert(sizeof(kem_esk) == CRYPTO_EXPANDEDSKBYTES, "CRYPTO_EXPANDEDSKBYTES");
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
 {
+  int i;
+  kem_esk *e = (kem_esk *) esk;
+
+  indcpa_kem_expand_sk(&e->isk, sk);
+  indcpa_kem_expand_pk(&e->epk.ipk, sk + SABER_INDCPA_SECRETKEYBYTES);
+  for(i=0;i<32;i++)                                  // h(pk) and z are stored in sk
+    e->epk.hpk[i] = sk[SABER_SECRETKEYBYTES-64+i];
+  for(i=0;i<SABER_KEYBYTES;i++)
+    e->z[i] = sk[SABER_SECRETKEYBYTES-SABER_KEYBYTES+i];
+  return(0);
+}
+
+int crypto_kem_dec_expanded(unsigned char *k, const unsigned char *c, const unsigned char *esk)
+{
+  const kem_esk *e = (const kem_esk *) esk;
   int i, fail;
   unsigned char cmp[SABER_BYTES_CCA_DEC];
   unsigned char buf[64];
   unsigned char kr[64];                             // Will contain key, coins
-  const unsigned char *pk = sk + SABER_INDCPA_SECRETKEYBYTES;
 
-   indcpa_kem_dec(sk, c, buf);			     // buf[0:31] <-- message
+   indcpa_kem_dec_expanded(&e->isk, c, buf);	     // buf[0:31] <-- message
 
  
   // Multitarget countermeasure for coins + contributory KEM 
-  for(i=0;i<32;i++)                                  // Save hash by storing h(pk) in sk 
-    buf[32+i] = sk[SABER_SECRETKEYBYTES-64+i]; 
+  for(i=0;i<32;i++)
+    buf[32+i] = e->epk.hpk[i]; 
 
   sha3_512(kr, buf, 64);
 
-  indcpa_kem_enc(buf, kr+32, pk, cmp);
+  indcpa_kem_enc_expanded(buf, kr+32, &e->epk.ipk, cmp);
 
 
   fail = verify(c, cmp, SABER_BYTES_CCA_DEC);
 
   sha3_256(kr+32, c, SABER_BYTES_CCA_DEC);        		     // overwrite coins in kr with h(c)  
 
-  cmov(kr, sk+SABER_SECRETKEYBYTES-SABER_KEYBYTES, SABER_KEYBYTES, fail); 
+  cmov(kr, e->z, SABER_KEYBYTES, fail); 
 
   sha3_256(k, kr, 64);                          	   	     // hash concatenation of pre-k and h(c) to k
 
   return(0);	
 }
+
+int crypto_kem_dec(unsigned char *k, const unsigned char *c, const unsigned char *sk)
+{
+  kem_esk esk;
+
+  crypto_kem_expand_sk((unsigned char *) &esk, sk);
+  return crypto_kem_dec_expanded(k, c, (unsigned char *) &esk);
+}
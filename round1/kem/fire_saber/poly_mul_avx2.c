@@ -0,0 +1,234 @@
+#include <stdint.h>
+#include "poly_mul_avx2.h"
+
+#ifdef SABER_MUL_AVX2
+#include <immintrin.h>
+
+// The evaluation points and interpolation of toom_cook_4way() in
+// poly_mul.c.inc, 16 coefficients at a time, with two Karatsuba levels
+// below them. The 63 products of 16 x 16 coefficients are done 16 at a
+// time, one per lane, so the schoolbook needs no shuffles. Arithmetic is
+// mod 2^16 and the interpolation divides by up to 8, so results are exact
+// mod 2^13 = SABER_Q. Everything is linear in the products, so sums of
+// products are interpolated only once.
+
+#define TOOM4_TARGET __attribute__ ((target("avx2")))
+
+static int toom4_avx2_ready = 0;	// 1: AVX2, -1: none; set before main()
+
+__attribute__ ((constructor)) static void toom4_avx2_setup(void)
+{
+	__builtin_cpu_init();
+	toom4_avx2_ready = __builtin_cpu_supports("avx2") ? 1 : -1;
+}
+
+int toom4_avx2_init(void)
+{
+	return toom4_avx2_ready > 0;
+}
+
+// in-place transpose of a 16 x 16 matrix of 16-bit words
+static inline TOOM4_TARGET void transpose16(__m256i r[16])
+{
+	__m256i a[16], b[16];
+	int k, m;
+
+	for(k=0;k<8;k++){
+		a[2*k] = _mm256_unpacklo_epi16(r[2*k], r[2*k+1]);
+		a[2*k+1] = _mm256_unpackhi_epi16(r[2*k], r[2*k+1]);
+	}
+	for(k=0;k<4;k++){
+		b[4*k] = _mm256_unpacklo_epi32(a[4*k], a[4*k+2]);
+		b[4*k+1] = _mm256_unpackhi_epi32(a[4*k], a[4*k+2]);
+		b[4*k+2] = _mm256_unpacklo_epi32(a[4*k+1], a[4*k+3]);
+		b[4*k+3] = _mm256_unpackhi_epi32(a[4*k+1], a[4*k+3]);
+	}
+	for(k=0;k<2;k++){
+		for(m=0;m<4;m++){
+			a[8*k+2*m] = _mm256_unpacklo_epi64(b[8*k+m], b[8*k+4+m]);
+			a[8*k+2*m+1] = _mm256_unpackhi_epi64(b[8*k+m], b[8*k+4+m]);
+		}
+	}
+	for(m=0;m<8;m++){
+		r[m] = _mm256_permute2x128_si256(a[m], a[8+m], 0x20);
+		r[m+8] = _mm256_permute2x128_si256(a[m], a[8+m], 0x31);
+	}
+}
+
+TOOM4_TARGET void toom4_eval_avx2(toom4_eval_t *e, const uint16_t *a)
+{
+	__m256i x[16], p[7][4], s[64];
+	__m256i th, t_h, e02, e13, m0, m1;
+	int i, k, t;
+
+	for(i=0;i<16;i++)
+		x[i] = _mm256_loadu_si256((const __m256i *) &a[16*i]);
+
+	// Toom-4: x = x0 + x1*y + x2*y^2 + x3*y^3, y = x^64, at
+	// inf, 2, 1, -1, 1/2 (times 8), -1/2 (times 8) and 0
+	for(k=0;k<4;k++){
+		th = _mm256_slli_epi16(_mm256_add_epi16(_mm256_slli_epi16(x[k], 2), x[8+k]), 1);	// 8*x0+2*x2
+		t_h = _mm256_add_epi16(_mm256_slli_epi16(x[4+k], 2), x[12+k]);	// 4*x1+x3
+		e02 = _mm256_add_epi16(x[k], x[8+k]);
+		e13 = _mm256_add_epi16(x[4+k], x[12+k]);
+
+		p[0][k] = x[12+k];
+		p[1][k] = _mm256_add_epi16(_mm256_slli_epi16(x[12+k], 1), x[8+k]);
+		p[1][k] = _mm256_add_epi16(_mm256_slli_epi16(p[1][k], 1), x[4+k]);
+		p[1][k] = _mm256_add_epi16(_mm256_slli_epi16(p[1][k], 1), x[k]);
+		p[2][k] = _mm256_add_epi16(e02, e13);
+		p[3][k] = _mm256_sub_epi16(e02, e13);
+		p[4][k] = _mm256_add_epi16(th, t_h);
+		p[5][k] = _mm256_sub_epi16(th, t_h);
+		p[6][k] = x[k];
+	}
+
+	// Karatsuba 64 -> 3 x 32 -> 9 x 16: piece 9*t + 3*u + v, with u, v
+	// the low half, high half, or their sum
+	for(t=0;t<7;t++){
+		s[9*t+0] = p[t][0];
+		s[9*t+1] = p[t][1];
+		s[9*t+2] = _mm256_add_epi16(p[t][0], p[t][1]);
+		s[9*t+3] = p[t][2];
+		s[9*t+4] = p[t][3];
+		s[9*t+5] = _mm256_add_epi16(p[t][2], p[t][3]);
+		m0 = _mm256_add_epi16(p[t][0], p[t][2]);
+		m1 = _mm256_add_epi16(p[t][1], p[t][3]);
+		s[9*t+6] = m0;
+		s[9*t+7] = m1;
+		s[9*t+8] = _mm256_add_epi16(m0, m1);
+	}
+	s[63] = _mm256_setzero_si256();
+
+	for(k=0;k<4;k++){
+		transpose16(&s[16*k]);
+		for(i=0;i<16;i++)
+			_mm256_store_si256((__m256i *) e->v[k][i], s[16*k+i]);
+	}
+}
+
+TOOM4_TARGET void toom4_mac_avx2(toom4_acc_t *acc, const toom4_eval_t *a, const toom4_eval_t *b)
+{
+	__m256i x, y[16], c[31];
+	int i, j, k;
+
+	for(k=0;k<4;k++){
+		for(i=0;i<16;i++)
+			y[i] = _mm256_load_si256((const __m256i *) b->v[k][i]);
+		for(i=0;i<31;i++)
+			c[i] = _mm256_load_si256((const __m256i *) acc->v[k][i]);
+		for(i=0;i<16;i++){
+			x = _mm256_load_si256((const __m256i *) a->v[k][i]);
+			for(j=0;j<16;j++)
+				c[i+j] = _mm256_add_epi16(c[i+j], _mm256_mullo_epi16(x, y[j]));
+		}
+		for(i=0;i<31;i++)
+			_mm256_store_si256((__m256i *) acc->v[k][i], c[i]);
+	}
+}
+
+TOOM4_TARGET void toom4_interp_avx2(uint16_t *res, const toom4_acc_t *acc, uint16_t mod)
+{
+	__m256i s[2][64], m[3][4], d[4], w[7][8], r[32];
+	__m256i w1, w2, w3, w4, w5, w6, w7, temp;
+	const __m256i inv3 = _mm256_set1_epi16((int16_t) 43691);
+	const __m256i inv9 = _mm256_set1_epi16((int16_t) 36409);
+	const __m256i inv15 = _mm256_set1_epi16((int16_t) 61167);
+	const __m256i int45 = _mm256_set1_epi16(45);
+	const __m256i int30 = _mm256_set1_epi16(30);
+	int i, k, t, u;
+
+	// back to one piece per vector: coefficients 0..15 in s[0], 16..30 in s[1]
+	for(k=0;k<4;k++){
+		for(i=0;i<16;i++)
+			s[0][16*k+i] = _mm256_load_si256((const __m256i *) acc->v[k][i]);
+		for(i=0;i<15;i++)
+			s[1][16*k+i] = _mm256_load_si256((const __m256i *) acc->v[k][16+i]);
+		s[1][16*k+15] = _mm256_setzero_si256();
+		transpose16(&s[0][16*k]);
+		transpose16(&s[1][16*k]);
+	}
+
+	// Karatsuba 9 x 31 -> 3 x 63 -> 127 coefficients per Toom-4 point
+	for(t=0;t<7;t++){
+		for(u=0;u<3;u++){
+			i = 9*t + 3*u;
+			d[0] = _mm256_sub_epi16(_mm256_sub_epi16(s[0][i+2], s[0][i]), s[0][i+1]);
+			d[1] = _mm256_sub_epi16(_mm256_sub_epi16(s[1][i+2], s[1][i]), s[1][i+1]);
+			m[u][0] = s[0][i];
+			m[u][1] = _mm256_add_epi16(s[1][i], d[0]);
+			m[u][2] = _mm256_add_epi16(s[0][i+1], d[1]);
+			m[u][3] = s[1][i+1];
+		}
+		for(i=0;i<4;i++)
+			d[i] = _mm256_sub_epi16(_mm256_sub_epi16(m[2][i], m[0][i]), m[1][i]);
+		w[t][0] = m[0][0];
+		w[t][1] = m[0][1];
+		w[t][2] = _mm256_add_epi16(m[0][2], d[0]);
+		w[t][3] = _mm256_add_epi16(m[0][3], d[1]);
+		w[t][4] = _mm256_add_epi16(m[1][0], d[2]);
+		w[t][5] = _mm256_add_epi16(m[1][1], d[3]);
+		w[t][6] = m[1][2];
+		w[t][7] = m[1][3];
+	}
+
+	// Toom-4 interpolation, with the names of toom_cook_4way()
+	for(i=0;i<8;i++){
+		w1 = w[0][i];
+		w2 = w[1][i];
+		w3 = w[2][i];
+		w4 = w[3][i];
+		w5 = w[4][i];
+		w6 = w[5][i];
+		w7 = w[6][i];
+
+		w2 = _mm256_add_epi16(w2, w5);
+		w6 = _mm256_sub_epi16(w6, w5);
+		w4 = _mm256_sub_epi16(w4, w3);
+		w5 = _mm256_sub_epi16(w5, w1);
+		w5 = _mm256_sub_epi16(w5, _mm256_slli_epi16(w7, 6));
+		w4 = _mm256_srai_epi16(w4, 1);
+		w3 = _mm256_add_epi16(w3, w4);
+		w5 = _mm256_add_epi16(w6, _mm256_slli_epi16(w5, 1));
+		temp = _mm256_add_epi16(w3, _mm256_slli_epi16(w3, 6));
+		w2 = _mm256_sub_epi16(w2, temp);
+		w3 = _mm256_sub_epi16(w3, w7);
+		w3 = _mm256_sub_epi16(w3, w1);
+		w2 = _mm256_add_epi16(w2, _mm256_mullo_epi16(w3, int45));
+		w5 = _mm256_sub_epi16(w5, _mm256_slli_epi16(w3, 3));
+		w5 = _mm256_srai_epi16(_mm256_mullo_epi16(w5, inv3), 3);
+		w6 = _mm256_add_epi16(w2, w6);
+		w2 = _mm256_add_epi16(w2, _mm256_slli_epi16(w4, 4));
+		w2 = _mm256_srai_epi16(_mm256_mullo_epi16(w2, inv9), 1);
+		w3 = _mm256_sub_epi16(w3, w5);
+		w4 = _mm256_add_epi16(w4, w2);
+		w4 = _mm256_sub_epi16(_mm256_setzero_si256(), w4);
+		w6 = _mm256_sub_epi16(_mm256_mullo_epi16(w2, int30), w6);
+		w6 = _mm256_srai_epi16(_mm256_mullo_epi16(w6, inv15), 2);
+		w2 = _mm256_sub_epi16(w2, w6);
+
+		w[0][i] = w1;
+		w[1][i] = w2;
+		w[2][i] = w3;
+		w[3][i] = w4;
+		w[4][i] = w5;
+		w[5][i] = w6;
+		w[6][i] = w7;
+	}
+
+	// w7 + w6*y + .. + w1*y^6, then mod x^SABER_N + 1
+	for(i=0;i<32;i++)
+		r[i] = _mm256_setzero_si256();
+	for(t=0;t<7;t++)
+		for(i=0;i<8;i++)
+			r[4*t+i] = _mm256_add_epi16(r[4*t+i], w[6-t][i]);
+
+	for(i=0;i<16;i++){
+		temp = _mm256_sub_epi16(r[i], r[16+i]);
+		temp = _mm256_add_epi16(temp, _mm256_loadu_si256((const __m256i *) &res[16*i]));
+		temp = _mm256_and_si256(temp, _mm256_set1_epi16(mod));
+		_mm256_storeu_si256((__m256i *) &res[16*i], temp);
+	}
+}
+
+#endif
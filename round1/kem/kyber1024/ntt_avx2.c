@@ -0,0 +1,310 @@
+#include <stdint.h>
+#include "params.h"
+#include "ntt.h"
+#include "polyvec.h"
+
+#ifdef NTT_AVX2
+#include <immintrin.h>
+
+/* The scalar code keeps unsigned coefficients with Montgomery factor 2^18.
+   Here sixteen coefficients are held as signed 16-bit lanes and multiplied
+   with Montgomery factor 2^16: mm_montmul(a, w) = a * w / 2^16 mod q, in
+   (-q, q) for any a and a twiddle w in [-q/2, q/2]. Sums are left
+   unreduced for up to three levels before a Barrett reduction to [0, q],
+   and all outputs are frozen to [0, q). Inputs may be any 16-bit value. */
+
+#define NTT_TARGET __attribute__ ((target("avx2")))
+
+#define NTT_QINV -7679          /* q^-1 mod 2^16 */
+#define NTT_V 8737              /* round(2^26 / q) */
+
+/* Twiddles from the scalar tables, divided by 4 and centered, each with
+   its product by q^-1 mod 2^16 for the low half of the Montgomery step.
+   Forward levels 7..4 and inverse levels 4..7 use one twiddle per pair of
+   rows (broadcast); levels 3..0 run on the transposed block and use one
+   twiddle per lane, 2^(3-l) vectors for level l. */
+static int16_t ntt_fwd_bw[16], ntt_fwd_bwq[16];
+static int16_t ntt_inv_bw[8], ntt_inv_bwq[8];
+static int16_t ntt_fwd_vw[15][16] __attribute__ ((aligned (32)));
+static int16_t ntt_fwd_vwq[15][16] __attribute__ ((aligned (32)));
+static int16_t ntt_inv_vw[15][16] __attribute__ ((aligned (32)));
+static int16_t ntt_inv_vwq[15][16] __attribute__ ((aligned (32)));
+static int16_t ntt_psi_w[KYBER_N] __attribute__ ((aligned (32)));
+static int16_t ntt_psi_wq[KYBER_N] __attribute__ ((aligned (32)));
+static int16_t ntt_c32, ntt_c32q;       /* 2^32 mod q, for pointwise */
+static int ntt_avx2_ready = 0;          /* 1: tables set, -1: no AVX2; set before main() */
+
+extern const uint16_t omegas_inv_bitrev_montgomery[];
+extern const uint16_t psis_inv_montgomery[];
+extern const uint16_t zetas[];
+
+/* w = x mod q, centered, and wq = w * q^-1 mod 2^16 */
+static void ntt_twiddle(int16_t *w, int16_t *wq, uint32_t x)
+{
+  int32_t c = x % KYBER_Q;
+
+  if(c > KYBER_Q / 2)
+    c -= KYBER_Q;
+  *w = (int16_t) c;
+  *wq = (int16_t) (uint16_t) ((uint32_t) c * (uint32_t) NTT_QINV);
+}
+
+/* Twiddle with Montgomery factor 2^18 to factor 2^16 */
+static void ntt_twiddle18(int16_t *w, int16_t *wq, uint16_t x)
+{
+  ntt_twiddle(w, wq, (uint32_t) x * (KYBER_Q - (KYBER_Q - 1) / 4));
+}
+
+/* Checks for AVX2 and builds the tables once, before main() */
+__attribute__ ((constructor)) static void ntt_avx2_setup(void)
+{
+  int i, l, m, v, r;
+
+  __builtin_cpu_init();
+  if(!__builtin_cpu_supports("avx2"))
+    ntt_avx2_ready = -1;
+  else
+  {
+    for(i = 1; i < 16; i++)
+      ntt_twiddle18(&ntt_fwd_bw[i], &ntt_fwd_bwq[i], zetas[i]);
+    for(i = 0; i < 8; i++)
+      ntt_twiddle18(&ntt_inv_bw[i], &ntt_inv_bwq[i], omegas_inv_bitrev_montgomery[i]);
+    for(l = 0; l < 4; l++)
+    {
+      for(m = 0; m < (1 << (3-l)); m++)
+      {
+        v = (1 << (3-l)) - 1 + m;
+        for(r = 0; r < 16; r++)
+        {
+          ntt_twiddle18(&ntt_fwd_vw[v][r], &ntt_fwd_vwq[v][r],
+            zetas[(1 << (7-l)) + (r << (3-l)) + m]);
+          ntt_twiddle18(&ntt_inv_vw[v][r], &ntt_inv_vwq[v][r],
+            omegas_inv_bitrev_montgomery[(r << (3-l)) + m]);
+        }
+      }
+    }
+    for(i = 0; i < KYBER_N; i++)
+      ntt_twiddle18(&ntt_psi_w[i], &ntt_psi_wq[i], psis_inv_montgomery[i]);
+    ntt_twiddle(&ntt_c32, &ntt_c32q, (uint32_t) ((1ULL << 32) % KYBER_Q));
+    ntt_avx2_ready = 1;
+  }
+}
+
+/* Nonzero if AVX2 is usable and the tables are set */
+int ntt_avx2_init(void)
+{
+  return ntt_avx2_ready > 0;
+}
+
+/* a * w / 2^16 mod q, in (-q, q) */
+static inline NTT_TARGET __m256i mm_montmul(__m256i a, __m256i w, __m256i wq)
+{
+  __m256i t;
+
+  t = _mm256_mullo_epi16(a, wq);
+  t = _mm256_mulhi_epi16(t, _mm256_set1_epi16(KYBER_Q));
+  return _mm256_sub_epi16(_mm256_mulhi_epi16(a, w), t);
+}
+
+/* a mod q in [0, q] */
+static inline NTT_TARGET __m256i mm_barrett(__m256i a)
+{
+  __m256i t;
+
+  t = _mm256_mulhi_epi16(a, _mm256_set1_epi16(NTT_V));
+  t = _mm256_srai_epi16(t, 10);
+  t = _mm256_mullo_epi16(t, _mm256_set1_epi16(KYBER_Q));
+  return _mm256_sub_epi16(a, t);
+}
+
+/* a mod q in [-1, q] for unsigned a */
+static inline NTT_TARGET __m256i mm_barrett_u(__m256i a)
+{
+  __m256i t;
+
+  t = _mm256_mulhi_epu16(a, _mm256_set1_epi16(NTT_V));
+  t = _mm256_srli_epi16(t, 10);
+  t = _mm256_mullo_epi16(t, _mm256_set1_epi16(KYBER_Q));
+  return _mm256_sub_epi16(a, t);
+}
+
+/* a mod q in [0, q) */
+static inline NTT_TARGET __m256i mm_freeze(__m256i a)
+{
+  const __m256i q = _mm256_set1_epi16(KYBER_Q);
+
+  a = _mm256_sub_epi16(mm_barrett(a), q);
+  return _mm256_add_epi16(a, _mm256_and_si256(_mm256_srai_epi16(a, 15), q));
+}
+
+/* In-place transpose of a 16 x 16 matrix of 16-bit words */
+static inline NTT_TARGET void mm_transpose16(__m256i r[16])
+{
+  __m256i a[16], b[16];
+  int k, m;
+
+  for(k = 0; k < 8; k++)
+  {
+    a[2*k] = _mm256_unpacklo_epi16(r[2*k], r[2*k+1]);
+    a[2*k+1] = _mm256_unpackhi_epi16(r[2*k], r[2*k+1]);
+  }
+  for(k = 0; k < 4; k++)
+  {
+    b[4*k] = _mm256_unpacklo_epi32(a[4*k], a[4*k+2]);
+    b[4*k+1] = _mm256_unpackhi_epi32(a[4*k], a[4*k+2]);
+    b[4*k+2] = _mm256_unpacklo_epi32(a[4*k+1], a[4*k+3]);
+    b[4*k+3] = _mm256_unpackhi_epi32(a[4*k+1], a[4*k+3]);
+  }
+  for(k = 0; k < 2; k++)
+  {
+    for(m = 0; m < 4; m++)
+    {
+      a[8*k+2*m] = _mm256_unpacklo_epi64(b[8*k+m], b[8*k+4+m]);
+      a[8*k+2*m+1] = _mm256_unpackhi_epi64(b[8*k+m], b[8*k+4+m]);
+    }
+  }
+  for(m = 0; m < 8; m++)
+  {
+    r[m] = _mm256_permute2x128_si256(a[m], a[8+m], 0x20);
+    r[m+8] = _mm256_permute2x128_si256(a[m], a[8+m], 0x31);
+  }
+}
+
+/* Forward NTT as ntt_ref(), on rows of 16 coefficients */
+NTT_TARGET void ntt_avx2(uint16_t *p)
+{
+  __m256i r[16], w, wq, t;
+  int i, j, k, d, l;
+
+  for(i = 0; i < 16; i++)
+    r[i] = mm_barrett_u(_mm256_loadu_si256((const __m256i *) &p[16*i]));
+
+  /* levels 7..4: between rows */
+  k = 1;
+  for(l = 7; l >= 4; l--)
+  {
+    d = 1 << (l-4);
+    for(i = 0; i < 16; i += 2*d)
+    {
+      w = _mm256_set1_epi16(ntt_fwd_bw[k]);
+      wq = _mm256_set1_epi16(ntt_fwd_bwq[k++]);
+      for(j = i; j < i + d; j++)
+      {
+        t = mm_montmul(r[j+d], w, wq);
+        r[j+d] = _mm256_sub_epi16(r[j], t);
+        r[j] = _mm256_add_epi16(r[j], t);
+      }
+    }
+    if(l == 5)
+      for(i = 0; i < 16; i++)
+        r[i] = mm_barrett(r[i]);
+  }
+
+  /* levels 3..0: between columns */
+  mm_transpose16(r);
+  for(l = 3; l >= 0; l--)
+  {
+    d = 1 << l;
+    for(i = 0; i < 16; i += 2*d)
+    {
+      k = (1 << (3-l)) - 1 + (i >> (l+1));
+      w = _mm256_load_si256((const __m256i *) ntt_fwd_vw[k]);
+      wq = _mm256_load_si256((const __m256i *) ntt_fwd_vwq[k]);
+      for(j = i; j < i + d; j++)
+      {
+        t = mm_montmul(r[j+d], w, wq);
+        r[j+d] = _mm256_sub_epi16(r[j], t);
+        r[j] = _mm256_add_epi16(r[j], t);
+      }
+    }
+    if(l == 2)
+      for(i = 0; i < 16; i++)
+        r[i] = mm_barrett(r[i]);
+  }
+  mm_transpose16(r);
+
+  for(i = 0; i < 16; i++)
+    _mm256_storeu_si256((__m256i *) &p[16*i], mm_freeze(r[i]));
+}
+
+/* Inverse NTT as invntt_ref() */
+NTT_TARGET void invntt_avx2(uint16_t *p)
+{
+  __m256i r[16], w, wq, t;
+  int i, j, k, d, l;
+
+  for(i = 0; i < 16; i++)
+    r[i] = mm_barrett_u(_mm256_loadu_si256((const __m256i *) &p[16*i]));
+
+  /* levels 0..3: between columns */
+  mm_transpose16(r);
+  for(l = 0; l < 4; l++)
+  {
+    d = 1 << l;
+    for(i = 0; i < 16; i += 2*d)
+    {
+      k = (1 << (3-l)) - 1 + (i >> (l+1));
+      w = _mm256_load_si256((const __m256i *) ntt_inv_vw[k]);
+      wq = _mm256_load_si256((const __m256i *) ntt_inv_vwq[k]);
+      for(j = i; j < i + d; j++)
+      {
+        t = r[j];
+        r[j] = mm_barrett(_mm256_add_epi16(t, r[j+d]));
+        r[j+d] = mm_montmul(_mm256_sub_epi16(t, r[j+d]), w, wq);
+      }
+    }
+  }
+  mm_transpose16(r);
+
+  /* levels 4..7: between rows */
+  for(l = 4; l < 8; l++)
+  {
+    d = 1 << (l-4);
+    for(i = 0; i < 16; i += 2*d)
+    {
+      w = _mm256_set1_epi16(ntt_inv_bw[i >> (l-3)]);
+      wq = _mm256_set1_epi16(ntt_inv_bwq[i >> (l-3)]);
+      for(j = i; j < i + d; j++)
+      {
+        t = r[j];
+        r[j] = mm_barrett(_mm256_add_epi16(t, r[j+d]));
+        r[j+d] = mm_montmul(_mm256_sub_epi16(t, r[j+d]), w, wq);
+      }
+    }
+  }
+
+  for(i = 0; i < 16; i++)
+  {
+    w = _mm256_load_si256((const __m256i *) &ntt_psi_w[16*i]);
+    wq = _mm256_load_si256((const __m256i *) &ntt_psi_wq[16*i]);
+    t = mm_montmul(r[i], w, wq);
+    _mm256_storeu_si256((__m256i *) &p[16*i], mm_freeze(t));
+  }
+}
+
+/* As polyvec_pointwise_acc_ref(); b is first scaled by 2^16 so that the
+   second product comes out in the normal domain */
+NTT_TARGET void polyvec_pointwise_acc_avx2(poly *r, const polyvec *a, const polyvec *b)
+{
+  const __m256i c = _mm256_set1_epi16(ntt_c32);
+  const __m256i cq = _mm256_set1_epi16(ntt_c32q);
+  const __m256i qinv = _mm256_set1_epi16(NTT_QINV);
+  __m256i acc, t;
+  int i, j;
+
+  for(j = 0; j < KYBER_N; j += 16)
+  {
+    acc = _mm256_setzero_si256();
+    for(i = 0; i < KYBER_K; i++)
+    {
+      t = mm_barrett_u(_mm256_loadu_si256((const __m256i *) &b->vec[i].coeffs[j]));
+      t = mm_montmul(t, c, cq);
+      acc = _mm256_add_epi16(acc, mm_montmul(
+        mm_barrett_u(_mm256_loadu_si256((const __m256i *) &a->vec[i].coeffs[j])),
+        t, _mm256_mullo_epi16(t, qinv)));
+    }
+    _mm256_storeu_si256((__m256i *) &r->coeffs[j], mm_freeze(acc));
+  }
+}
+
+#endif
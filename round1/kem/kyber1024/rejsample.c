@@ -0,0 +1,328 @@
+#include "params.h"
+#include "rejsample.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REJ_SSSE3
+#endif
+
+/* Rejection sampling of 13-bit little-endian values < KYBER_Q from buf,
+   as in Parse() of the specification. Returns the number of coefficients
+   written to r (at most len); consumes all of buf unless r fills up. */
+static unsigned int rej_uniform_ref(uint16_t *r, unsigned int len, const unsigned char *buf, unsigned int buflen)
+{
+  unsigned int ctr = 0, pos = 0;
+  uint16_t val;
+
+  while(ctr < len && pos + 2 <= buflen)
+  {
+    val = (buf[pos] | ((uint16_t) buf[pos+1] << 8)) & 0x1fff;
+    if(val < KYBER_Q)
+      r[ctr++] = val;
+    pos += 2;
+  }
+  return ctr;
+}
+
+#ifdef REJ_SSSE3
+
+/* Byte shuffles that move the accepted 16-bit lanes of a mask to the front */
+static const uint8_t rej_idx[256][16] = {
+  {255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255},
+  { 10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  10,  11, 255, 255, 255, 255, 255, 255},
+  {  8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255},
+  {  6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11, 255, 255, 255, 255},
+  { 12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  12,  13, 255, 255, 255, 255},
+  { 10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  10,  11,  12,  13, 255, 255, 255, 255},
+  {  8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255},
+  {  6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13, 255, 255},
+  { 14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  14,  15, 255, 255, 255, 255},
+  { 10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  10,  11,  14,  15, 255, 255, 255, 255},
+  {  8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255},
+  {  6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  14,  15, 255, 255},
+  { 12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  12,  13,  14,  15, 255, 255},
+  { 10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  2,   3,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  4,   5,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   4,   5,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  4,   5,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,  10,  11,  12,  13,  14,  15, 255, 255},
+  {  8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  2,   3,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  4,   5,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  2,   3,   4,   5,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255},
+  {  6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255},
+  {  0,   1,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  2,   3,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  0,   1,   2,   3,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255},
+  {  4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255},
+  {  0,   1,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255},
+  {  2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 255, 255},
+  {  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15}
+};
+
+/* Eight candidates at a time: compare, then compact the accepted ones
+   with the shuffle for their mask. The scalar code does the tail. */
+__attribute__ ((target("ssse3,popcnt")))
+static unsigned int rej_uniform_ssse3(uint16_t *r, unsigned int len, const unsigned char *buf, unsigned int buflen)
+{
+  unsigned int ctr = 0, pos = 0, m;
+  const __m128i mask = _mm_set1_epi16(0x1fff);
+  const __m128i bound = _mm_set1_epi16(KYBER_Q);
+  __m128i v, g;
+
+  while(ctr + 8 <= len && pos + 16 <= buflen)
+  {
+    v = _mm_and_si128(_mm_loadu_si128((const __m128i *) &buf[pos]), mask);
+    g = _mm_cmplt_epi16(v, bound);
+    m = _mm_movemask_epi8(_mm_packs_epi16(g, g)) & 0xFF;
+    v = _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i *) rej_idx[m]));
+    _mm_storeu_si128((__m128i *) &r[ctr], v);
+    ctr += __builtin_popcount(m);
+    pos += 16;
+  }
+  return ctr + rej_uniform_ref(r + ctr, len - ctr, buf + pos, buflen - pos);
+}
+#endif
+
+/* Dispatch resolved once before main(); the reference code until then */
+static unsigned int (*rej_uniform_impl)(uint16_t *, unsigned int, const unsigned char *, unsigned int) = rej_uniform_ref;
+
+__attribute__ ((constructor)) static void rej_uniform_select(void)
+{
+#ifdef REJ_SSSE3
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt"))
+    rej_uniform_impl = rej_uniform_ssse3;
+#endif
+}
+
+unsigned int rej_uniform(uint16_t *r, unsigned int len, const unsigned char *buf, unsigned int buflen)
+{
+  return rej_uniform_impl(r, len, buf, buflen);
+}
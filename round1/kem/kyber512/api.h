@@ -8,6 +8,11 @@
 #define CRYPTO_CIPHERTEXTBYTES KYBER_CIPHERTEXTBYTES
 #define CRYPTO_BYTES           KYBER_SYMBYTES
 
+/* Expanded keys for kem_expand.h: A^T, t and H(pk); s, expanded pk and z */
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES ((KYBER_K+1)*KYBER_K*KYBER_N*2 + KYBER_SYMBYTES)
+#define CRYPTO_EXPANDEDSKBYTES (KYBER_K*KYBER_N*2 + CRYPTO_EXPANDEDPKBYTES + KYBER_SYMBYTES)
+
 #if   (KYBER_K == 2)
 #define CRYPTO_ALGNAME "Kyber512"
 #elif (KYBER_K == 3)
@@ -24,5 +29,13 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
 
 int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk);
 
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk);
+
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk);
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk);
+
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk);
+
 
 #endif
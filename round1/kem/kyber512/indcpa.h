@@ -1,6 +1,19 @@
 #ifndef INDCPA_H
 #define INDCPA_H
 
+#include "polyvec.h"
+
+/* Public key with the matrix expanded, for repeated encryption */
+typedef struct {
+  polyvec pkpv;           /* t, NTT domain */
+  polyvec at[KYBER_K];    /* A^T, NTT domain */
+} indcpa_epk;
+
+/* Secret key unpacked, for repeated decryption */
+typedef struct {
+  polyvec skpv;           /* s, NTT domain */
+} indcpa_esk;
+
 void indcpa_keypair(unsigned char *pk, 
                    unsigned char *sk);
 
@@ -9,8 +22,23 @@ void indcpa_enc(unsigned char *c,
                const unsigned char *pk,
                const unsigned char *coins);
 
+void indcpa_expand_pk(indcpa_epk *epk,
+                      const unsigned char *pk);
+
+void indcpa_enc_expanded(unsigned char *c,
+                        const unsigned char *m,
+                        const indcpa_epk *epk,
+                        const unsigned char *coins);
+
 void indcpa_dec(unsigned char *m,
                const unsigned char *c,
                const unsigned char *sk);
 
+void indcpa_expand_sk(indcpa_esk *esk,
+                      const unsigned char *sk);
+
+void indcpa_dec_expanded(unsigned char *m,
+                        const unsigned char *c,
+                        const indcpa_esk *esk);
+
 #endif
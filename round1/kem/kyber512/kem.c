@@ -20,49 +20,107 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
   return 0;
 }
 
-int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
+/* Expanded public key: everything crypto_kem_enc needs from pk */
+typedef struct {
+  indcpa_epk ipk;
+  unsigned char hpk[KYBER_SYMBYTES];                                          /* H(pk) */
+} kem_epk;
+
+_Static_assert(sizeof(kem_epk) == CRYPTO_EXPANDEDPKBYTES, "CRYPTO_EXPANDEDPKBYTES");
+
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+  kem_epk *e = (kem_epk *) epk;
+
+  indcpa_expand_pk(&e->ipk, pk);
+  sha3_256(e->hpk, pk, KYBER_PUBLICKEYBYTES);
+  return 0;
+}
+
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk)
 {
+  const kem_epk *e = (const kem_epk *) epk;
   unsigned char  kr[2*KYBER_SYMBYTES];                                        /* Will contain key, coins */
   unsigned char buf[2*KYBER_SYMBYTES];                          
+  size_t i;
 
   randombytes(buf, KYBER_SYMBYTES);
   sha3_256(buf,buf,KYBER_SYMBYTES);                                           /* Don't release system RNG output */
 
-  sha3_256(buf+KYBER_SYMBYTES, pk, KYBER_PUBLICKEYBYTES);                     /* Multitarget countermeasure for coins + contributory KEM */
+  for(i=0;i<KYBER_SYMBYTES;i++)                                               /* Multitarget countermeasure for coins + contributory KEM */
+    buf[KYBER_SYMBYTES+i] = e->hpk[i];
   sha3_512(kr, buf, 2*KYBER_SYMBYTES);
 
-  indcpa_enc(ct, buf, pk, kr+KYBER_SYMBYTES);                                 /* coins are in kr+KYBER_SYMBYTES */
+  indcpa_enc_expanded(ct, buf, &e->ipk, kr+KYBER_SYMBYTES);                   /* coins are in kr+KYBER_SYMBYTES */
 
   sha3_256(kr+KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);                     /* overwrite coins in kr with H(c) */
   sha3_256(ss, kr, 2*KYBER_SYMBYTES);                                         /* hash concatenation of pre-k and H(c) to k */
   return 0;
 }
 
-int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk)
+int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
 {
+  kem_epk epk;
+
+  crypto_kem_expand_pk((unsigned char *) &epk, pk);
+  return crypto_kem_enc_expanded(ct, ss, (unsigned char *) &epk);
+}
+
+/* Expanded secret key: s, the expanded pk for re-encryption, and z */
+typedef struct {
+  indcpa_esk isk;
+  kem_epk epk;
+  unsigned char z[KYBER_SYMBYTES];                                            /* pseudo-random output on reject */
+} kem_esk;
+
+_Static_assert(sizeof(kem_esk) == CRYPTO_EXPANDEDSKBYTES, "CRYPTO_EXPANDEDSKBYTES");
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
+{
+  size_t i;
+  kem_esk *e = (kem_esk *) esk;
+
+  indcpa_expand_sk(&e->isk, sk);
+  indcpa_expand_pk(&e->epk.ipk, sk+KYBER_INDCPA_SECRETKEYBYTES);
+  for(i=0;i<KYBER_SYMBYTES;i++) {                                             /* H(pk) and z are stored in sk */
+    e->epk.hpk[i] = sk[KYBER_SECRETKEYBYTES-2*KYBER_SYMBYTES+i];
+    e->z[i] = sk[KYBER_SECRETKEYBYTES-KYBER_SYMBYTES+i];
+  }
+  return 0;
+}
+
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk)
+{
+  const kem_esk *e = (const kem_esk *) esk;
   size_t i; 
   int fail;
   unsigned char cmp[KYBER_CIPHERTEXTBYTES];
   unsigned char buf[2*KYBER_SYMBYTES];
   unsigned char kr[2*KYBER_SYMBYTES];                                         /* Will contain key, coins, qrom-hash */
-  const unsigned char *pk = sk+KYBER_INDCPA_SECRETKEYBYTES;
 
-  indcpa_dec(buf, ct, sk);
+  indcpa_dec_expanded(buf, ct, &e->isk);
 
-  // shake256(buf+KYBER_SYMBYTES, KYBER_SYMBYTES, pk, KYBER_PUBLICKEYBYTES);  /* Multitarget countermeasure for coins + contributory KEM */
-  for(i=0;i<KYBER_SYMBYTES;i++)                                               /* Save hash by storing H(pk) in sk */
-    buf[KYBER_SYMBYTES+i] = sk[KYBER_SECRETKEYBYTES-2*KYBER_SYMBYTES+i];
+  for(i=0;i<KYBER_SYMBYTES;i++)                                               /* Multitarget countermeasure for coins + contributory KEM */
+    buf[KYBER_SYMBYTES+i] = e->epk.hpk[i];
   sha3_512(kr, buf, 2*KYBER_SYMBYTES);
 
-  indcpa_enc(cmp, buf, pk, kr+KYBER_SYMBYTES);                                /* coins are in kr+KYBER_SYMBYTES */
+  indcpa_enc_expanded(cmp, buf, &e->epk.ipk, kr+KYBER_SYMBYTES);             /* coins are in kr+KYBER_SYMBYTES */
 
   fail = verify(ct, cmp, KYBER_CIPHERTEXTBYTES);
 
   sha3_256(kr+KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);                     /* overwrite coins in kr with H(c)  */
 
-  cmov(kr, sk+KYBER_SECRETKEYBYTES-KYBER_SYMBYTES, KYBER_SYMBYTES, fail);     /* Overwrite pre-k with z on re-encryption failure */
+  cmov(kr, e->z, KYBER_SYMBYTES, fail);                                       /* Overwrite pre-k with z on re-encryption failure */
 
   sha3_256(ss, kr, 2*KYBER_SYMBYTES);                                         /* hash concatenation of pre-k and H(c) to k */
 
   return -fail;
 }
+
+int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk)
+{
+  kem_esk esk;
+
+  crypto_kem_expand_sk((unsigned char *) &esk, sk);
+  return crypto_kem_dec_expanded(ss, ct, (unsigned char *) &esk);
+}
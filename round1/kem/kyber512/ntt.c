@@ -8,7 +8,7 @@ extern const uint16_t psis_inv_montgomery[];
 extern const uint16_t zetas[];
 
 /* Forward NTT, normal to bitreversed order */
-void ntt(uint16_t *p) 
+void ntt_ref(uint16_t *p) 
 {
   int level, start, j, k;
   uint16_t zeta, t;
@@ -35,7 +35,7 @@ void ntt(uint16_t *p)
 }
 
 /* Inverse NTT, bitreversed to normal order */
-void invntt(uint16_t * a)
+void invntt_ref(uint16_t * a)
 {
   int start, j, jTwiddle, level;
   uint16_t temp, W;
@@ -66,3 +66,37 @@ void invntt(uint16_t * a)
   for(j = 0; j < KYBER_N; j++)
     a[j] = montgomery_reduce((a[j] * psis_inv_montgomery[j]));
 }
+
+/* AVX2 if ntt_avx2_init() found it before main() */
+void ntt(uint16_t *p)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+  {
+    ntt_avx2(p);
+    return;
+  }
+#endif
+  ntt_ref(p);
+}
+
+void invntt(uint16_t *p)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+  {
+    invntt_avx2(p);
+    return;
+  }
+#endif
+  invntt_ref(p);
+}
+
+const char *ntt_impl(void)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+    return "avx2";
+#endif
+  return "ref";
+}
@@ -3,7 +3,24 @@
 
 #include <stdint.h>
 
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(KYBER_NTT_REF)
+#define NTT_AVX2
+#endif
+
 void ntt(uint16_t* poly);
 void invntt(uint16_t* poly);
 
+/* Portable code; ntt() and invntt() use AVX2 when the CPU has it */
+void ntt_ref(uint16_t* poly);
+void invntt_ref(uint16_t* poly);
+
+/* Name of the selected implementation: "avx2" or "ref" */
+const char *ntt_impl(void);
+
+#ifdef NTT_AVX2
+int ntt_avx2_init(void);
+void ntt_avx2(uint16_t* poly);
+void invntt_avx2(uint16_t* poly);
+#endif
+
 #endif
@@ -3,6 +3,7 @@
 
 #include "params.h"
 #include "poly.h"
+#include "ntt.h"
 
 typedef struct{
   poly vec[KYBER_K];
@@ -18,6 +19,10 @@ void polyvec_ntt(polyvec *r);
 void polyvec_invntt(polyvec *r);
   
 void polyvec_pointwise_acc(poly *r, const polyvec *a, const polyvec *b);
+void polyvec_pointwise_acc_ref(poly *r, const polyvec *a, const polyvec *b);
+#ifdef NTT_AVX2
+void polyvec_pointwise_acc_avx2(poly *r, const polyvec *a, const polyvec *b);
+#endif
 
 void polyvec_add(polyvec *r, const polyvec *a, const polyvec *b);
 
@@ -5,6 +5,8 @@
 #include "rng.h"
 #include "fips202.h"
 #include "ntt.h"
+#include "keccakx.h"
+#include "rejsample.h"
 
 static void pack_pk(unsigned char *r, const polyvec *pk, const unsigned char *seed)
 {
@@ -51,8 +53,9 @@ static void unpack_sk(polyvec *sk, const unsigned char *packedsk)
 #define gen_a(A,B)  gen_matrix(A,B,0)
 #define gen_at(A,B) gen_matrix(A,B,1)
 
-/* Generate entry a_{i,j} of matrix A as Parse(SHAKE128(seed|i|j)) */
-void gen_matrix(polyvec *a, const unsigned char *seed, int transposed) //XXX: Not static for benchmarking
+/* Generate entry a_{i,j} of matrix A as Parse(SHAKE128(seed|i|j));
+   one entry at a time, kept as the reference for gen_matrix() */
+void gen_matrix_ref(polyvec *a, const unsigned char *seed, int transposed) //XXX: Not static for benchmarking
 {
   unsigned int pos=0, ctr;
   uint16_t val;
@@ -105,6 +108,76 @@ void gen_matrix(polyvec *a, const unsigned char *seed, int transposed) //XXX: No
   }
 }
 
+/* SHAKE128 input seed|i|j for entry k of the matrix, row-major */
+static void gen_matrix_seed(unsigned char *extseed, const unsigned char *seed, unsigned int k, int transposed)
+{
+  memcpy(extseed, seed, KYBER_SYMBYTES);
+  if(transposed)
+  {
+    extseed[KYBER_SYMBYTES]   = k/KYBER_K;
+    extseed[KYBER_SYMBYTES+1] = k%KYBER_K;
+  }
+  else
+  {
+    extseed[KYBER_SYMBYTES]   = k%KYBER_K;
+    extseed[KYBER_SYMBYTES+1] = k/KYBER_K;
+  }
+}
+
+/* The same matrix, four entries at a time from a 4-way interleaved
+   SHAKE128 state, with SIMD rejection sampling. The entry left over
+   for KYBER_K = 3 is done on its own. */
+void gen_matrix(polyvec *a, const unsigned char *seed, int transposed) //XXX: Not static for benchmarking
+{
+  unsigned int k, n, ctr[4];
+  uint8_t buf[4][SHAKE128_RATE*4];
+  uint64_t state[25*4];
+  unsigned char extseed[4][KYBER_SYMBYTES+2];
+  uint16_t *r[4];
+
+#ifdef KYBER_GEN_MATRIX_REF
+  gen_matrix_ref(a, seed, transposed);
+  return;
+#endif
+
+  for(k=0;k+4<=KYBER_K*KYBER_K;k+=4)
+  {
+    for(n=0;n<4;n++)
+    {
+      gen_matrix_seed(extseed[n], seed, k+n, transposed);
+      r[n] = a[(k+n)/KYBER_K].vec[(k+n)%KYBER_K].coeffs;
+    }
+
+    memset(state, 0, sizeof(state));
+    keccakx_absorb4x(state, SHAKE128_RATE, extseed[0], extseed[1], extseed[2], extseed[3], KYBER_SYMBYTES+2, 0x1F);
+    keccakx_squeezeblocks4x(buf[0], buf[1], buf[2], buf[3], 4, state, SHAKE128_RATE);
+    for(n=0;n<4;n++)
+      ctr[n] = rej_uniform(r[n], KYBER_N, buf[n], SHAKE128_RATE*4);
+
+    while(ctr[0] < KYBER_N || ctr[1] < KYBER_N || ctr[2] < KYBER_N || ctr[3] < KYBER_N)
+    {
+      keccakx_squeezeblocks4x(buf[0], buf[1], buf[2], buf[3], 1, state, SHAKE128_RATE);
+      for(n=0;n<4;n++)
+        ctr[n] += rej_uniform(r[n]+ctr[n], KYBER_N-ctr[n], buf[n], SHAKE128_RATE);
+    }
+  }
+
+  for(;k<KYBER_K*KYBER_K;k++)
+  {
+    gen_matrix_seed(extseed[0], seed, k, transposed);
+    r[0] = a[k/KYBER_K].vec[k%KYBER_K].coeffs;
+
+    shake128_absorb(state, extseed[0], KYBER_SYMBYTES+2);
+    shake128_squeezeblocks(buf[0], 4, state);
+    ctr[0] = rej_uniform(r[0], KYBER_N, buf[0], SHAKE128_RATE*4);
+    while(ctr[0] < KYBER_N)
+    {
+      shake128_squeezeblocks(buf[0], 1, state);
+      ctr[0] += rej_uniform(r[0]+ctr[0], KYBER_N-ctr[0], buf[0], SHAKE128_RATE);
+    }
+  }
+}
+
 
 void indcpa_keypair(unsigned char *pk, 
                    unsigned char *sk)
@@ -141,25 +214,29 @@ void indcpa_keypair(unsigned char *pk,
 }
 
 
-void indcpa_enc(unsigned char *c,
-               const unsigned char *m,
-               const unsigned char *pk,
-               const unsigned char *coins)
+void indcpa_expand_pk(indcpa_epk *epk,
+                      const unsigned char *pk)
 {
-  polyvec sp, pkpv, ep, at[KYBER_K], bp;
-  poly v, k, epp;
   unsigned char seed[KYBER_SYMBYTES];
-  int i;
-  unsigned char nonce=0;
 
+  unpack_pk(&epk->pkpv, seed, pk);
+  polyvec_ntt(&epk->pkpv);
+  gen_at(epk->at, seed);
+}
 
-  unpack_pk(&pkpv, seed, pk);
 
-  poly_frommsg(&k, m);
+void indcpa_enc_expanded(unsigned char *c,
+                        const unsigned char *m,
+                        const indcpa_epk *epk,
+                        const unsigned char *coins)
+{
+  polyvec sp, ep, bp;
+  poly v, k, epp;
+  int i;
+  unsigned char nonce=0;
 
-  polyvec_ntt(&pkpv);
 
-  gen_at(at, seed);
+  poly_frommsg(&k, m);
 
   for(i=0;i<KYBER_K;i++)
     poly_getnoise(sp.vec+i,coins,nonce++);
@@ -171,12 +248,12 @@ void indcpa_enc(unsigned char *c,
 
   // matrix-vector multiplication
   for(i=0;i<KYBER_K;i++)
-    polyvec_pointwise_acc(&bp.vec[i],&sp,at+i);
+    polyvec_pointwise_acc(&bp.vec[i],&sp,epk->at+i);
 
   polyvec_invntt(&bp);
   polyvec_add(&bp, &bp, &ep);
  
-  polyvec_pointwise_acc(&v, &pkpv, &sp);
+  polyvec_pointwise_acc(&v, &epk->pkpv, &sp);
   poly_invntt(&v);
 
   poly_getnoise(&epp,coins,nonce++);
@@ -188,22 +265,51 @@ void indcpa_enc(unsigned char *c,
 }
 
 
-void indcpa_dec(unsigned char *m,
-               const unsigned char *c,
-               const unsigned char *sk)
+void indcpa_enc(unsigned char *c,
+               const unsigned char *m,
+               const unsigned char *pk,
+               const unsigned char *coins)
+{
+  indcpa_epk epk;
+
+  indcpa_expand_pk(&epk, pk);
+  indcpa_enc_expanded(c, m, &epk, coins);
+}
+
+
+void indcpa_expand_sk(indcpa_esk *esk,
+                      const unsigned char *sk)
+{
+  unpack_sk(&esk->skpv, sk);
+}
+
+
+void indcpa_dec_expanded(unsigned char *m,
+                        const unsigned char *c,
+                        const indcpa_esk *esk)
 {
-  polyvec bp, skpv;
+  polyvec bp;
   poly v, mp;
 
   unpack_ciphertext(&bp, &v, c);
-  unpack_sk(&skpv, sk);
 
   polyvec_ntt(&bp);
 
-  polyvec_pointwise_acc(&mp,&skpv,&bp);
+  polyvec_pointwise_acc(&mp,&esk->skpv,&bp);
   poly_invntt(&mp);
 
   poly_sub(&mp, &mp, &v);
 
   poly_tomsg(m, &mp);
 }
+
+
+void indcpa_dec(unsigned char *m,
+               const unsigned char *c,
+               const unsigned char *sk)
+{
+  indcpa_esk esk;
+
+  indcpa_expand_sk(&esk, sk);
+  indcpa_dec_expanded(m, c, &esk);
+}
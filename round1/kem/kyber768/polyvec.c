@@ -200,7 +200,7 @@ void polyvec_invntt(polyvec *r)
     poly_invntt(&r->vec[i]);
 }
   
-void polyvec_pointwise_acc(poly *r, const polyvec *a, const polyvec *b)
+void polyvec_pointwise_acc_ref(poly *r, const polyvec *a, const polyvec *b)
 {
   int i,j;
   uint16_t t;
@@ -217,6 +217,18 @@ void polyvec_pointwise_acc(poly *r, const polyvec *a, const polyvec *b)
   }
 }
 
+void polyvec_pointwise_acc(poly *r, const polyvec *a, const polyvec *b)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+  {
+    polyvec_pointwise_acc_avx2(r, a, b);
+    return;
+  }
+#endif
+  polyvec_pointwise_acc_ref(r, a, b);
+}
+
 void polyvec_add(polyvec *r, const polyvec *a, const polyvec *b)
 {
   int i;
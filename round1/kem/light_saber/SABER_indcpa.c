@@ -8,6 +8,7 @@
 #include "rng.h"
 #include "fips202.h"
 #include "SABER_params.h"
+#include "poly_mul_avx2.h"
 
 
 
@@ -15,8 +16,9 @@
 	This routine generates a=[Matrix K x K] of 256-coefficient polynomials 
 -------------------------------------------------------------------------------------*/
 
-void VectorMul(uint16_t pkcl[SABER_K][SABER_N],uint16_t skpv[SABER_K][SABER_N],uint16_t mod,uint16_t res[SABER_N]);
-void MatrixVectorMul(polyvec *a, uint16_t skpv[SABER_K][SABER_N], uint16_t res[SABER_K][SABER_N], uint16_t mod, int16_t transpose);
+void VectorMul(uint16_t pkcl[SABER_K][SABER_N],uint16_t skpv[SABER_K][SABER_N],const toom4_eval_t *skev,uint16_t mod,uint16_t res[SABER_N]);
+void MatrixVectorMul(polyvec *a, uint16_t skpv[SABER_K][SABER_N], const toom4_eval_t *skev, uint16_t res[SABER_K][SABER_N], uint16_t mod, int16_t transpose);
+const toom4_eval_t *EvalVector(toom4_eval_t skev[SABER_K], uint16_t skpv[SABER_K][SABER_N]);
 
 void POL2MSG(uint16_t *message_dec_unpacked, unsigned char *message_dec);
 
@@ -54,6 +56,7 @@ void indcpa_kem_keypair(unsigned char *pk, unsigned char *sk)
 
   //polyvec skpv;
   uint16_t skpv[SABER_K][SABER_N];
+  toom4_eval_t skev[SABER_K];
  
   unsigned char seed[SABER_SEEDBYTES];
   unsigned char noiseseed[SABER_COINBYTES];
@@ -80,7 +83,7 @@ void indcpa_kem_keypair(unsigned char *pk, unsigned char *sk)
 		}
 	}
 
-	MatrixVectorMul(a,skpv,res,SABER_Q-1,0);
+	MatrixVectorMul(a,skpv,EvalVector(skev,skpv),res,SABER_Q-1,0);
 		
 
 	  //-----now rounding
@@ -113,18 +116,24 @@ void indcpa_kem_keypair(unsigned char *pk, unsigned char *sk)
 }
 
 
-void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, const unsigned char *pk, unsigned char *ciphertext)
+void indcpa_kem_expand_pk(indcpa_kem_epk *epk, const unsigned char *pk)
+{
+	GenMatrix(epk->a, pk + SABER_POLYVECCOMPRESSEDBYTES);	// seed is at the end of pk
+
+	BS2POLVECp(pk, epk->pkcl);
+}
+
+void indcpa_kem_enc_expanded(unsigned char *message_received, unsigned char *noiseseed, const indcpa_kem_epk *epk, unsigned char *ciphertext)
 { 
 
 
 	uint32_t i,j,k;
-	polyvec a[SABER_K];		// skpv;
-	unsigned char seed[SABER_SEEDBYTES];
-	uint16_t pkcl[SABER_K][SABER_N]; 	//public key of received by the client
 
 
 
 	uint16_t skpv1[SABER_K][SABER_N];
+	toom4_eval_t skev1[SABER_K];
+	const toom4_eval_t *skev;
 
 	uint16_t message[SABER_KEYBYTES*8];
 
@@ -140,13 +149,6 @@ void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, c
 
 	unsigned char rec_c[SABER_RECONBYTES_KEM];
 	
-	for(i=0;i<SABER_SEEDBYTES;i++){ // extract the seedbytes from Public Key.
-		seed[i]=pk[ SABER_POLYVECCOMPRESSEDBYTES + i]; 
-	}
-
-
-	GenMatrix(a, seed);				
-
 	GenSecret(skpv1,noiseseed);//generate secret from constant-time binomial distribution
 
 	//-----------------matrix-vector multiplication and rounding
@@ -157,7 +159,8 @@ void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, c
 		}
 	}
 
-	MatrixVectorMul(a,skpv1,res,SABER_Q-1,1);
+	skev=EvalVector(skev1,skpv1);	// also for v' below; s' mod p gives the same product mod p
+	MatrixVectorMul((polyvec *) epk->a,skpv1,skev,res,SABER_Q-1,1);	// read only
 	
 	  //-----now rounding
 
@@ -177,10 +180,6 @@ void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, c
 
 	//------now calculate the v'
 
-	//-------unpack the public_key
-
-	BS2POLVECp(pk, pkcl); //pkcl is the b in the protocol
-
 
 
 	for(i=0;i<SABER_N;i++)
@@ -193,7 +192,7 @@ void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, c
 	}
 
 	// vector-vector scalar multiplication with mod p
-	VectorMul(pkcl,skpv1,mod_p,vprime);
+	VectorMul((uint16_t (*)[SABER_N]) epk->pkcl,skpv1,skev,mod_p,vprime);	// read only
 
 
 	// unpack message_received;
@@ -229,15 +228,38 @@ void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, c
 }
 
 
-void indcpa_kem_dec(const unsigned char *sk, const unsigned char *ciphertext, unsigned char message_dec[])
+void indcpa_kem_enc(unsigned char *message_received, unsigned char *noiseseed, const unsigned char *pk, unsigned char *ciphertext)
 {
+	indcpa_kem_epk epk;
+
+	indcpa_kem_expand_pk(&epk, pk);
+	indcpa_kem_enc_expanded(message_received, noiseseed, &epk, ciphertext);
+}
+
 
+void indcpa_kem_expand_sk(indcpa_kem_esk *esk, const unsigned char *sk)
+{
 	uint32_t i,j;
+	uint16_t mod_p=SABER_P-1;
+
+	BS2POLVECq(sk, esk->sksv); //sksv is the secret-key
+
+	for(i=0;i<SABER_K;i++){
+		for(j=0;j<SABER_N;j++){
+			esk->sksv[i][j]=esk->sksv[i][j] & (mod_p);
+		}
+	}
+
+	EvalVector(esk->skev, esk->sksv);
+}
+
+
+void indcpa_kem_dec_expanded(const indcpa_kem_esk *esk, const unsigned char *ciphertext, unsigned char message_dec[])
+{
+
+	uint32_t i;
 	
 	
-	uint16_t sksv[SABER_K][SABER_N]; //secret key of the server
-	
-
 	uint16_t pksv[SABER_K][SABER_N];
 	
 	//uint16_t recon_ar[SABER_N];
@@ -251,7 +273,6 @@ void indcpa_kem_dec(const unsigned char *sk, const unsigned char *ciphertext, un
 
 	uint16_t v[SABER_N];
 
-	BS2POLVECq(sk, sksv); //sksv is the secret-key
 	BS2POLVECp(ciphertext, pksv); //pksv is the ciphertext
 
 
@@ -259,13 +280,7 @@ void indcpa_kem_dec(const unsigned char *sk, const unsigned char *ciphertext, un
 	for(i=0;i<SABER_N;i++)
 		v[i]=0;
 
-	for(i=0;i<SABER_K;i++){
-		for(j=0;j<SABER_N;j++){
-			sksv[i][j]=sksv[i][j] & (mod_p);
-		}
-	}
-
-	VectorMul(pksv,sksv,mod_p,v);
+	VectorMul(pksv,(uint16_t (*)[SABER_N]) esk->sksv,toom4_avx2_init() ? esk->skev : NULL,mod_p,v);	// read only
 
 	//Extraction
 	for(i=0;i<SABER_RECONBYTES_KEM;i++){
@@ -282,11 +297,58 @@ void indcpa_kem_dec(const unsigned char *sk, const unsigned char *ciphertext, un
 	POL2MSG(message_dec_unpacked, message_dec);
 }
 
-void MatrixVectorMul(polyvec *a, uint16_t skpv[SABER_K][SABER_N], uint16_t res[SABER_K][SABER_N], uint16_t mod, int16_t transpose){
+
+void indcpa_kem_dec(const unsigned char *sk, const unsigned char *ciphertext, unsigned char message_dec[])
+{
+	indcpa_kem_esk esk;
+
+	indcpa_kem_expand_sk(&esk, sk);
+	indcpa_kem_dec_expanded(&esk, ciphertext, message_dec);
+}
+
+// The secret vector evaluated for toom4_mac_avx2(), or NULL without AVX2
+
+const toom4_eval_t *EvalVector(toom4_eval_t skev[SABER_K], uint16_t skpv[SABER_K][SABER_N]){
+
+#ifdef SABER_MUL_AVX2
+	int32_t i;
+
+	if(toom4_avx2_init()){
+		for(i=0;i<SABER_K;i++)
+			toom4_eval_avx2(&skev[i], skpv[i]);
+		return skev;
+	}
+#endif
+	(void) skev;
+	(void) skpv;
+	return NULL;
+}
+
+// skev is EvalVector(skpv) or NULL. With it, the products are summed
+// before a single interpolation per row.
+
+void MatrixVectorMul(polyvec *a, uint16_t skpv[SABER_K][SABER_N], const toom4_eval_t *skev, uint16_t res[SABER_K][SABER_N], uint16_t mod, int16_t transpose){
 
 	uint16_t acc[SABER_N]; 
 	int32_t i,j,k;
 
+#ifdef SABER_MUL_AVX2
+	if(skev!=NULL){
+		toom4_eval_t ae;
+		toom4_acc_t sum;
+
+		for(i=0;i<SABER_K;i++){
+			memset(&sum, 0, sizeof(sum));
+			for(j=0;j<SABER_K;j++){
+				toom4_eval_avx2(&ae, transpose==1 ? a[j].vec[i].coeffs : a[i].vec[j].coeffs);
+				toom4_mac_avx2(&sum, &ae, &skev[j]);
+			}
+			toom4_interp_avx2(res[i], &sum, mod);
+		}
+		return;
+	}
+#endif
+
 	if(transpose==1){
 		for(i=0;i<SABER_K;i++){
 			for(j=0;j<SABER_K;j++){
@@ -333,12 +395,27 @@ void POL2MSG(uint16_t *message_dec_unpacked, unsigned char *message_dec){
 }
 
 
-void VectorMul(uint16_t pkcl[SABER_K][SABER_N],uint16_t skpv[SABER_K][SABER_N],uint16_t mod,uint16_t res[SABER_N]){
+void VectorMul(uint16_t pkcl[SABER_K][SABER_N],uint16_t skpv[SABER_K][SABER_N],const toom4_eval_t *skev,uint16_t mod,uint16_t res[SABER_N]){
 
 
 	uint32_t j,k;
 	uint16_t acc[SABER_N]; 
 
+#ifdef SABER_MUL_AVX2
+	if(skev!=NULL){	// mod p divides q, so the product mod q will do
+		toom4_eval_t pe;
+		toom4_acc_t sum;
+
+		memset(&sum, 0, sizeof(sum));
+		for(j=0;j<SABER_K;j++){
+			toom4_eval_avx2(&pe, pkcl[j]);
+			toom4_mac_avx2(&sum, &pe, &skev[j]);
+		}
+		toom4_interp_avx2(res, &sum, mod);
+		return;
+	}
+#endif
+
 	// vector-vector scalar multiplication with mod p
 	for(j=0;j<SABER_K;j++){
 		pol_mul(pkcl[j], skpv[j], acc , SABER_P, SABER_N,0);
@@ -44,9 +44,21 @@
 	#define Saber_type 3
 #endif
 
+// Expanded keys for kem_expand.h: A, b and Hash(pk); s, s evaluated for
+// the multiplier (63*16 coefficients), expanded pk and z. 2-byte
+// coefficients, SABER_K = Saber_type+1 polynomials of 256 per vector
+
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES ((Saber_type+1)*(Saber_type+2)*256*2 + 32)
+#define CRYPTO_EXPANDEDSKBYTES ((Saber_type+1)*(256+64*16)*2 + CRYPTO_EXPANDEDPKBYTES + 32)
+
 
 int crypto_kem_keypair(unsigned char *pk, unsigned char *sk);
 int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk);
 int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk);
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk);
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk);
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk);
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk);
 
 #endif /* api_h */
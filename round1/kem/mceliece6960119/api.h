@@ -3,6 +3,16 @@
 #define CRYPTO_CIPHERTEXTBYTES 226
 #define CRYPTO_BYTES 32
 
+/* Expanded keys for kem_expand.h: the pk rows 64-byte aligned; sk as it is */
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES 1089088
+#define CRYPTO_EXPANDEDSKBYTES CRYPTO_SECRETKEYBYTES
+
+/* each cache entry holds pk and the expanded pk */
+#ifndef KEM_CACHE_WAYS
+#define KEM_CACHE_WAYS 2
+#endif
+
 #define CRYPTO_ALGNAME "Classic McEliece 6960119"
 
 int crypto_kem_keypair( unsigned char *pk, unsigned char *sk);
@@ -11,3 +21,11 @@ int crypto_kem_enc( unsigned char *ct, unsigned char *ss, const unsigned char *p
 
 int crypto_kem_dec( unsigned char *ss, const unsigned char *ct, const unsigned char *sk);
 
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk);
+
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk);
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk);
+
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk);
+
@@ -0,0 +1,72 @@
+/*
+  This file is for the AVX2 syndrome computation
+*/
+
+#include "encrypt_avx2.h"
+
+#ifdef ENCRYPT_AVX2
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#define ENCRYPT_TARGET __attribute__ ((target("avx2,popcnt")))
+
+static int encrypt_avx2_ready = 0; /* 1: AVX2 and POPCNT, -1: not; set before main() */
+
+__attribute__ ((constructor)) static void encrypt_avx2_setup(void)
+{
+	__builtin_cpu_init();
+	encrypt_avx2_ready = (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) ? 1 : -1;
+}
+
+int encrypt_avx2_init(void)
+{
+	return encrypt_avx2_ready > 0;
+}
+
+/* each row is read once, straight from the public key, */
+/* and the rows ENCRYPT_PREFETCH ahead are prefetched a cache line at a time */
+ENCRYPT_TARGET void syndrome_rows_avx2(unsigned char *s, const unsigned char *rows, int nrows, int stride, const unsigned char *e, int len)
+{
+	int i, j;
+
+	const unsigned char *row;
+
+	__m256i acc;
+	uint64_t x, w, v;
+
+	for (i = 0; i < nrows; i++)
+	{
+		row = rows + (size_t) i * stride;
+		acc = _mm256_setzero_si256();
+
+		for (j = 0; j + 32 <= len; j += 32)
+		{
+			if ((j & 63) == 0)
+				_mm_prefetch((const char *) (row + ENCRYPT_PREFETCH*stride + j), _MM_HINT_T0);
+
+			acc = _mm256_xor_si256(acc, _mm256_and_si256(
+			        _mm256_loadu_si256((const __m256i *) (row + j)),
+			        _mm256_loadu_si256((const __m256i *) (e + j))));
+		}
+
+		x = _mm256_extract_epi64(acc, 0) ^ _mm256_extract_epi64(acc, 1) ^
+		    _mm256_extract_epi64(acc, 2) ^ _mm256_extract_epi64(acc, 3);
+
+		for (; j + 8 <= len; j += 8)
+		{
+			memcpy(&w, row + j, 8);
+			memcpy(&v, e + j, 8);
+			x ^= w & v;
+		}
+
+		for (; j < len; j++)
+			x ^= row[j] & e[j];
+
+		s[ i/8 ] ^= (_mm_popcnt_u64(x) & 1) << (i%8);
+	}
+}
+
+#endif
+
@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 
@@ -12,10 +13,15 @@
 #include "benes.h"
 #include "root.h"
 #include "util.h"
+#include "m4r.h"
+
+/* 64-bit words per row of the heap matrix of pk_gen() */
+#define PK_WORDS ((SYS_N + 63)/64)
 
 /* input: secret key sk */
 /* output: public key pk */
-int pk_gen(unsigned char * pk, unsigned char * sk)
+/* the original, constant-time code, with the matrix on the stack */
+int pk_gen_ref(unsigned char * pk, unsigned char * sk)
 {
 	unsigned char *pk_ptr = pk;
 
@@ -124,3 +130,152 @@ int pk_gen(unsigned char * pk, unsigned char * sk)
 	return 0;
 }
 
+/* input: g, the Goppa polynomial; L, the support */
+/* output: m, the parity-check matrix, PK_NROWS rows of PK_WORDS words */
+static void pk_matrix(uint64_t *m, gf *g, gf *L)
+{
+	int i, j, k, w;
+	uint64_t x[ GFBITS ];
+
+	gf inv[ SYS_N ];
+
+	root(inv, g, L);
+
+	for (j = 0; j < SYS_N; j++)
+		inv[j] = gf_inv(inv[j]);
+
+	for (i = 0; i < SYS_T; i++)
+	{
+		for (w = 0; w < PK_WORDS; w++)
+		{
+			for (k = 0; k < GFBITS; k++)
+				x[k] = 0;
+
+			for (j = w*64; j < SYS_N && j < w*64 + 64; j++)
+			for (k = 0; k < GFBITS; k++)
+				x[k] |= (uint64_t) ((inv[j] >> k) & 1) << (j & 63);
+
+			for (k = 0; k < GFBITS; k++)
+				m[ (size_t) (i*GFBITS + k) * PK_WORDS + w ] = x[k];
+		}
+
+		for (j = 0; j < SYS_N; j++)
+			inv[j] = gf_mul(inv[j], L[j]);
+	}
+}
+
+#ifndef PK_GEN_M4R
+
+/* the elimination of pk_gen_ref() on 64-bit words: reduces the first */
+/* PK_NROWS columns of m to the identity, in constant time unless they */
+/* are singular; returns -1 then, where pk_gen_ref() does */
+static int pk_systematic(uint64_t *m)
+{
+	int row, k, c, w;
+
+	uint64_t mask, *r, *t;
+
+	for (row = 0; row < PK_NROWS; row++)
+	{
+		/* columns before the pivot are zero in this row and below, */
+		/* so the words before that of the pivot are skipped */
+
+		w = row >> 6;
+		r = m + (size_t) row * PK_WORDS;
+
+		for (k = row + 1; k < PK_NROWS; k++)
+		{
+			t = m + (size_t) k * PK_WORDS;
+
+			mask = (r[w] ^ t[w]) >> (row & 63);
+			mask &= 1;
+			mask = -mask;
+
+			for (c = w; c < PK_WORDS; c++)
+				r[c] ^= t[c] & mask;
+		}
+
+		if (((r[w] >> (row & 63)) & 1) == 0) /* return if not systematic */
+			return -1;
+
+		for (k = 0; k < PK_NROWS; k++)
+		{
+			if (k != row)
+			{
+				t = m + (size_t) k * PK_WORDS;
+
+				mask = t[w] >> (row & 63);
+				mask &= 1;
+				mask = -mask;
+
+				for (c = w; c < PK_WORDS; c++)
+					t[c] ^= r[c] & mask;
+			}
+		}
+	}
+
+	return 0;
+}
+
+#endif
+
+/* input: secret key sk */
+/* output: public key pk */
+/* as pk_gen_ref(), with the matrix on the heap in rows of 64-bit words; */
+/* the elimination is pk_systematic(), or with -DPK_GEN_M4R the faster */
+/* m4r_systematic(), which is not constant-time */
+int pk_gen(unsigned char * pk, unsigned char * sk)
+{
+	int i, j, b;
+
+	uint64_t *m, *row, x;
+
+	gf g[ SYS_T+1 ];
+	gf L[ SYS_N ];
+
+	m = malloc((size_t) PK_NROWS * PK_WORDS * sizeof(uint64_t));
+
+	if (m == NULL)
+		return pk_gen_ref(pk, sk);
+
+	g[ SYS_T ] = 1;
+
+	for (i = 0; i < SYS_T; i++) { g[i] = load2(sk); g[i] &= GFMASK; sk += 2; }
+
+	support_gen(L, sk);
+
+	pk_matrix(m, g, L);
+
+#ifdef PK_GEN_M4R
+	if (m4r_systematic(m, PK_NROWS, PK_WORDS, PK_WORDS) != 0)
+#else
+	if (pk_systematic(m) != 0)
+#endif
+	{
+		free(m);
+		return -1;
+	}
+
+	/* columns PK_NROWS .. SYS_N-1; bits beyond SYS_N are zero */
+
+	for (i = 0; i < PK_NROWS; i++)
+	{
+		row = m + (size_t) i * PK_WORDS;
+
+		for (b = 0; b < PK_ROW_BYTES; b++)
+		{
+			j = PK_NROWS + b*8;
+			x = row[j >> 6] >> (j & 63);
+
+			if ((j & 63) > 56 && (j >> 6) + 1 < PK_WORDS)
+				x |= row[(j >> 6) + 1] << (64 - (j & 63));
+
+			*pk++ = (unsigned char) x;
+		}
+	}
+
+	free(m);
+
+	return 0;
+}
+
@@ -9,6 +9,7 @@
 
 gf eval(gf *, gf);
 void root(gf *, gf *, gf *);
+void root_fft(unsigned char *, gf *, const unsigned char *);
 
 #endif
 
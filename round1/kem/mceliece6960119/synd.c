@@ -6,6 +6,8 @@
 
 #include "params.h"
 #include "root.h"
+#include "benes.h"
+#include "util.h"
 
 #include <stdio.h>
 
@@ -34,3 +36,31 @@ void synd(gf *out, gf *f, gf *L, unsigned char *r)
 	}
 }
 
+/* input: g_inv, 1/g(a)^2 for all field elements a as from fft(), */
+/*        condition bits of the Benes network, received word r */
+/* output: out, the syndrome of length 2t, as synd() with the support of support_gen() */
+void synd_fft(gf *out, vec g_inv[][ GFBITS ], const unsigned char *cond, const unsigned char *r)
+{
+	int i, j;
+
+	vec v[ FFT_WORDS ][ GFBITS ];
+	vec m;
+
+	unsigned char c[ (1 << GFBITS)/8 ];
+
+	for (i = 0; i < SYS_N/8; i++)            c[i] = r[i];
+	for (i = SYS_N/8; i < (1 << GFBITS)/8; i++) c[i] = 0;
+
+	apply_benes(c, cond, 1);
+
+	for (i = 0; i < FFT_WORDS; i++)
+	{
+		m = load8(c + i*8);
+
+		for (j = 0; j < GFBITS; j++)
+			v[i][j] = g_inv[i][j] & m;
+	}
+
+	fft_tr(out, v);
+}
+
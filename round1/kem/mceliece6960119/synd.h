@@ -6,8 +6,10 @@
 #define SYND_H
 
 #include "gf.h"
+#include "fft.h"
 
 void synd(gf *, gf *, gf *, unsigned char *);
+void synd_fft(gf *, vec [][ GFBITS ], const unsigned char *, const unsigned char *);
 
 #endif
 
@@ -0,0 +1,124 @@
+/*
+  This file is for bitsliced field arithmetic: 64 field elements are
+  held in GFBITS words, bit i of word j being bit j of the i-th element
+*/
+
+#include "vec.h"
+
+/* reduction of buf, 2*GFBITS-1 words, modulo x^13 + x^4 + x^3 + x + 1 */
+static inline void vec_reduce(vec *out, vec *buf)
+{
+	int i;
+
+	for (i = 2*GFBITS-2; i >= GFBITS; i--)
+	{
+		buf[i - GFBITS + 4] ^= buf[i];
+		buf[i - GFBITS + 3] ^= buf[i];
+		buf[i - GFBITS + 1] ^= buf[i];
+		buf[i - GFBITS + 0] ^= buf[i];
+	}
+
+	for (i = 0; i < GFBITS; i++)
+		out[i] = buf[i];
+}
+
+/* output: out, 64 copies of a */
+void vec_set(vec *out, gf a)
+{
+	int i;
+
+	for (i = 0; i < GFBITS; i++)
+		out[i] = -((vec) ((a >> i) & 1));
+}
+
+/* input: in0, in1 */
+/* output: out = in0*in1, elementwise; out may alias an input */
+void vec_mul(vec *out, const vec *in0, const vec *in1)
+{
+	int i, j;
+
+	vec buf[ 2*GFBITS-1 ];
+
+	for (i = 0; i < 2*GFBITS-1; i++)
+		buf[i] = 0;
+
+	for (i = 0; i < GFBITS; i++)
+	for (j = 0; j < GFBITS; j++)
+		buf[i+j] ^= in0[i] & in1[j];
+
+	vec_reduce(out, buf);
+}
+
+/* input: in */
+/* output: out = in^2, elementwise; out may alias in */
+void vec_sq(vec *out, const vec *in)
+{
+	int i;
+
+	vec buf[ 2*GFBITS-1 ];
+
+	for (i = 0; i < GFBITS-1; i++)
+	{
+		buf[2*i+0] = in[i];
+		buf[2*i+1] = 0;
+	}
+
+	buf[2*GFBITS-2] = in[GFBITS-1];
+
+	vec_reduce(out, buf);
+}
+
+/* input: in, no element zero */
+/* output: out = in^-1 = in^(2^13-2), elementwise; out may alias in */
+void vec_inv(vec *out, const vec *in)
+{
+	int i;
+
+	vec tmp_11[ GFBITS ];
+	vec tmp_1111[ GFBITS ];
+	vec t[ GFBITS ];
+
+	vec_sq(tmp_11, in);
+	vec_mul(tmp_11, tmp_11, in); // ^11
+
+	vec_sq(tmp_1111, tmp_11);
+	vec_sq(tmp_1111, tmp_1111);
+	vec_mul(tmp_1111, tmp_1111, tmp_11); // ^1111
+
+	vec_sq(t, tmp_1111);
+	for (i = 1; i < 4; i++)
+		vec_sq(t, t);
+	vec_mul(t, t, tmp_1111); // ^11111111
+
+	for (i = 0; i < 4; i++)
+		vec_sq(t, t);
+	vec_mul(t, t, tmp_1111); // ^111111111111
+
+	vec_sq(out, t); // ^1111111111110 = ^-1
+}
+
+/* input: in */
+/* return: the sum of the 64 elements */
+gf vec_sum(const vec *in)
+{
+	int i;
+
+	vec t;
+	gf r = 0;
+
+	for (i = 0; i < GFBITS; i++)
+	{
+		t = in[i];
+		t ^= t >> 32;
+		t ^= t >> 16;
+		t ^= t >> 8;
+		t ^= t >> 4;
+		t ^= t >> 2;
+		t ^= t >> 1;
+
+		r |= (gf) ((t & 1) << i);
+	}
+
+	return r;
+}
+
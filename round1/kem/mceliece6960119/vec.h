@@ -0,0 +1,23 @@
+/*
+  This file is for bitsliced field arithmetic: 64 field elements are
+  held in GFBITS words, bit i of word j being bit j of the i-th element
+*/
+
+#ifndef VEC_H
+#define VEC_H
+
+#include "params.h"
+#include "gf.h"
+
+#include <stdint.h>
+
+typedef uint64_t vec;
+
+void vec_set(vec *, gf);
+void vec_mul(vec *, const vec *, const vec *);
+void vec_sq(vec *, const vec *);
+void vec_inv(vec *, const vec *);
+gf vec_sum(const vec *);
+
+#endif
+
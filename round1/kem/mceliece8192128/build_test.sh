@@ -3,5 +3,5 @@
 $CC $CFLAGS -o $XKEM_BIN -I. \
 	-I../../../KeccakCodePackage/bin/generic64 \
 	-I../../nist \
-	-DXBENCH_REPS=1 *.c $XKEM_SRC ../../nist/rng.c \
+	-DXBENCH_REPS=1 *.c $XKEM_SRC ../../nist/rng.c ../../nist/kem_cache.c \
 	../../../KeccakCodePackage/bin/generic64/libkeccak.a -lcrypto
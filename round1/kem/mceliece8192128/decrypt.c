@@ -12,6 +12,7 @@
 #include "root.h"
 #include "gf.h"
 #include "bm.h"
+#include "fft.h"
 
 /* Nieddereiter decryption with the Berlekamp decoder */
 /* intput: sk, secret key */
@@ -26,14 +27,13 @@ int decrypt(unsigned char *e, const unsigned char *sk, const unsigned char *c)
 	unsigned char r[ SYS_N/8 ];
 
 	gf g[ SYS_T+1 ];
-	gf L[ SYS_N ];
+	vec g_inv[ FFT_WORDS ][ GFBITS ];
 
 	gf s[ SYS_T*2 ];
 	gf s_cmp[ SYS_T*2 ];
 	gf locator[ SYS_T+1 ];
-	gf images[ SYS_N ];
 
-	gf t;
+	unsigned char t;
 
 	//
 
@@ -42,26 +42,28 @@ int decrypt(unsigned char *e, const unsigned char *sk, const unsigned char *c)
 
 	for (i = 0; i < SYS_T; i++) { g[i] = load2(sk); g[i] &= GFMASK; sk += 2; } g[ SYS_T ] = 1;
 
-	support_gen(L, sk);
+	/* 1/g(a)^2 for all field elements a, in the order of fft() */
 
-	synd(s, g, L, r);
+	fft(g_inv, g);
+
+	for (i = 0; i < FFT_WORDS; i++)
+	{
+		vec_sq(g_inv[i], g_inv[i]);
+		vec_inv(g_inv[i], g_inv[i]);
+	}
+
+	synd_fft(s, g_inv, sk, r);
 
 	bm(locator, s);
 
-	root(images, locator, L);
+	root_fft(e, locator, sk);
 
 	//
-	
-	for (i = 0; i < SYS_N/8; i++) 
-		e[i] = 0;
 
 	for (i = 0; i < SYS_N; i++)
 	{
-		t = gf_iszero(images[i]) & 1;
-
-		e[ i/8 ] |= t << (i%8);
+		t = (e[ i/8 ] >> (i%8)) & 1;
 		w += t;
-
 	}
 
 #ifdef KAT
@@ -75,7 +77,7 @@ int decrypt(unsigned char *e, const unsigned char *sk, const unsigned char *c)
   }
 #endif
 	
-	synd(s_cmp, g, L, e);
+	synd_fft(s_cmp, g_inv, sk, e);
 
 	//
 
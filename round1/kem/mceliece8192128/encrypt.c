@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "gf.h"
+#include "encrypt_avx2.h"
 
 /* output: e, an error vector of weight t */
 static void gen_e(unsigned char *e)
@@ -66,8 +67,8 @@ static void gen_e(unsigned char *e)
 }
 
 /* input: public key pk, error vector e */
-/* output: syndrome s */
-void syndrome(unsigned char *s, const unsigned char *pk, unsigned char *e)
+/* output: syndrome s, byte by byte as in the original code */
+void syndrome_ref(unsigned char *s, const unsigned char *pk, unsigned char *e)
 {
 	unsigned char b, row[SYS_N/8];
 	const unsigned char *pk_ptr = pk;
@@ -102,7 +103,118 @@ void syndrome(unsigned char *s, const unsigned char *pk, unsigned char *e)
 	}
 }
 
-void encrypt(unsigned char *s, const unsigned char *pk, unsigned char *e)
+/* input: error vector e */
+/* output: t, e shifted down by PK_NROWS bits, the part that meets */
+/*         the public-key rows, zero padded to PK_ROW_STRIDE bytes */
+static void e_tail(unsigned char *t, const unsigned char *e)
+{
+	int i, j, tail = PK_NROWS % 8;
+
+	for (i = 0; i < PK_ROW_STRIDE; i++)
+	{
+		j = PK_NROWS/8 + i;
+
+		t[i] = (j < SYS_N/8) ? (e[j] >> tail) : 0;
+
+		if (tail != 0 && j + 1 < SYS_N/8)
+			t[i] |= e[j+1] << (8-tail);
+	}
+}
+
+/* input: public-key rows, stride bytes apart; t, e_tail() of the error vector */
+/* output: s, bit i flipped if row i and t have odd overlap */
+static void syndrome_rows(unsigned char *s, const unsigned char *pk, int stride, const unsigned char *t)
+{
+	int i, j;
+
+	const unsigned char *row;
+	uint64_t x, w, v;
+
+#ifdef ENCRYPT_AVX2
+	if (encrypt_avx2_init())
+	{
+		syndrome_rows_avx2(s, pk, PK_NROWS, stride, t, stride);
+		return;
+	}
+#endif
+
+	for (i = 0; i < PK_NROWS; i++)
+	{
+		row = pk + (size_t) i * stride;
+		x = 0;
+
+		for (j = 0; j + 8 <= stride; j += 8)
+		{
+			memcpy(&w, row + j, 8);
+			memcpy(&v, t + j, 8);
+			x ^= w & v;
+		}
+
+		for (; j < stride; j++)
+			x ^= row[j] & t[j];
+
+		x ^= x >> 32;
+		x ^= x >> 16;
+		x ^= x >> 8;
+		x ^= x >> 4;
+		x ^= x >> 2;
+		x ^= x >> 1;
+
+		s[ i/8 ] ^= (x & 1) << (i%8);
+	}
+}
+
+/* input: public key pk, rows stride bytes apart, error vector e */
+/* output: syndrome s */
+static void syndrome_stride(unsigned char *s, const unsigned char *pk, int stride, unsigned char *e)
+{
+	int i;
+
+	unsigned char t[ PK_ROW_STRIDE ];
+
+	/* the identity part of the parity-check matrix */
+
+	for (i = 0; i < SYND_BYTES; i++)
+		s[i] = e[i];
+
+	if (PK_NROWS % 8)
+		s[ SYND_BYTES-1 ] &= (1 << (PK_NROWS % 8)) - 1;
+
+	e_tail(t, e);
+
+	syndrome_rows(s, pk, stride, t);
+}
+
+/* input: public key pk, error vector e */
+/* output: syndrome s */
+void syndrome(unsigned char *s, const unsigned char *pk, unsigned char *e)
+{
+	syndrome_stride(s, pk, PK_ROW_BYTES, e);
+}
+
+/* as syndrome(), with the public key from pk_expand() */
+void syndrome_expanded(unsigned char *s, const unsigned char *epk, unsigned char *e)
+{
+	syndrome_stride(s, epk, PK_ROW_STRIDE, e);
+}
+
+/* input: public key pk */
+/* output: epk, the rows of pk PK_ROW_STRIDE bytes apart and zero padded */
+void pk_expand(unsigned char *epk, const unsigned char *pk)
+{
+	int i;
+
+	for (i = 0; i < PK_NROWS; i++)
+	{
+		memcpy(epk + (size_t) i * PK_ROW_STRIDE, pk + (size_t) i * PK_ROW_BYTES, PK_ROW_BYTES);
+		memset(epk + (size_t) i * PK_ROW_STRIDE + PK_ROW_BYTES, 0, PK_ROW_STRIDE - PK_ROW_BYTES);
+	}
+}
+
+/* input: public key pk, and syndrome() or syndrome_expanded() */
+/* output: error vector e, syndrome s */
+static void encrypt_with(unsigned char *s, const unsigned char *pk, unsigned char *e,
+                         void (*synd)(unsigned char *, const unsigned char *, unsigned char *))
 {
 	gen_e(e);
 
@@ -117,6 +229,17 @@ void encrypt(unsigned char *s, const unsigned char *pk, unsigned char *e)
   }
 #endif
 
-	syndrome(s, pk, e);
+	synd(s, pk, e);
+}
+
+void encrypt(unsigned char *s, const unsigned char *pk, unsigned char *e)
+{
+	encrypt_with(s, pk, e, syndrome);
+}
+
+/* as encrypt(), with the public key from pk_expand() */
+void encrypt_expanded(unsigned char *s, const unsigned char *epk, unsigned char *e)
+{
+	encrypt_with(s, epk, e, syndrome_expanded);
 }
 
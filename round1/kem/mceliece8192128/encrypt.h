@@ -5,7 +5,13 @@
 #ifndef ENCRYPT_H
 #define ENCRYPT_H
 
+void syndrome(unsigned char *, const unsigned char *, unsigned char *);
+void syndrome_ref(unsigned char *, const unsigned char *, unsigned char *);
+void syndrome_expanded(unsigned char *, const unsigned char *, unsigned char *);
+void pk_expand(unsigned char *, const unsigned char *);
+
 void encrypt(unsigned char *, const unsigned char *, unsigned char *);
+void encrypt_expanded(unsigned char *, const unsigned char *, unsigned char *);
 
 #endif
 
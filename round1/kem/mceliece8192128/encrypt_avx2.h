@@ -0,0 +1,29 @@
+/*
+  This file is for the AVX2 syndrome computation
+*/
+
+#ifndef ENCRYPT_AVX2_H
+#define ENCRYPT_AVX2_H
+
+#if defined(__x86_64__) && !defined(ENCRYPT_REF)
+#define ENCRYPT_AVX2
+#endif
+
+/* rows ahead of the current one that are prefetched */
+#define ENCRYPT_PREFETCH 8
+
+#ifdef ENCRYPT_AVX2
+
+/* return: nonzero if the CPU has AVX2 and POPCNT */
+int encrypt_avx2_init(void);
+
+/* input: nrows rows of len bytes at rows, stride bytes apart; e, len bytes */
+/* output: s, bit i flipped if row i and e have odd overlap */
+void syndrome_rows_avx2(unsigned char *, const unsigned char *, int, int, const unsigned char *, int);
+
+#else
+#define encrypt_avx2_init() 0
+#endif
+
+#endif
+
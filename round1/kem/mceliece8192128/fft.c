@@ -0,0 +1,297 @@
+/*
+  This file is for the Gao-Mateer additive FFT, which evaluates a
+  polynomial of degree less than 2^FFT_LOGN at all field elements, and
+  its transpose, which gives the power sums of the syndrome. The
+  butterflies work on 64 elements at a time in bitsliced form (vec.h).
+  Element bitrev(i) is lane i%64 of word i/64, the order that
+  support_gen() permutes with the Benes network.
+*/
+
+#include "fft.h"
+
+#define FFT_LOGN 8
+#define FFT_N (1 << FFT_LOGN)
+
+#if SYS_T + 1 > FFT_N || 2*SYS_T > FFT_N
+#error "FFT_LOGN too small for SYS_T"
+#endif
+
+/* the basis of each level of the recursion */
+typedef struct
+{
+	gf beta[ FFT_LOGN ];
+	gf gamma[ FFT_LOGN ][ GFBITS ];
+} fft_basis;
+
+/* level d evaluates at span(b_0, .., b_{m-1}), m = GFBITS-d */
+/* f(x) = g(x/beta) with beta = b_{m-1}, and span(b) = beta*span(gamma) */
+/* gamma_i = b_i/beta, the last one 1; level d+1 has b_i = gamma_i^2 + gamma_i */
+static void basis_gen(fft_basis *b)
+{
+	int d, i, m;
+
+	gf B[ GFBITS ];
+	gf inv;
+
+	for (i = 0; i < GFBITS; i++)
+		B[i] = 1 << (GFBITS-1-i);
+
+	for (d = 0; d < FFT_LOGN; d++)
+	{
+		m = GFBITS - d;
+
+		b->beta[d] = B[m-1];
+		inv = gf_inv(B[m-1]);
+
+		for (i = 0; i < m-1; i++)
+		{
+			b->gamma[d][i] = gf_mul(B[i], inv);
+			B[i] = gf_mul(b->gamma[d][i], b->gamma[d][i]) ^ b->gamma[d][i];
+		}
+
+		b->gamma[d][m-1] = 1;
+	}
+}
+
+/* output: out, the bitsliced sum of e_i over the bits i of each lane */
+static void lane_gen(vec *out, const gf *e)
+{
+	int i, j;
+
+	const vec M[] = {0xAAAAAAAAAAAAAAAA,
+	                 0xCCCCCCCCCCCCCCCC,
+	                 0xF0F0F0F0F0F0F0F0,
+	                 0xFF00FF00FF00FF00,
+	                 0xFFFF0000FFFF0000,
+	                 0xFFFFFFFF00000000};
+
+	for (j = 0; j < GFBITS; j++)
+	{
+		out[j] = 0;
+
+		for (i = 0; i < 6; i++)
+			out[j] ^= M[i] & -((vec) ((e[i] >> j) & 1));
+	}
+}
+
+/* output: the sum of e_i over the bits i of w */
+static gf word_gen(int w, const gf *e)
+{
+	int i;
+
+	gf r = 0;
+
+	for (i = 0; (w >> i) != 0; i++)
+		r ^= e[i] & -((gf) ((w >> i) & 1));
+
+	return r;
+}
+
+/* output: pw, the powers 1, beta, beta^2, .. of beta, n of them */
+static void powers(gf *pw, gf beta, int n)
+{
+	int i;
+
+	pw[0] = 1;
+
+	for (i = 1; i < n; i++)
+		pw[i] = gf_mul(pw[i-1], beta);
+}
+
+/* in place: g(x) = sum_i (g[2i] + g[2i+1] x) (x^2 + x)^i */
+static void radix_conv(gf *g, int n)
+{
+	int j, q = n/4;
+
+	if (n <= 2)
+		return;
+
+	for (j = 0; j < q; j++) g[2*q + j] ^= g[3*q + j];
+	for (j = 0; j < q; j++) g[1*q + j] ^= g[2*q + j];
+
+	radix_conv(g, n/2);
+	radix_conv(g + n/2, n/2);
+}
+
+/* the transpose of radix_conv() */
+static void radix_conv_tr(gf *g, int n)
+{
+	int j, q = n/4;
+
+	if (n <= 2)
+		return;
+
+	radix_conv_tr(g, n/2);
+	radix_conv_tr(g + n/2, n/2);
+
+	for (j = 0; j < q; j++) g[2*q + j] ^= g[1*q + j];
+	for (j = 0; j < q; j++) g[3*q + j] ^= g[2*q + j];
+}
+
+/* input: polynomial f of degree SYS_T */
+/* output: out, f(bitrev(i)) in lane i%64 of word i/64 for all i */
+void fft(vec out[][ GFBITS ], gf *f)
+{
+	int i, j, k, d, n, h, p;
+
+	fft_basis b;
+
+	gf g[ FFT_N ];
+	gf tmp[ FFT_N ];
+	gf pw[ FFT_N ];
+
+	vec a[ GFBITS ];
+	vec t[ GFBITS ];
+	vec u[ GFBITS ];
+
+	basis_gen(&b);
+
+	for (i = 0; i < FFT_N; i++)
+		g[i] = (i <= SYS_T) ? f[i] : 0;
+
+	/* twist, radix conversion, and g0, g1 to the two halves; */
+	/* each level halves the degree and the basis shrinks by one */
+
+	for (d = 0; d < FFT_LOGN; d++)
+	{
+		n = FFT_N >> d;
+		powers(pw, b.beta[d], n);
+
+		for (p = 0; p < FFT_N; p += n)
+		{
+			for (i = 0; i < n; i++)
+				g[p+i] = gf_mul(g[p+i], pw[i]);
+
+			radix_conv(g + p, n);
+
+			for (i = 0; i < n/2; i++)
+			{
+				tmp[i] = g[p + 2*i + 0];
+				tmp[n/2 + i] = g[p + 2*i + 1];
+			}
+
+			for (i = 0; i < n; i++)
+				g[p+i] = tmp[i];
+		}
+	}
+
+	/* the last level: g0 + alpha*g1 for alpha in span(gamma), one word each */
+
+	lane_gen(a, b.gamma[FFT_LOGN-1]);
+
+	for (p = 0; p < FFT_WORDS; p++)
+	{
+		vec_set(t, g[2*p+1]);
+		vec_mul(out[p], a, t);
+
+		vec_set(t, g[2*p+0]);
+		for (k = 0; k < GFBITS; k++)
+			out[p][k] ^= t[k];
+	}
+
+	/* butterflies of the other levels, g0 + alpha*g1 and g0 + (alpha+1)*g1 */
+
+	for (d = FFT_LOGN-2; d >= 0; d--)
+	{
+		h = 1 << (FFT_LOGN-2-d);
+		lane_gen(a, b.gamma[d]);
+
+		for (j = 0; j < h; j++)
+		{
+			vec_set(u, word_gen(j, &b.gamma[d][6]));
+			for (k = 0; k < GFBITS; k++)
+				u[k] ^= a[k];
+
+			for (p = j; p < FFT_WORDS; p += 2*h)
+			{
+				vec_mul(t, u, out[p+h]);
+
+				for (k = 0; k < GFBITS; k++)
+				{
+					out[p][k] ^= t[k];
+					out[p+h][k] ^= out[p][k];
+				}
+			}
+		}
+	}
+}
+
+/* input: in, overwritten */
+/* output: out, the sums of in[i] * bitrev(i)^j for j < 2*SYS_T, */
+/*         in[i] being lane i%64 of word i/64 */
+void fft_tr(gf *out, vec in[][ GFBITS ])
+{
+	int i, j, k, d, n, h, p;
+
+	fft_basis b;
+
+	gf g[ FFT_N ];
+	gf tmp[ FFT_N ];
+	gf pw[ FFT_N ];
+
+	vec a[ GFBITS ];
+	vec t[ GFBITS ];
+	vec u[ GFBITS ];
+
+	basis_gen(&b);
+
+	/* the steps of fft() in reverse order, each one transposed */
+
+	for (d = 0; d <= FFT_LOGN-2; d++)
+	{
+		h = 1 << (FFT_LOGN-2-d);
+		lane_gen(a, b.gamma[d]);
+
+		for (j = 0; j < h; j++)
+		{
+			vec_set(u, word_gen(j, &b.gamma[d][6]));
+			for (k = 0; k < GFBITS; k++)
+				u[k] ^= a[k];
+
+			for (p = j; p < FFT_WORDS; p += 2*h)
+			{
+				for (k = 0; k < GFBITS; k++)
+					in[p][k] ^= in[p+h][k];
+
+				vec_mul(t, u, in[p]);
+
+				for (k = 0; k < GFBITS; k++)
+					in[p+h][k] ^= t[k];
+			}
+		}
+	}
+
+	lane_gen(a, b.gamma[FFT_LOGN-1]);
+
+	for (p = 0; p < FFT_WORDS; p++)
+	{
+		g[2*p+0] = vec_sum(in[p]);
+
+		vec_mul(t, a, in[p]);
+		g[2*p+1] = vec_sum(t);
+	}
+
+	for (d = FFT_LOGN-1; d >= 0; d--)
+	{
+		n = FFT_N >> d;
+		powers(pw, b.beta[d], n);
+
+		for (p = 0; p < FFT_N; p += n)
+		{
+			for (i = 0; i < n/2; i++)
+			{
+				tmp[2*i + 0] = g[p + i];
+				tmp[2*i + 1] = g[p + n/2 + i];
+			}
+
+			radix_conv_tr(tmp, n);
+
+			for (i = 0; i < n; i++)
+				g[p+i] = gf_mul(tmp[i], pw[i]);
+		}
+	}
+
+	for (i = 0; i < 2*SYS_T; i++)
+		out[i] = g[i];
+}
+
@@ -0,0 +1,19 @@
+/*
+  This file is for the additive FFT and its transpose
+*/
+
+#ifndef FFT_H
+#define FFT_H
+
+#include "params.h"
+#include "gf.h"
+#include "vec.h"
+
+/* words of 64 field elements for all of GF(2^m) */
+#define FFT_WORDS ((1 << GFBITS)/64)
+
+void fft(vec [][ GFBITS ], gf *);
+void fft_tr(gf *, vec [][ GFBITS ]);
+
+#endif
+
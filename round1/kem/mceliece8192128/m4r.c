@@ -0,0 +1,269 @@
+/*
+  This file is for Gaussian elimination over GF(2) with the Method of
+  Four Russians, on 64-bit words
+
+  Each pass finds up to M4R_K * M4R_TABLES pivots, makes them an
+  identity block, and builds a Gray-code table of all M4R_K-row
+  combinations for each group of M4R_K pivot rows. Every other row is
+  then reduced with one table row per group, instead of one row
+  addition per pivot. The reduction runs column block by column block
+  so that the tables stay in cache; with M4R_THREADS > 1 the column
+  blocks are shared among threads.
+
+  See M. Albrecht, G. Bard and C. Pernet, "Efficient dense Gaussian
+  elimination over the field with two elements", 2011, and m4r.c of
+  NTS-KEM.
+
+  Unlike the byte-wise code of pk_gen_ref(), the table lookups and
+  pivot searches depend on the matrix, so this is not constant-time.
+*/
+
+#include "m4r.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if M4R_THREADS > 1
+#include <pthread.h>
+#endif
+
+#define M4R_PIVOTS (M4R_K * M4R_TABLES)
+
+/* one pass of the row reduction */
+typedef struct
+{
+	uint64_t *m;
+	int nrows;
+	int stride;
+	int r;              /* first pivot row, and column */
+	int np;             /* pivots in this pass */
+	int w0, w1;         /* words of the columns to reduce */
+	uint8_t *idx;       /* M4R_TABLES table indices for each row */
+	uint64_t *tab;      /* M4R_TABLES * 2^M4R_K * M4R_BLOCK words */
+} m4r_pass;
+
+static inline int bit(const uint64_t *row, int j)
+{
+	return (row[j >> 6] >> (j & 63)) & 1;
+}
+
+/* bits j .. j+n-1 of row, n <= 8 */
+static inline int bits(const uint64_t *row, int j, int n)
+{
+	uint64_t x = row[j >> 6] >> (j & 63);
+
+	if ((j & 63) + n > 64)
+		x |= row[(j >> 6) + 1] << (64 - (j & 63));
+
+	return (int) (x & ((1 << n) - 1));
+}
+
+static inline void add_row(uint64_t *dst, const uint64_t *src, int w0, int w1)
+{
+	int w;
+
+	for (w = w0; w < w1; w++)
+		dst[w] ^= src[w];
+}
+
+static inline void swap_rows(uint64_t *a, uint64_t *b, int w0, int w1)
+{
+	int w;
+	uint64_t t;
+
+	for (w = w0; w < w1; w++)
+	{
+		t = a[w]; a[w] = b[w]; b[w] = t;
+	}
+}
+
+/* input: m, rows r .. nrows-1 zero in columns 0 .. r-1 */
+/* output: m, rows r .. r+np-1 an identity block in columns r .. r+np-1 */
+/* return: 0 for success; -1 if some column has no pivot */
+static int m4r_pivots(uint64_t *m, int nrows, int nwords, int stride, int r, int np)
+{
+	int i, j, p, w0 = r >> 6;
+	uint64_t *row;
+
+	for (j = r; j < r + np; j++)
+	{
+		for (i = j; i < nrows; i++)
+		{
+			row = m + (size_t) i * stride;
+
+			/* clear the earlier pivot columns of this pass */
+			for (p = r; p < j; p++)
+				if (bit(row, p))
+					add_row(row, m + (size_t) p * stride, w0, nwords);
+
+			if (bit(row, j))
+				break;
+		}
+
+		if (i == nrows)
+			return -1;
+
+		if (i != j)
+			swap_rows(m + (size_t) i * stride, m + (size_t) j * stride, w0, nwords);
+
+		row = m + (size_t) j * stride;
+
+		for (p = r; p < j; p++)
+			if (bit(m + (size_t) p * stride, j))
+				add_row(m + (size_t) p * stride, row, w0, nwords);
+	}
+
+	return 0;
+}
+
+/* input: a pass with its table indices */
+/* output: words w0 .. w1-1 of the rows outside the pivot block reduced */
+static void m4r_reduce(m4r_pass *a)
+{
+	int b, i, t, g, h, k, nt, n, w, wb;
+
+	uint64_t *tab, *row;
+	const uint64_t *piv, *u[ M4R_TABLES ];
+
+	nt = (a->np + M4R_K - 1) / M4R_K;
+
+	for (wb = a->w0; wb < a->w1; wb += M4R_BLOCK)
+	{
+		n = (a->w1 - wb < M4R_BLOCK) ? a->w1 - wb : M4R_BLOCK;
+
+		/* Gray-code tables: entry g is the sum of the pivot rows */
+		/* of group t for the bits of g; each is one row addition */
+
+		for (t = 0; t < nt; t++)
+		{
+			k = (a->np - t*M4R_K < M4R_K) ? a->np - t*M4R_K : M4R_K;
+			tab = a->tab + (size_t) t * (M4R_BLOCK << M4R_K);
+
+			memset(tab, 0, n * sizeof(uint64_t));
+
+			for (i = 1; i < (1 << k); i++)
+			{
+				g = i ^ (i >> 1);
+				h = (i - 1) ^ ((i - 1) >> 1);
+				b = __builtin_ctz(g ^ h);
+				piv = a->m + (size_t) (a->r + t*M4R_K + b) * a->stride + wb;
+
+				for (w = 0; w < n; w++)
+					tab[g*M4R_BLOCK + w] = tab[h*M4R_BLOCK + w] ^ piv[w];
+			}
+		}
+
+		for (i = 0; i < a->nrows; i++)
+		{
+			if (i == a->r)
+			{
+				i += a->np - 1;
+				continue;
+			}
+
+			row = a->m + (size_t) i * a->stride + wb;
+
+			for (t = 0; t < nt; t++)
+				u[t] = a->tab + (size_t) t * (M4R_BLOCK << M4R_K) + a->idx[i*M4R_TABLES + t] * M4R_BLOCK;
+
+			for (w = 0; w < n; w++)
+				for (t = 0; t < nt; t++)
+					row[w] ^= u[t][w];
+		}
+	}
+}
+
+#if M4R_THREADS > 1
+static void *m4r_thread(void *arg)
+{
+	m4r_reduce((m4r_pass *) arg);
+
+	return NULL;
+}
+#endif
+
+/* input: m, nrows rows of nwords words, stride words apart */
+/* output: m in reduced row echelon form, with an identity matrix in the */
+/*         first nrows columns */
+/* return: 0 for success; -1 if the first nrows columns are singular, */
+/*         or if out of memory */
+int m4r_systematic(uint64_t *m, int nrows, int nwords, int stride)
+{
+	int i, t, r, np, nb, ret = 0;
+
+	m4r_pass a[ M4R_THREADS ];
+
+#if M4R_THREADS > 1
+	pthread_t thr[ M4R_THREADS ];
+#endif
+
+	uint8_t *idx;
+	uint64_t *tab;
+
+	idx = malloc((size_t) nrows * M4R_TABLES);
+	tab = malloc((size_t) M4R_THREADS * M4R_TABLES * (M4R_BLOCK << M4R_K) * sizeof(uint64_t));
+
+	if (idx == NULL || tab == NULL)
+	{
+		free(idx);
+		free(tab);
+
+		return -1;
+	}
+
+	for (r = 0; r < nrows; r += np)
+	{
+		np = (nrows - r < M4R_PIVOTS) ? nrows - r : M4R_PIVOTS;
+
+		if (m4r_pivots(m, nrows, nwords, stride, r, np) != 0)
+		{
+			ret = -1;
+			break;
+		}
+
+		for (i = 0; i < nrows; i++)
+			for (t = 0; t*M4R_K < np; t++)
+				idx[i*M4R_TABLES + t] = bits(m + (size_t) i * stride, r + t*M4R_K,
+				                             (np - t*M4R_K < M4R_K) ? np - t*M4R_K : M4R_K);
+
+		/* columns before r are zero outside the identity, and so are */
+		/* those of the pivot rows; the column blocks go to the threads */
+
+		nb = (nwords - (r >> 6) + M4R_BLOCK - 1) / M4R_BLOCK;
+
+		for (t = 0; t < M4R_THREADS; t++)
+		{
+			a[t].m = m;
+			a[t].nrows = nrows;
+			a[t].stride = stride;
+			a[t].r = r;
+			a[t].np = np;
+			a[t].w0 = (r >> 6) + (nb * t / M4R_THREADS) * M4R_BLOCK;
+			a[t].w1 = (r >> 6) + (nb * (t+1) / M4R_THREADS) * M4R_BLOCK;
+			a[t].idx = idx;
+			a[t].tab = tab + (size_t) t * M4R_TABLES * (M4R_BLOCK << M4R_K);
+
+			if (a[t].w1 > nwords)
+				a[t].w1 = nwords;
+		}
+
+#if M4R_THREADS > 1
+		for (t = 1; t < M4R_THREADS; t++)
+			if (pthread_create(&thr[t], NULL, m4r_thread, &a[t]) != 0)
+				m4r_reduce(&a[t]);
+
+		m4r_reduce(&a[0]);
+
+		for (t = 1; t < M4R_THREADS; t++)
+			pthread_join(thr[t], NULL);
+#else
+		m4r_reduce(&a[0]);
+#endif
+	}
+
+	free(idx);
+	free(tab);
+
+	return ret;
+}
+
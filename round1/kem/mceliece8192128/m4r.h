@@ -0,0 +1,29 @@
+/*
+  This file is for Gaussian elimination over GF(2) with the Method of
+  Four Russians, on 64-bit words
+*/
+
+#ifndef M4R_H
+#define M4R_H
+
+#include <stdint.h>
+
+/* pivots per Gray-code table */
+#define M4R_K 8
+
+/* tables, M4R_K pivots each, per pass over the matrix */
+#define M4R_TABLES 4
+
+/* words per column block of the row reduction; the tables of */
+/* one block take M4R_TABLES * 2^M4R_K * M4R_BLOCK * 8 bytes */
+#define M4R_BLOCK 16
+
+/* threads for the row reduction; 1 for none */
+#ifndef M4R_THREADS
+#define M4R_THREADS 1
+#endif
+
+int m4r_systematic(uint64_t *, int, int, int);
+
+#endif
+
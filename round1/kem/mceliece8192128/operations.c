@@ -1,4 +1,5 @@
 #include "operations.h"
+#include "api.h"
 
 #include "crypto_hash.h"
 
@@ -13,10 +14,12 @@
 #include <string.h>
 #include <stdlib.h>
 
-int crypto_kem_enc(
+/* encapsulation with encrypt() or encrypt_expanded() */
+static int kem_enc(
        unsigned char *c,
        unsigned char *key,
-       const unsigned char *pk
+       const unsigned char *pk,
+       void (*enc)(unsigned char *, const unsigned char *, unsigned char *)
 )
 {
 	unsigned char two_e[ 1 + SYS_N/8 ] = {2};
@@ -25,7 +28,7 @@ int crypto_kem_enc(
 
 	//
 
-	encrypt(c, pk, e);
+	enc(c, pk, e);
 
 	crypto_hash_32b(c + SYND_BYTES, two_e, sizeof(two_e)); 
 
@@ -37,6 +40,15 @@ int crypto_kem_enc(
 	return 0;
 }
 
+int crypto_kem_enc(
+       unsigned char *c,
+       unsigned char *key,
+       const unsigned char *pk
+)
+{
+	return kem_enc(c, key, pk, encrypt);
+}
+
 int crypto_kem_dec(
        unsigned char *key,
        const unsigned char *c,
@@ -99,3 +111,33 @@ int crypto_kem_keypair
 	return 0;
 }
 
+/* the expanded public key is the rows of pk, PK_ROW_STRIDE bytes apart */
+/* so that each one starts on a cache line (pk_expand()); */
+/* the secret key is used as it is */
+
+_Static_assert(CRYPTO_EXPANDEDPKBYTES == PK_NROWS * PK_ROW_STRIDE, "CRYPTO_EXPANDEDPKBYTES");
+
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+	pk_expand(epk, pk);
+
+	return 0;
+}
+
+int crypto_kem_enc_expanded(unsigned char *c, unsigned char *key, const unsigned char *epk)
+{
+	return kem_enc(c, key, epk, encrypt_expanded);
+}
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
+{
+	memcpy(esk, sk, CRYPTO_SECRETKEYBYTES);
+
+	return 0;
+}
+
+int crypto_kem_dec_expanded(unsigned char *key, const unsigned char *c, const unsigned char *esk)
+{
+	return crypto_kem_dec(key, c, esk);
+}
+
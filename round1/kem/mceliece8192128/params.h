@@ -11,6 +11,7 @@
 #define PK_NROWS (SYS_T*GFBITS) 
 #define PK_NCOLS (SYS_N - PK_NROWS)
 #define PK_ROW_BYTES ((PK_NCOLS + 7)/8)
+#define PK_ROW_STRIDE (((PK_ROW_BYTES + 63)/64)*64)
 
 #define SK_BYTES (SYS_N/8 + IRR_BYTES + COND_BYTES)
 #define SYND_BYTES ((PK_NROWS + 7)/8)
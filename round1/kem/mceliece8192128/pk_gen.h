@@ -8,6 +8,7 @@
 #include "gf.h"
 
 int pk_gen(unsigned char *, unsigned char *);
+int pk_gen_ref(unsigned char *, unsigned char *);
 
 #endif
 
@@ -4,6 +4,9 @@
 
 #include "params.h"
 #include "gf.h"
+#include "fft.h"
+#include "benes.h"
+#include "util.h"
 
 #include <stdio.h>
 
@@ -35,3 +38,31 @@ void root(gf *out, gf *f, gf *L)
 		out[i] = eval(f, L[i]);
 }
 
+/* input: polynomial f and condition bits of the Benes network */
+/* output: out, bit i set if f(L[i]) = 0, for the support L of support_gen() */
+void root_fft(unsigned char *out, gf *f, const unsigned char *cond)
+{
+	int i, j;
+
+	vec v[ FFT_WORDS ][ GFBITS ];
+	vec t;
+
+	unsigned char z[ (1 << GFBITS)/8 ];
+
+	fft(v, f);
+
+	for (i = 0; i < FFT_WORDS; i++)
+	{
+		t = 0;
+		for (j = 0; j < GFBITS; j++)
+			t |= v[i][j];
+
+		store8(z + i*8, ~t);
+	}
+
+	apply_benes(z, cond, 0);
+
+	for (i = 0; i < SYS_N/8; i++)
+		out[i] = z[i];
+}
+
@@ -37,20 +37,48 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
   return 0;
 }
 
+/* Expanded public key: everything crypto_kem_enc needs from pk */
+typedef struct {
+  cpapke_epk ipk;
+  unsigned char hpk[NEWHOPE_SYMBYTES];                                                        /* H(pk) */
+} kem_epk;
+
+_Static_assert(sizeof(kem_epk) == CRYPTO_EXPANDEDPKBYTES, "CRYPTO_EXPANDEDPKBYTES");
+
 /*************************************************
-* Name:        crypto_kem_enc
+* Name:        crypto_kem_expand_pk
 *
-* Description: Generates cipher text and shared
-*              secret for given public key
+* Description: Expands a public key for crypto_kem_enc_expanded
 *
-* Arguments:   - unsigned char *ct:       pointer to output cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
-*              - unsigned char *ss:       pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+* Arguments:   - unsigned char *epk:      pointer to output expanded public key (an already allocated array of CRYPTO_EXPANDEDPKBYTES bytes)
 *              - const unsigned char *pk: pointer to input public key (an already allocated array of CRYPTO_PUBLICKEYBYTES bytes)
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+  kem_epk *e = (kem_epk *) epk;
+
+  cpapke_expand_pk(&e->ipk, pk);
+  shake256(e->hpk, NEWHOPE_SYMBYTES, pk, NEWHOPE_CCAKEM_PUBLICKEYBYTES);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_kem_enc_expanded
+*
+* Description: Generates cipher text and shared
+*              secret for given expanded public key
+*
+* Arguments:   - unsigned char *ct:        pointer to output cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - unsigned char *ss:        pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *epk: pointer to input expanded public key (from crypto_kem_expand_pk)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk)
 {
+  const kem_epk *e = (const kem_epk *) epk;
   unsigned char k_coins_d[3*NEWHOPE_SYMBYTES];                                                /* Will contain key, coins, qrom-hash */
   unsigned char buf[2*NEWHOPE_SYMBYTES];
   int i;
@@ -58,10 +86,11 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
   randombytes(buf,NEWHOPE_SYMBYTES);
 
   shake256(buf,NEWHOPE_SYMBYTES,buf,NEWHOPE_SYMBYTES);                                        /* Don't release system RNG output */
-  shake256(buf+NEWHOPE_SYMBYTES, NEWHOPE_SYMBYTES, pk, NEWHOPE_CCAKEM_PUBLICKEYBYTES);        /* Multitarget countermeasure for coins + contributory KEM */
+  for(i=0;i<NEWHOPE_SYMBYTES;i++)                                                             /* Multitarget countermeasure for coins + contributory KEM */
+    buf[NEWHOPE_SYMBYTES+i] = e->hpk[i];
   shake256(k_coins_d, 3*NEWHOPE_SYMBYTES, buf, 2*NEWHOPE_SYMBYTES);
 
-  cpapke_enc(ct, buf, pk, k_coins_d+NEWHOPE_SYMBYTES);                                        /* coins are in k_coins_d+NEWHOPE_SYMBYTES */
+  cpapke_enc_expanded(ct, buf, &e->ipk, k_coins_d+NEWHOPE_SYMBYTES);                          /* coins are in k_coins_d+NEWHOPE_SYMBYTES */
 
   for(i=0;i<NEWHOPE_SYMBYTES;i++)
     ct[i+NEWHOPE_CPAPKE_CIPHERTEXTBYTES] = k_coins_d[i+2*NEWHOPE_SYMBYTES];                   /* copy Targhi-Unruh hash into ct */
@@ -72,34 +101,87 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
 }
 
 /*************************************************
-* Name:        crypto_kem_dec
+* Name:        crypto_kem_enc
 *
-* Description: Generates shared secret for given
-*              cipher text and private key
+* Description: Generates cipher text and shared
+*              secret for given public key
 *
-* Arguments:   - unsigned char *ss:       pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
-*              - const unsigned char *ct: pointer to input cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+* Arguments:   - unsigned char *ct:       pointer to output cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - unsigned char *ss:       pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *pk: pointer to input public key (an already allocated array of CRYPTO_PUBLICKEYBYTES bytes)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
+{
+  kem_epk epk;
+
+  crypto_kem_expand_pk((unsigned char *) &epk, pk);
+  return crypto_kem_enc_expanded(ct, ss, (unsigned char *) &epk);
+}
+
+/* Expanded private key: s, the expanded pk for re-encryption, and z */
+typedef struct {
+  cpapke_esk isk;
+  kem_epk epk;
+  unsigned char z[NEWHOPE_SYMBYTES];                                                          /* pseudo-random output on reject */
+} kem_esk;
+
+_Static_assert(sizeof(kem_esk) == CRYPTO_EXPANDEDSKBYTES, "CRYPTO_EXPANDEDSKBYTES");
+
+/*************************************************
+* Name:        crypto_kem_expand_sk
+*
+* Description: Expands a private key for crypto_kem_dec_expanded
+*
+* Arguments:   - unsigned char *esk:      pointer to output expanded private key (an already allocated array of CRYPTO_EXPANDEDSKBYTES bytes)
 *              - const unsigned char *sk: pointer to input private key (an already allocated array of CRYPTO_SECRETKEYBYTES bytes)
 *
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
+{
+  kem_esk *e = (kem_esk *) esk;
+  int i;
+
+  cpapke_expand_sk(&e->isk, sk);
+  cpapke_expand_pk(&e->epk.ipk, sk+NEWHOPE_CPAPKE_SECRETKEYBYTES);
+  for(i=0;i<NEWHOPE_SYMBYTES;i++) {                                                           /* H(pk) and z are stored in sk */
+    e->epk.hpk[i] = sk[NEWHOPE_CCAKEM_SECRETKEYBYTES-2*NEWHOPE_SYMBYTES+i];
+    e->z[i] = sk[NEWHOPE_CCAKEM_SECRETKEYBYTES-NEWHOPE_SYMBYTES+i];
+  }
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_kem_dec_expanded
+*
+* Description: Generates shared secret for given
+*              cipher text and expanded private key
+*
+* Arguments:   - unsigned char *ss:        pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *ct:  pointer to input cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - const unsigned char *esk: pointer to input expanded private key (from crypto_kem_expand_sk)
+*
 * Returns 0 for sucess or -1 for failure
 *
 * On failure, ss will contain a randomized value.
 **************************************************/
-int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk)
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk)
 {
+  const kem_esk *e = (const kem_esk *) esk;
   int i, fail;
   unsigned char ct_cmp[NEWHOPE_CCAKEM_CIPHERTEXTBYTES];
   unsigned char buf[2*NEWHOPE_SYMBYTES];
   unsigned char k_coins_d[3*NEWHOPE_SYMBYTES];                                                /* Will contain key, coins, qrom-hash */
-  const unsigned char *pk = sk+NEWHOPE_CPAPKE_SECRETKEYBYTES;
 
-  cpapke_dec(buf, ct, sk);
+  cpapke_dec_expanded(buf, ct, &e->isk);
 
   for(i=0;i<NEWHOPE_SYMBYTES;i++)                                                             /* Use hash of pk stored in sk */
-    buf[NEWHOPE_SYMBYTES+i] = sk[NEWHOPE_CCAKEM_SECRETKEYBYTES-2*NEWHOPE_SYMBYTES+i];
+    buf[NEWHOPE_SYMBYTES+i] = e->epk.hpk[i];
   shake256(k_coins_d, 3*NEWHOPE_SYMBYTES, buf, 2*NEWHOPE_SYMBYTES);
 
-  cpapke_enc(ct_cmp, buf, pk, k_coins_d+NEWHOPE_SYMBYTES);                                    /* coins are in k_coins_d+NEWHOPE_SYMBYTES */
+  cpapke_enc_expanded(ct_cmp, buf, &e->epk.ipk, k_coins_d+NEWHOPE_SYMBYTES);                  /* coins are in k_coins_d+NEWHOPE_SYMBYTES */
 
   for(i=0;i<NEWHOPE_SYMBYTES;i++)
     ct_cmp[i+NEWHOPE_CPAPKE_CIPHERTEXTBYTES] = k_coins_d[i+2*NEWHOPE_SYMBYTES];
@@ -107,8 +189,30 @@ int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned ch
   fail = verify(ct, ct_cmp, NEWHOPE_CCAKEM_CIPHERTEXTBYTES);
 
   shake256(k_coins_d+NEWHOPE_SYMBYTES, NEWHOPE_SYMBYTES, ct, NEWHOPE_CCAKEM_CIPHERTEXTBYTES); /* overwrite coins in k_coins_d with h(c)  */
-  cmov(k_coins_d, sk+NEWHOPE_CCAKEM_SECRETKEYBYTES-NEWHOPE_SYMBYTES, NEWHOPE_SYMBYTES, fail); /* Overwrite pre-k with z on re-encryption failure */
+  cmov(k_coins_d, e->z, NEWHOPE_SYMBYTES, fail);                                              /* Overwrite pre-k with z on re-encryption failure */
   shake256(ss, NEWHOPE_SYMBYTES, k_coins_d, 2*NEWHOPE_SYMBYTES);                              /* hash concatenation of pre-k and h(c) to k */
 
   return -fail;
 }
+
+/*************************************************
+* Name:        crypto_kem_dec
+*
+* Description: Generates shared secret for given
+*              cipher text and private key
+*
+* Arguments:   - unsigned char *ss:       pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *ct: pointer to input cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - const unsigned char *sk: pointer to input private key (an already allocated array of CRYPTO_SECRETKEYBYTES bytes)
+*
+* Returns 0 for sucess or -1 for failure
+*
+* On failure, ss will contain a randomized value.
+**************************************************/
+int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk)
+{
+  kem_esk esk;
+
+  crypto_kem_expand_sk((unsigned char *) &esk, sk);
+  return crypto_kem_dec_expanded(ss, ct, (unsigned char *) &esk);
+}
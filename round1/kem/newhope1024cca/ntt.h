@@ -3,6 +3,10 @@
 
 #include "inttypes.h"
 
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(NEWHOPE_NTT_REF)
+#define NTT_AVX2
+#endif
+
 extern uint16_t omegas_bitrev_montgomery[];
 extern uint16_t omegas_inv_bitrev_montgomery[];
 
@@ -13,4 +17,16 @@ void bitrev_vector(uint16_t* poly);
 void mul_coefficients(uint16_t* poly, const uint16_t* factors);
 void ntt(uint16_t* poly, const uint16_t* omegas);
 
+void ntt_forward(uint16_t* poly);
+void ntt_inverse(uint16_t* poly);
+void ntt_forward_ref(uint16_t* poly);
+void ntt_inverse_ref(uint16_t* poly);
+const char *ntt_impl(void);
+
+#ifdef NTT_AVX2
+int ntt_avx2_init(void);
+void ntt_forward_avx2(uint16_t* poly);
+void ntt_inverse_avx2(uint16_t* poly);
+#endif
+
 #endif
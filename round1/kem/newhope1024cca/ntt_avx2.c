@@ -0,0 +1,336 @@
+#include <stdint.h>
+#include "params.h"
+#include "ntt.h"
+#include "poly.h"
+
+#ifdef NTT_AVX2
+#include <immintrin.h>
+
+/* The scalar code keeps unsigned coefficients with Montgomery factor 2^18.
+ * Here sixteen coefficients are held as signed 16-bit lanes and multiplied
+ * with Montgomery factor 2^16: mm_montmul(a, w) = a * w / 2^16 mod q, in
+ * (-q, q) for any a and a twiddle w in [-q/2, q/2]. Sums are Barrett
+ * reduced to [0, q] on every level and outputs are frozen to [0, q).
+ * Inputs may be any 16-bit value (poly_uniform leaves them below 5q). */
+
+#define NTT_TARGET __attribute__ ((target("avx2")))
+
+#define NTT_QINV -12287         /* q^-1 mod 2^16 */
+#define NTT_V 5461              /* round(2^26 / q) */
+
+#if (NEWHOPE_N == 512)
+#define NTT_LEVELS 9
+#elif (NEWHOPE_N == 1024)
+#define NTT_LEVELS 10
+#else
+#error "NEWHOPE_N must be either 512 or 1024"
+#endif
+
+/* Twiddles from the scalar tables, divided by 4 and centered, each with
+ * its product by q^-1 mod 2^16 for the low half of the Montgomery step.
+ * The polynomial is a matrix of 16 columns. Levels 0..3 run on transposed
+ * 16 x 16 blocks with one twiddle per lane (2^(3-l) vectors for level l
+ * in each block), higher levels pair rows with a broadcast twiddle. */
+typedef struct {
+  int16_t vw[NEWHOPE_N/256][15][16];
+  int16_t vwq[NEWHOPE_N/256][15][16];
+  int16_t bw[NEWHOPE_N/32], bwq[NEWHOPE_N/32];
+  int16_t pw[NEWHOPE_N], pwq[NEWHOPE_N];    /* psi powers */
+} ntt_avx2_tab;
+
+static ntt_avx2_tab ntt_fwd_tab __attribute__ ((aligned (32)));
+static ntt_avx2_tab ntt_inv_tab __attribute__ ((aligned (32)));
+static int16_t ntt_c32, ntt_c32q;       /* 2^32 mod q, for pointwise */
+static int ntt_avx2_ready = 0;          /* 1: tables set, -1: no AVX2; set before main() */
+
+/* w = x mod q, centered, and wq = w * q^-1 mod 2^16 */
+static void ntt_twiddle(int16_t *w, int16_t *wq, uint32_t x)
+{
+  int32_t c = x % NEWHOPE_Q;
+
+  if(c > NEWHOPE_Q / 2)
+    c -= NEWHOPE_Q;
+  *w = (int16_t) c;
+  *wq = (int16_t) (uint16_t) ((uint32_t) c * (uint32_t) NTT_QINV);
+}
+
+/* Twiddle with Montgomery factor 2^18 to factor 2^16 */
+static void ntt_twiddle18(int16_t *w, int16_t *wq, uint16_t x)
+{
+  ntt_twiddle(w, wq, (uint32_t) x * (NEWHOPE_Q - (NEWHOPE_Q - 1) / 4));
+}
+
+static void ntt_avx2_tab_init(ntt_avx2_tab *tab, const uint16_t *omega, const uint16_t *psi)
+{
+  int i, b, l, m, v, r;
+
+  for(b = 0; b < NEWHOPE_N/256; b++)
+    for(l = 0; l < 4; l++)
+      for(m = 0; m < (1 << (3-l)); m++)
+      {
+        v = (1 << (3-l)) - 1 + m;
+        for(r = 0; r < 16; r++)
+          ntt_twiddle18(&tab->vw[b][v][r], &tab->vwq[b][v][r],
+            omega[(b << (7-l)) + (r << (3-l)) + m]);
+      }
+  for(i = 0; i < NEWHOPE_N/32; i++)
+    ntt_twiddle18(&tab->bw[i], &tab->bwq[i], omega[i]);
+  for(i = 0; i < NEWHOPE_N; i++)
+    ntt_twiddle18(&tab->pw[i], &tab->pwq[i], psi[i]);
+}
+
+/*************************************************
+* Name:        ntt_avx2_setup
+*
+* Description: Checks for AVX2 and builds the AVX2 tables once, before
+*              main()
+**************************************************/
+__attribute__ ((constructor)) static void ntt_avx2_setup(void)
+{
+  __builtin_cpu_init();
+  if(!__builtin_cpu_supports("avx2"))
+    ntt_avx2_ready = -1;
+  else
+  {
+    ntt_avx2_tab_init(&ntt_fwd_tab, omegas_bitrev_montgomery, psis_bitrev_montgomery);
+    ntt_avx2_tab_init(&ntt_inv_tab, omegas_inv_bitrev_montgomery, psis_inv_montgomery);
+    ntt_twiddle(&ntt_c32, &ntt_c32q, (uint32_t) ((1ULL << 32) % NEWHOPE_Q));
+    ntt_avx2_ready = 1;
+  }
+}
+
+/*************************************************
+* Name:        ntt_avx2_init
+*
+* Returns nonzero if the AVX2 code can be used
+**************************************************/
+int ntt_avx2_init(void)
+{
+  return ntt_avx2_ready > 0;
+}
+
+/* a * w / 2^16 mod q, in (-q, q) */
+static inline NTT_TARGET __m256i mm_montmul(__m256i a, __m256i w, __m256i wq)
+{
+  __m256i t;
+
+  t = _mm256_mullo_epi16(a, wq);
+  t = _mm256_mulhi_epi16(t, _mm256_set1_epi16(NEWHOPE_Q));
+  return _mm256_sub_epi16(_mm256_mulhi_epi16(a, w), t);
+}
+
+/* a mod q in [0, q] */
+static inline NTT_TARGET __m256i mm_barrett(__m256i a)
+{
+  __m256i t;
+
+  t = _mm256_mulhi_epi16(a, _mm256_set1_epi16(NTT_V));
+  t = _mm256_srai_epi16(t, 10);
+  t = _mm256_mullo_epi16(t, _mm256_set1_epi16(NEWHOPE_Q));
+  return _mm256_sub_epi16(a, t);
+}
+
+/* a mod q in [-1, q] for unsigned a */
+static inline NTT_TARGET __m256i mm_barrett_u(__m256i a)
+{
+  __m256i t;
+
+  t = _mm256_mulhi_epu16(a, _mm256_set1_epi16(NTT_V));
+  t = _mm256_srli_epi16(t, 10);
+  t = _mm256_mullo_epi16(t, _mm256_set1_epi16(NEWHOPE_Q));
+  return _mm256_sub_epi16(a, t);
+}
+
+/* a mod q in [0, q) */
+static inline NTT_TARGET __m256i mm_freeze(__m256i a)
+{
+  const __m256i q = _mm256_set1_epi16(NEWHOPE_Q);
+
+  a = _mm256_sub_epi16(mm_barrett(a), q);
+  return _mm256_add_epi16(a, _mm256_and_si256(_mm256_srai_epi16(a, 15), q));
+}
+
+/* In-place transpose of a 16 x 16 matrix of 16-bit words */
+static inline NTT_TARGET void mm_transpose16(__m256i r[16])
+{
+  __m256i a[16], b[16];
+  int k, m;
+
+  for(k = 0; k < 8; k++)
+  {
+    a[2*k] = _mm256_unpacklo_epi16(r[2*k], r[2*k+1]);
+    a[2*k+1] = _mm256_unpackhi_epi16(r[2*k], r[2*k+1]);
+  }
+  for(k = 0; k < 4; k++)
+  {
+    b[4*k] = _mm256_unpacklo_epi32(a[4*k], a[4*k+2]);
+    b[4*k+1] = _mm256_unpackhi_epi32(a[4*k], a[4*k+2]);
+    b[4*k+2] = _mm256_unpacklo_epi32(a[4*k+1], a[4*k+3]);
+    b[4*k+3] = _mm256_unpackhi_epi32(a[4*k+1], a[4*k+3]);
+  }
+  for(k = 0; k < 2; k++)
+  {
+    for(m = 0; m < 4; m++)
+    {
+      a[8*k+2*m] = _mm256_unpacklo_epi64(b[8*k+m], b[8*k+4+m]);
+      a[8*k+2*m+1] = _mm256_unpackhi_epi64(b[8*k+m], b[8*k+4+m]);
+    }
+  }
+  for(m = 0; m < 8; m++)
+  {
+    r[m] = _mm256_permute2x128_si256(a[m], a[8+m], 0x20);
+    r[m+8] = _mm256_permute2x128_si256(a[m], a[8+m], 0x31);
+  }
+}
+
+/* Gentleman-Sande butterflies as ntt() in ntt.c. With fwd, the input is
+ * first multiplied by the psi powers; otherwise the output is. */
+static inline NTT_TARGET void ntt_gs_avx2(uint16_t *a, const ntt_avx2_tab *tab, int fwd)
+{
+  __m256i r[16], w, wq, t, u;
+  int b, i, j, k, d, l;
+
+  /* levels 0..7 on blocks of 16 rows */
+  for(b = 0; b < NEWHOPE_N/256; b++)
+  {
+    for(i = 0; i < 16; i++)
+    {
+      t = mm_barrett_u(_mm256_loadu_si256((const __m256i *) &a[256*b + 16*i]));
+      if(fwd)
+        r[i] = mm_montmul(t,
+          _mm256_load_si256((const __m256i *) &tab->pw[256*b + 16*i]),
+          _mm256_load_si256((const __m256i *) &tab->pwq[256*b + 16*i]));
+      else
+        r[i] = t;
+    }
+
+    mm_transpose16(r);
+    for(l = 0; l < 4; l++)
+    {
+      d = 1 << l;
+      for(i = 0; i < 16; i += 2*d)
+      {
+        k = (1 << (3-l)) - 1 + (i >> (l+1));
+        w = _mm256_load_si256((const __m256i *) tab->vw[b][k]);
+        wq = _mm256_load_si256((const __m256i *) tab->vwq[b][k]);
+        for(j = i; j < i + d; j++)
+        {
+          t = r[j];
+          r[j] = mm_barrett(_mm256_add_epi16(t, r[j+d]));
+          r[j+d] = mm_montmul(_mm256_sub_epi16(t, r[j+d]), w, wq);
+        }
+      }
+    }
+    mm_transpose16(r);
+
+    for(l = 4; l < 8; l++)
+    {
+      d = 1 << (l-4);
+      for(i = 0; i < 16; i += 2*d)
+      {
+        w = _mm256_set1_epi16(tab->bw[(16*b + i) >> (l-3)]);
+        wq = _mm256_set1_epi16(tab->bwq[(16*b + i) >> (l-3)]);
+        for(j = i; j < i + d; j++)
+        {
+          t = r[j];
+          r[j] = mm_barrett(_mm256_add_epi16(t, r[j+d]));
+          r[j+d] = mm_montmul(_mm256_sub_epi16(t, r[j+d]), w, wq);
+        }
+      }
+    }
+
+    for(i = 0; i < 16; i++)
+      _mm256_storeu_si256((__m256i *) &a[256*b + 16*i], r[i]);
+  }
+
+  /* levels 8.. between blocks; the last one also finishes the output */
+  for(l = 8; l < NTT_LEVELS; l++)
+  {
+    d = 1 << l;
+    for(i = 0; i < NEWHOPE_N; i += 2*d)
+    {
+      for(j = i; j < i + d; j += 16)
+      {
+        w = _mm256_set1_epi16(tab->bw[j >> (l+1)]);
+        wq = _mm256_set1_epi16(tab->bwq[j >> (l+1)]);
+        t = _mm256_loadu_si256((const __m256i *) &a[j]);
+        u = _mm256_loadu_si256((const __m256i *) &a[j+d]);
+        r[0] = mm_barrett(_mm256_add_epi16(t, u));
+        r[1] = mm_montmul(_mm256_sub_epi16(t, u), w, wq);
+        if(l == NTT_LEVELS - 1)
+        {
+          if(!fwd)
+          {
+            r[0] = mm_montmul(r[0],
+              _mm256_load_si256((const __m256i *) &tab->pw[j]),
+              _mm256_load_si256((const __m256i *) &tab->pwq[j]));
+            r[1] = mm_montmul(r[1],
+              _mm256_load_si256((const __m256i *) &tab->pw[j+d]),
+              _mm256_load_si256((const __m256i *) &tab->pwq[j+d]));
+          }
+          r[0] = mm_freeze(r[0]);
+          r[1] = mm_freeze(r[1]);
+        }
+        _mm256_storeu_si256((__m256i *) &a[j], r[0]);
+        _mm256_storeu_si256((__m256i *) &a[j+d], r[1]);
+      }
+    }
+  }
+}
+
+/*************************************************
+* Name:        ntt_forward_avx2
+*
+* Description: AVX2 version of ntt_forward_ref(); output is in [0, q)
+*
+* Arguments:   - uint16_t* poly: pointer to in/output polynomial
+**************************************************/
+NTT_TARGET void ntt_forward_avx2(uint16_t* poly)
+{
+  ntt_gs_avx2(poly, &ntt_fwd_tab, 1);
+}
+
+/*************************************************
+* Name:        ntt_inverse_avx2
+*
+* Description: AVX2 version of ntt_inverse_ref(); output is in [0, q).
+*              The bit-reversal permutation stays scalar.
+*
+* Arguments:   - uint16_t* poly: pointer to in/output polynomial
+**************************************************/
+NTT_TARGET void ntt_inverse_avx2(uint16_t* poly)
+{
+  bitrev_vector(poly);
+  ntt_gs_avx2(poly, &ntt_inv_tab, 0);
+}
+
+/*************************************************
+* Name:        poly_mul_pointwise_avx2
+*
+* Description: AVX2 version of poly_mul_pointwise_ref(); b is first
+*              scaled by 2^16 so that the second product comes out in
+*              the normal domain. Output is in [0, q).
+*
+* Arguments:   - poly *r:       pointer to output polynomial
+*              - const poly *a: pointer to first input polynomial
+*              - const poly *b: pointer to second input polynomial
+**************************************************/
+NTT_TARGET void poly_mul_pointwise_avx2(poly *r, const poly *a, const poly *b)
+{
+  const __m256i c = _mm256_set1_epi16(ntt_c32);
+  const __m256i cq = _mm256_set1_epi16(ntt_c32q);
+  const __m256i qinv = _mm256_set1_epi16(NTT_QINV);
+  __m256i t;
+  int i;
+
+  for(i = 0; i < NEWHOPE_N; i += 16)
+  {
+    t = mm_barrett_u(_mm256_loadu_si256((const __m256i *) &b->coeffs[i]));
+    t = mm_montmul(t, c, cq);
+    t = mm_montmul(mm_barrett_u(_mm256_loadu_si256((const __m256i *) &a->coeffs[i])),
+      t, _mm256_mullo_epi16(t, qinv));
+    _mm256_storeu_si256((__m256i *) &r->coeffs[i], mm_freeze(t));
+  }
+}
+
+#endif
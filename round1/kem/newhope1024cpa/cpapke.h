@@ -1,6 +1,19 @@
 #ifndef INDCPA_H
 #define INDCPA_H
 
+#include "poly.h"
+
+/* Public key with a expanded, for repeated encryption */
+typedef struct {
+  poly ahat;              /* a, NTT domain */
+  poly bhat;              /* b, NTT domain */
+} cpapke_epk;
+
+/* Secret key unpacked, for repeated decryption */
+typedef struct {
+  poly shat;              /* s, NTT domain */
+} cpapke_esk;
+
 void cpapke_keypair(unsigned char *pk, 
                     unsigned char *sk);
 
@@ -9,8 +22,23 @@ void cpapke_enc(unsigned char *c,
                const unsigned char *pk,
                const unsigned char *coins);
 
+void cpapke_expand_pk(cpapke_epk *epk,
+                      const unsigned char *pk);
+
+void cpapke_enc_expanded(unsigned char *c,
+                         const unsigned char *m,
+                         const cpapke_epk *epk,
+                         const unsigned char *coins);
+
 void cpapke_dec(unsigned char *m,
                const unsigned char *c,
                const unsigned char *sk);
 
+void cpapke_expand_sk(cpapke_esk *esk,
+                      const unsigned char *sk);
+
+void cpapke_dec_expanded(unsigned char *m,
+                         const unsigned char *c,
+                         const cpapke_esk *esk);
+
 #endif
@@ -25,6 +25,53 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
   return 0;
 }
 
+/* Expanded public key: everything crypto_kem_enc needs from pk */
+typedef cpapke_epk kem_epk;
+
+_Static_assert(sizeof(kem_epk) == CRYPTO_EXPANDEDPKBYTES, "CRYPTO_EXPANDEDPKBYTES");
+
+/*************************************************
+* Name:        crypto_kem_expand_pk
+*
+* Description: Expands a public key for crypto_kem_enc_expanded
+*
+* Arguments:   - unsigned char *epk:      pointer to output expanded public key (an already allocated array of CRYPTO_EXPANDEDPKBYTES bytes)
+*              - const unsigned char *pk: pointer to input public key (an already allocated array of CRYPTO_PUBLICKEYBYTES bytes)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+  cpapke_expand_pk((kem_epk *) epk, pk);
+  return 0;
+}
+
+/*************************************************
+* Name:        crypto_kem_enc_expanded
+*
+* Description: Generates cipher text and shared
+*              secret for given expanded public key
+*
+* Arguments:   - unsigned char *ct:        pointer to output cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - unsigned char *ss:        pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *epk: pointer to input expanded public key (from crypto_kem_expand_pk)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk)
+{
+  unsigned char buf[2*NEWHOPE_SYMBYTES];
+
+  randombytes(buf,NEWHOPE_SYMBYTES);
+
+  shake256(buf,2*NEWHOPE_SYMBYTES,buf,NEWHOPE_SYMBYTES);                         /* Don't release system RNG output */
+
+  cpapke_enc_expanded(ct, buf, (const kem_epk *) epk, buf+NEWHOPE_SYMBYTES);     /* coins are in buf+NEWHOPE_SYMBYTES */
+
+  shake256(ss, NEWHOPE_SYMBYTES, buf, NEWHOPE_SYMBYTES);                         /* hash pre-k to ss */
+  return 0;
+}
+
 /*************************************************
 * Name:        crypto_kem_enc
 *
@@ -39,18 +86,54 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
 **************************************************/
 int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
 {
-  unsigned char buf[2*NEWHOPE_SYMBYTES];
+  kem_epk epk;
 
-  randombytes(buf,NEWHOPE_SYMBYTES);
+  crypto_kem_expand_pk((unsigned char *) &epk, pk);
+  return crypto_kem_enc_expanded(ct, ss, (unsigned char *) &epk);
+}
 
-  shake256(buf,2*NEWHOPE_SYMBYTES,buf,NEWHOPE_SYMBYTES);                         /* Don't release system RNG output */
 
-  cpapke_enc(ct, buf, pk, buf+NEWHOPE_SYMBYTES);                                 /* coins are in buf+NEWHOPE_SYMBYTES */
+/* Expanded private key: s */
+typedef cpapke_esk kem_esk;
 
-  shake256(ss, NEWHOPE_SYMBYTES, buf, NEWHOPE_SYMBYTES);                         /* hash pre-k to ss */
+_Static_assert(sizeof(kem_esk) == CRYPTO_EXPANDEDSKBYTES, "CRYPTO_EXPANDEDSKBYTES");
+
+/*************************************************
+* Name:        crypto_kem_expand_sk
+*
+* Description: Expands a private key for crypto_kem_dec_expanded
+*
+* Arguments:   - unsigned char *esk:      pointer to output expanded private key (an already allocated array of CRYPTO_EXPANDEDSKBYTES bytes)
+*              - const unsigned char *sk: pointer to input private key (an already allocated array of CRYPTO_SECRETKEYBYTES bytes)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
+{
+  cpapke_expand_sk((kem_esk *) esk, sk);
   return 0;
 }
 
+/*************************************************
+* Name:        crypto_kem_dec_expanded
+*
+* Description: Generates shared secret for given
+*              cipher text and expanded private key
+*
+* Arguments:   - unsigned char *ss:        pointer to output shared secret (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *ct:  pointer to input cipher text (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - const unsigned char *esk: pointer to input expanded private key (from crypto_kem_expand_sk)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk)
+{
+  cpapke_dec_expanded(ss, ct, (const kem_esk *) esk);
+
+  shake256(ss, NEWHOPE_SYMBYTES, ss, NEWHOPE_SYMBYTES);                          /* hash pre-k to ss */
+
+  return 0;
+}
 
 /*************************************************
 * Name:        crypto_kem_dec
@@ -66,9 +149,8 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
 **************************************************/
 int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk)
 {
-  cpapke_dec(ss, ct, sk);
+  kem_esk esk;
 
-  shake256(ss, NEWHOPE_SYMBYTES, ss, NEWHOPE_SYMBYTES);                          /* hash pre-k to ss */
-
-  return 0;
+  crypto_kem_expand_sk((unsigned char *) &esk, sk);
+  return crypto_kem_dec_expanded(ss, ct, (unsigned char *) &esk);
 }
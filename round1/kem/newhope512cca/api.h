@@ -8,6 +8,11 @@
 #define CRYPTO_CIPHERTEXTBYTES NEWHOPE_CCAKEM_CIPHERTEXTBYTES
 #define CRYPTO_BYTES           NEWHOPE_SYMBYTES
 
+/* Expanded keys for kem_expand.h: a, b and H(pk); s, expanded pk and z */
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES (2*NEWHOPE_N*2 + NEWHOPE_SYMBYTES)
+#define CRYPTO_EXPANDEDSKBYTES (NEWHOPE_N*2 + CRYPTO_EXPANDEDPKBYTES + NEWHOPE_SYMBYTES)
+
 #if   (NEWHOPE_N == 512)
 #define CRYPTO_ALGNAME "NewHope512-CCAKEM"
 #elif (NEWHOPE_N == 1024)
@@ -22,4 +27,12 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
 
 int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk);
 
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk);
+
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss, const unsigned char *epk);
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk);
+
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct, const unsigned char *esk);
+
 #endif
@@ -319,7 +319,7 @@ void poly_sample(poly *r, const unsigned char *seed, unsigned char nonce)
 }
 
 /*************************************************
-* Name:        poly_pointwise
+* Name:        poly_mul_pointwise_ref
 * 
 * Description: Multiply two polynomials pointwise (i.e., coefficient-wise).
 *
@@ -327,7 +327,7 @@ void poly_sample(poly *r, const unsigned char *seed, unsigned char nonce)
 *              - const poly *a: pointer to first input polynomial
 *              - const poly *b: pointer to second input polynomial
 **************************************************/
-void poly_mul_pointwise(poly *r, const poly *a, const poly *b)
+void poly_mul_pointwise_ref(poly *r, const poly *a, const poly *b)
 {
   int i;
   uint16_t t;
@@ -338,6 +338,28 @@ void poly_mul_pointwise(poly *r, const poly *a, const poly *b)
   }
 }
 
+/*************************************************
+* Name:        poly_mul_pointwise
+* 
+* Description: Multiply two polynomials pointwise; poly_mul_pointwise_ref,
+*              or its AVX2 version when the CPU has it
+*
+* Arguments:   - poly *r:       pointer to output polynomial
+*              - const poly *a: pointer to first input polynomial
+*              - const poly *b: pointer to second input polynomial
+**************************************************/
+void poly_mul_pointwise(poly *r, const poly *a, const poly *b)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+  {
+    poly_mul_pointwise_avx2(r, a, b);
+    return;
+  }
+#endif
+  poly_mul_pointwise_ref(r, a, b);
+}
+
 /*************************************************
 * Name:        poly_add
 * 
@@ -381,8 +403,7 @@ void poly_sub(poly *r, const poly *a, const poly *b)
 **************************************************/
 void poly_ntt(poly *r)
 {
-  mul_coefficients(r->coeffs, psis_bitrev_montgomery);
-  ntt((uint16_t *)r->coeffs, omegas_bitrev_montgomery);
+  ntt_forward(r->coeffs);
 }
 
 /*************************************************
@@ -396,8 +417,6 @@ void poly_ntt(poly *r)
 **************************************************/
 void poly_invntt(poly *r)
 {
-  bitrev_vector(r->coeffs);
-  ntt((uint16_t *)r->coeffs, omegas_inv_bitrev_montgomery);
-  mul_coefficients(r->coeffs, psis_inv_montgomery);
+  ntt_inverse(r->coeffs);
 }
 
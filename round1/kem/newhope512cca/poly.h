@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "params.h"
+#include "ntt.h"
 
 /* 
  * Elements of R_q = Z_q[X]/(X^n + 1). Represents polynomial
@@ -19,6 +20,10 @@ void poly_add(poly *r, const poly *a, const poly *b);
 void poly_ntt(poly *r);
 void poly_invntt(poly *r);
 void poly_mul_pointwise(poly *r, const poly *a, const poly *b);
+void poly_mul_pointwise_ref(poly *r, const poly *a, const poly *b);
+#ifdef NTT_AVX2
+void poly_mul_pointwise_avx2(poly *r, const poly *a, const poly *b);
+#endif
 
 void poly_frombytes(poly *r, const unsigned char *a);
 void poly_tobytes(unsigned char *r, const poly *p);
@@ -2,4 +2,4 @@
 
 $CC $CFLAGS -o $XKEM_BIN -I. \
 	-I../../nist \
-	../../nist/rng.c $XKEM_SRC *.c -lcrypto
+	../../nist/rng.c ../../nist/keccakx.c ../../nist/kem_cache.c $XKEM_SRC *.c -lcrypto
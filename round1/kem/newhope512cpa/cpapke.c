@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include "api.h"
 #include "poly.h"
+#include "cpapke.h"
 #include "rng.h"
 #include "fips202.h"
 
@@ -123,7 +124,26 @@ void cpapke_keypair(unsigned char *pk,
 }
 
 /*************************************************
-* Name:        cpapke_enc
+* Name:        cpapke_expand_pk
+* 
+* Description: Decode the public key and expand the public
+*              polynomial a from its seed, for use with
+*              cpapke_enc_expanded
+*
+* Arguments:   - cpapke_epk *epk:         pointer to output expanded public key
+*              - const unsigned char *pk: pointer to input public key
+**************************************************/
+void cpapke_expand_pk(cpapke_epk *epk,
+                      const unsigned char *pk)
+{
+  unsigned char publicseed[NEWHOPE_SYMBYTES];
+
+  decode_pk(&epk->bhat, publicseed, pk);
+  gen_a(&epk->ahat, publicseed);
+}
+
+/*************************************************
+* Name:        cpapke_enc_expanded
 * 
 * Description: Encryption function of
 *              the CPA public-key encryption scheme underlying
@@ -131,23 +151,19 @@ void cpapke_keypair(unsigned char *pk,
 *
 * Arguments:   - unsigned char *c:          pointer to output ciphertext
 *              - const unsigned char *m:    pointer to input message (of length NEWHOPE_SYMBYTES bytes)
-*              - const unsigned char *pk:   pointer to input public key
+*              - const cpapke_epk *epk:     pointer to input expanded public key
 *              - const unsigned char *coin: pointer to input random coins used as seed
 *                                           to deterministically generate all randomness
 **************************************************/
-void cpapke_enc(unsigned char *c,
-                const unsigned char *m,
-                const unsigned char *pk,
-                const unsigned char *coin)
+void cpapke_enc_expanded(unsigned char *c,
+                         const unsigned char *m,
+                         const cpapke_epk *epk,
+                         const unsigned char *coin)
 {
-  poly sprime, eprime, vprime, ahat, bhat, eprimeprime, uhat, v;
-  unsigned char publicseed[NEWHOPE_SYMBYTES];
+  poly sprime, eprime, vprime, eprimeprime, uhat, v;
 
   poly_frommsg(&v, m);
 
-  decode_pk(&bhat, publicseed, pk);
-  gen_a(&ahat, publicseed);
-
   poly_sample(&sprime, coin, 0);
   poly_sample(&eprime, coin, 1);
   poly_sample(&eprimeprime, coin, 2);
@@ -155,10 +171,10 @@ void cpapke_enc(unsigned char *c,
   poly_ntt(&sprime);
   poly_ntt(&eprime);
 
-  poly_mul_pointwise(&uhat, &ahat, &sprime);
+  poly_mul_pointwise(&uhat, &epk->ahat, &sprime);
   poly_add(&uhat, &uhat, &eprime);
 
-  poly_mul_pointwise(&vprime, &bhat, &sprime);
+  poly_mul_pointwise(&vprime, &epk->bhat, &sprime);
   poly_invntt(&vprime);
 
   poly_add(&vprime, &vprime, &eprimeprime);
@@ -167,9 +183,48 @@ void cpapke_enc(unsigned char *c,
   encode_c(c, &uhat, &vprime);
 }
 
+/*************************************************
+* Name:        cpapke_enc
+* 
+* Description: Encryption function of
+*              the CPA public-key encryption scheme underlying
+*              the NewHope KEMs
+*
+* Arguments:   - unsigned char *c:          pointer to output ciphertext
+*              - const unsigned char *m:    pointer to input message (of length NEWHOPE_SYMBYTES bytes)
+*              - const unsigned char *pk:   pointer to input public key
+*              - const unsigned char *coin: pointer to input random coins used as seed
+*                                           to deterministically generate all randomness
+**************************************************/
+void cpapke_enc(unsigned char *c,
+                const unsigned char *m,
+                const unsigned char *pk,
+                const unsigned char *coin)
+{
+  cpapke_epk epk;
+
+  cpapke_expand_pk(&epk, pk);
+  cpapke_enc_expanded(c, m, &epk, coin);
+}
+
 
 /*************************************************
-* Name:        cpapke_dec
+* Name:        cpapke_expand_sk
+* 
+* Description: Decode the secret key for use with
+*              cpapke_dec_expanded
+*
+* Arguments:   - cpapke_esk *esk:         pointer to output expanded secret key
+*              - const unsigned char *sk: pointer to input secret key
+**************************************************/
+void cpapke_expand_sk(cpapke_esk *esk,
+                      const unsigned char *sk)
+{
+  poly_frombytes(&esk->shat, sk);
+}
+
+/*************************************************
+* Name:        cpapke_dec_expanded
 * 
 * Description: Decryption function of
 *              the CPA public-key encryption scheme underlying
@@ -177,21 +232,40 @@ void cpapke_enc(unsigned char *c,
 *
 * Arguments:   - unsigned char *m:        pointer to output decrypted message
 *              - const unsigned char *c:  pointer to input ciphertext
-*              - const unsigned char *sk: pointer to input secret key
+*              - const cpapke_esk *esk:   pointer to input expanded secret key
 **************************************************/
-void cpapke_dec(unsigned char *m,
-                const unsigned char *c,
-                const unsigned char *sk)
+void cpapke_dec_expanded(unsigned char *m,
+                         const unsigned char *c,
+                         const cpapke_esk *esk)
 {
-  poly vprime, uhat, tmp, shat;
-
-  poly_frombytes(&shat, sk);
+  poly vprime, uhat, tmp;
 
   decode_c(&uhat, &vprime, c);
-  poly_mul_pointwise(&tmp, &shat, &uhat);
+  poly_mul_pointwise(&tmp, &esk->shat, &uhat);
   poly_invntt(&tmp);
 
   poly_sub(&tmp, &tmp, &vprime);
 
   poly_tomsg(m, &tmp);
 }
+
+/*************************************************
+* Name:        cpapke_dec
+* 
+* Description: Decryption function of
+*              the CPA public-key encryption scheme underlying
+*              the NewHope KEMs
+*
+* Arguments:   - unsigned char *m:        pointer to output decrypted message
+*              - const unsigned char *c:  pointer to input ciphertext
+*              - const unsigned char *sk: pointer to input secret key
+**************************************************/
+void cpapke_dec(unsigned char *m,
+                const unsigned char *c,
+                const unsigned char *sk)
+{
+  cpapke_esk esk;
+
+  cpapke_expand_sk(&esk, sk);
+  cpapke_dec_expanded(m, c, &esk);
+}
@@ -222,3 +222,79 @@ ntt(uint16_t * a, const uint16_t* omega)
 #else
 #error "NEWHOPE_N must be either 512 or 1024"
 #endif
+
+/*************************************************
+* Name:        ntt_forward_ref
+* 
+* Description: Forward NTT of a polynomial in place, as used by poly_ntt;
+*              input in bitreversed order, output in normal order
+*
+* Arguments:   - uint16_t* poly: pointer to in/output polynomial
+**************************************************/
+void ntt_forward_ref(uint16_t* poly)
+{
+  mul_coefficients(poly, psis_bitrev_montgomery);
+  ntt(poly, omegas_bitrev_montgomery);
+}
+
+/*************************************************
+* Name:        ntt_inverse_ref
+* 
+* Description: Inverse NTT of a polynomial in place, as used by poly_invntt;
+*              input and output in normal order
+*
+* Arguments:   - uint16_t* poly: pointer to in/output polynomial
+**************************************************/
+void ntt_inverse_ref(uint16_t* poly)
+{
+  bitrev_vector(poly);
+  ntt(poly, omegas_inv_bitrev_montgomery);
+  mul_coefficients(poly, psis_inv_montgomery);
+}
+
+/*************************************************
+* Name:        ntt_forward, ntt_inverse
+* 
+* Description: ntt_forward_ref and ntt_inverse_ref, or their AVX2
+*              versions when the CPU has it (the output is then fully
+*              reduced, which the callers do not rely on)
+*
+* Arguments:   - uint16_t* poly: pointer to in/output polynomial
+**************************************************/
+void ntt_forward(uint16_t* poly)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+  {
+    ntt_forward_avx2(poly);
+    return;
+  }
+#endif
+  ntt_forward_ref(poly);
+}
+
+void ntt_inverse(uint16_t* poly)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+  {
+    ntt_inverse_avx2(poly);
+    return;
+  }
+#endif
+  ntt_inverse_ref(poly);
+}
+
+/*************************************************
+* Name:        ntt_impl
+* 
+* Description: Name of the selected implementation, "avx2" or "ref"
+**************************************************/
+const char *ntt_impl(void)
+{
+#ifdef NTT_AVX2
+  if(ntt_avx2_init())
+    return "avx2";
+#endif
+  return "ref";
+}
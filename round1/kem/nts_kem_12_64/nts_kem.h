@@ -14,6 +14,7 @@
 #define __NTS_KEM_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /**
  *  NTS data structure
@@ -102,4 +103,73 @@ int nts_kem_decapsulate(const uint8_t *sk,
                         const uint8_t *c_ast,
                         uint8_t *k_r);
 
+/**
+ *  NTS-KEM decapsulation context
+ *
+ *  @note
+ *  A private key loaded once for any number of decapsulations,
+ *  in the form that decapsulation uses it. It is only read by
+ *  nts_kem_decapsulate_ctx(), so one context may be shared by
+ *  several threads. It holds no pointers to allocated memory,
+ *  so it may also live in a caller's buffer of at least
+ *  nts_kem_decaps_size() bytes, 8-byte aligned.
+ **/
+typedef struct NTSKEM_decaps NTSKEM_decaps;
+
+/**
+ *  Return the size in bytes of an NTS-KEM decapsulation context
+ *
+ *  @return The size of NTSKEM_decaps in bytes
+ **/
+size_t nts_kem_decaps_size();
+
+/**
+ *  Load a private key into a caller-allocated decapsulation context
+ *
+ *  @param[out] ctx     The pointer to the decapsulation context
+ *  @param[in]  sk      The pointer to NTS-KEM private key
+ *  @param[in]  sk_size The size of the private key in bytes
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int nts_kem_decaps_init(NTSKEM_decaps *ctx,
+                        const uint8_t *sk,
+                        size_t sk_size);
+
+/**
+ *  Create a decapsulation context from a private key
+ *
+ *  @param[out] ctx     A pointer of the context created
+ *  @param[in]  sk      The pointer to NTS-KEM private key
+ *  @param[in]  sk_size The size of the private key in bytes
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int nts_kem_decaps_create(NTSKEM_decaps **ctx,
+                          const uint8_t *sk,
+                          size_t sk_size);
+
+/**
+ *  Release a decapsulation context created by nts_kem_decaps_create()
+ *
+ *  @param[in] ctx  The pointer to the decapsulation context
+ **/
+void nts_kem_decaps_release(NTSKEM_decaps *ctx);
+
+/**
+ *  NTS-KEM decapsulation with a loaded private key
+ *
+ *  @note
+ *  As nts_kem_decapsulate(), without loading the private key
+ *
+ *  @param[in]  ctx     The pointer to the decapsulation context
+ *  @param[in]  c_ast   The pointer to the NTS-KEM ciphertext
+ *  @param[out] k_r     The pointer to the encapsulated key
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int nts_kem_decapsulate_ctx(const NTSKEM_decaps *ctx,
+                            const uint8_t *c_ast,
+                            uint8_t *k_r);
+
 #endif /* __NTS_KEM_H */
@@ -20,6 +20,17 @@
 #define CRYPTO_PUBLICKEYBYTES   1419704
 #define CRYPTO_CIPHERTEXTBYTES  253
 
+/* Expanded keys for kem_expand.h: pk as it is; sk loaded into a */
+/* decapsulation context (NTSKEM_decaps, see nts_kem.h) */
+#define CRYPTO_KEM_EXPAND
+#define CRYPTO_EXPANDEDPKBYTES  CRYPTO_PUBLICKEYBYTES
+#define CRYPTO_EXPANDEDSKBYTES  23128
+
+/* each cache entry holds pk twice */
+#ifndef KEM_CACHE_WAYS
+#define KEM_CACHE_WAYS          2
+#endif
+
 /**
  *  Generate a key-pair
  *
@@ -78,4 +89,53 @@ int crypto_kem_dec(unsigned char *ss,
                    const unsigned char *ct,
                    const unsigned char *sk);
 
+/**
+ *  Expanded public key, which is a copy of the public key
+ *
+ *  @param[out] epk The pointer to the expanded public key
+ *  @param[in]  pk  The pointer to the public key
+ *  @return NTS_KEM_SUCCESS
+ **/
+int crypto_kem_expand_pk(unsigned char *epk,
+                         const unsigned char *pk);
+
+/**
+ *  Encapsulate to an expanded public key
+ *
+ *  @param[out] ct  The pointer to the ciphertext
+ *  @param[out] ss  The pointer to the shared secret
+ *  @param[in]  epk The pointer to the expanded public key
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int crypto_kem_enc_expanded(unsigned char *ct,
+                            unsigned char *ss,
+                            const unsigned char *epk);
+
+/**
+ *  Load a private key (`sk`) into a decapsulation context (`esk`)
+ *  of CRYPTO_EXPANDEDSKBYTES bytes, 8-byte aligned
+ *
+ *  @param[out] esk The pointer to the expanded private key
+ *  @param[in]  sk  The pointer to the private key
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int crypto_kem_expand_sk(unsigned char *esk,
+                         const unsigned char *sk);
+
+/**
+ *  Decapsulate with an expanded private key
+ *
+ *  @param[out] ss  The pointer to the shared secret
+ *  @param[in]  ct  The pointer to the ciphertext
+ *  @param[in]  esk The pointer to the expanded private key
+ *  @return NTS_KEM_SUCCESS on success, NTS_KEM_INVALID_CIPHERTEXT
+ *          if the ciphertext (`ct`) is invalid, or a negative code
+ *          for other errors {@see nts_kem_errors.h}
+ **/
+int crypto_kem_dec_expanded(unsigned char *ss,
+                            const unsigned char *ct,
+                            const unsigned char *esk);
+
 #endif /* __NTS_KEM_API_H */
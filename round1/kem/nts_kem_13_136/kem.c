@@ -46,3 +46,31 @@ int crypto_kem_dec(unsigned char *ss,
 {
     return nts_kem_decapsulate(sk, CRYPTO_SECRETKEYBYTES, ct, ss);
 }
+
+int crypto_kem_expand_pk(unsigned char *epk,
+                         const unsigned char *pk)
+{
+    memcpy(epk, pk, CRYPTO_PUBLICKEYBYTES);
+    
+    return NTS_KEM_SUCCESS;
+}
+
+int crypto_kem_enc_expanded(unsigned char *ct,
+                            unsigned char *ss,
+                            const unsigned char *epk)
+{
+    return nts_kem_encapsulate(epk, CRYPTO_PUBLICKEYBYTES, ct, ss);
+}
+
+int crypto_kem_expand_sk(unsigned char *esk,
+                         const unsigned char *sk)
+{
+    return nts_kem_decaps_init((NTSKEM_decaps *)esk, sk, CRYPTO_SECRETKEYBYTES);
+}
+
+int crypto_kem_dec_expanded(unsigned char *ss,
+                            const unsigned char *ct,
+                            const unsigned char *esk)
+{
+    return nts_kem_decapsulate_ctx((const NTSKEM_decaps *)esk, ct, ss);
+}
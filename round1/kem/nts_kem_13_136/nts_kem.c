@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include "api.h"
 #include "nts_kem.h"
 #include "ff.h"
 #include "bits.h"
@@ -47,6 +48,21 @@ static const int kNTSKEMKeysize = NTS_KEM_KEY_SIZE;
 #define bitslice_fft    bitslice_fft13_64
 #define vector_ff_or    vector_ff_or_64
 
+/**
+ *  Decapsulation context: the private key as decapsulation
+ *  uses it, with a and h already in bit-sliced form. The field
+ *  is kept by value, without its basis, so that the context
+ *  holds no pointers to allocated memory.
+ **/
+struct NTSKEM_decaps {
+    FF2m ff2m;
+    uint64_t a[ NTS_KEM_PARAM_BC_VEC ][ NTS_KEM_PARAM_M ];
+    uint64_t h[ NTS_KEM_PARAM_BC_VEC ][ NTS_KEM_PARAM_M ];
+    ff_unit p[ NTS_KEM_PARAM_N ];
+};
+
+_Static_assert(sizeof(struct NTSKEM_decaps) <= CRYPTO_EXPANDEDSKBYTES, "CRYPTO_EXPANDEDSKBYTES");
+
 /* Function definitions */
 poly* create_random_goppa_polynomial(const FF2m* ff2m, int degree);
 matrix_ff2* create_matrix_G(const NTSKEM* nts_kem,
@@ -55,7 +71,7 @@ matrix_ff2* create_matrix_G(const NTSKEM* nts_kem,
                             ff_unit *h);
 void fisher_yates_shuffle(ff_unit *buffer);
 void random_vector(uint32_t tau, uint32_t n, uint8_t *e);
-int compute_syndrome(const NTSKEM* nts_kem,
+int compute_syndrome(const NTSKEM_decaps* ctx,
                      const uint64_t *c_ast,
                      ff_unit* s);
 void correct_error_and_recover_ke(const uint8_t* e_prime,
@@ -465,36 +481,149 @@ int nts_kem_decapsulate(const uint8_t *sk,
                         size_t sk_size,
                         const uint8_t *c_ast,
                         uint8_t *k_r)
+{
+    int32_t status;
+    NTSKEM_decaps ctx;
+    
+    /**
+     * Load the private key, then decapsulate with it
+     **/
+    status = nts_kem_decaps_init(&ctx, sk, sk_size);
+    if (status == NTS_KEM_SUCCESS)
+        status = nts_kem_decapsulate_ctx(&ctx, c_ast, k_r);
+    memset(&ctx, 0, sizeof(ctx));
+    
+    return status;
+}
+
+/**
+ *  Return the size in bytes of an NTS-KEM decapsulation context
+ *
+ *  @return The size of NTSKEM_decaps in bytes
+ **/
+size_t nts_kem_decaps_size()
+{
+    return sizeof(NTSKEM_decaps);
+}
+
+/**
+ *  Load a private key into a caller-allocated decapsulation context
+ *
+ *  @param[out] ctx     The pointer to the decapsulation context
+ *  @param[in]  sk      The pointer to NTS-KEM private key
+ *  @param[in]  sk_size The size of the private key in bytes
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int nts_kem_decaps_init(NTSKEM_decaps *ctx,
+                        const uint8_t *sk,
+                        size_t sk_size)
+{
+    FF2m *ff2m = NULL;
+    NTSKEM nts_kem;
+    NTSKEM_private priv;
+    
+    if (!ctx || !sk || sk_size != NTS_KEM_PRIVATE_KEY_SIZE)
+        return NTS_KEM_BAD_PARAMETERS;
+    
+    /* Keep the field operations, the basis is not used */
+    if (!(ff2m = ff_create()))
+        return NTS_KEM_BAD_MEMORY_ALLOCATION;
+    ctx->ff2m = *ff2m;
+    ctx->ff2m.basis = NULL;
+    ff_release(ff2m);
+    
+    /* Deserialise the private key blob, and bit-slice a and h */
+    nts_kem.priv = &priv;
+    if (deserialise_private_key(&nts_kem, sk) != NTS_KEM_SUCCESS)
+        return NTS_KEM_BAD_PARAMETERS;
+    vector_load_2d_64(ctx->a, priv.a, NTS_KEM_PARAM_BC);
+    vector_load_2d_64(ctx->h, priv.h, NTS_KEM_PARAM_BC);
+    memcpy(ctx->p, priv.p, sizeof(ctx->p));
+    memset(&priv, 0, sizeof(priv));
+    
+    return NTS_KEM_SUCCESS;
+}
+
+/**
+ *  Create a decapsulation context from a private key
+ *
+ *  @param[out] ctx     A pointer of the context created
+ *  @param[in]  sk      The pointer to NTS-KEM private key
+ *  @param[in]  sk_size The size of the private key in bytes
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int nts_kem_decaps_create(NTSKEM_decaps **ctx,
+                          const uint8_t *sk,
+                          size_t sk_size)
+{
+    int status;
+    
+    if (!ctx)
+        return NTS_KEM_BAD_PARAMETERS;
+    *ctx = (NTSKEM_decaps *)malloc(sizeof(NTSKEM_decaps));
+    if (!(*ctx))
+        return NTS_KEM_BAD_MEMORY_ALLOCATION;
+    
+    status = nts_kem_decaps_init(*ctx, sk, sk_size);
+    if (status != NTS_KEM_SUCCESS) {
+        nts_kem_decaps_release(*ctx);
+        *ctx = NULL;
+    }
+    
+    return status;
+}
+
+/**
+ *  Release a decapsulation context created by nts_kem_decaps_create()
+ *
+ *  @param[in] ctx  The pointer to the decapsulation context
+ **/
+void nts_kem_decaps_release(NTSKEM_decaps *ctx)
+{
+    if (ctx) {
+        memset(ctx, 0, sizeof(NTSKEM_decaps));
+        free(ctx);
+    }
+}
+
+/**
+ *  NTS-KEM decapsulation with a loaded private key
+ *
+ *  @note
+ *  The context is only read, and the ciphertext is not modified
+ *
+ *  @param[in]  ctx     The pointer to the decapsulation context
+ *  @param[in]  c_ast   The pointer to the NTS-KEM ciphertext
+ *  @param[out] k_r     The pointer to the encapsulated key
+ *  @return NTS_KEM_SUCCESS on success, otherwise a negative error code
+ *          {@see nts_kem_errors.h}
+ **/
+int nts_kem_decapsulate_ctx(const NTSKEM_decaps *ctx,
+                            const uint8_t *c_ast,
+                            uint8_t *k_r)
 {
     int32_t i, status = NTS_KEM_BAD_MEMORY_ALLOCATION;
     int32_t extended_error = 0;
     uint32_t checksum = 0, error_weight = 0;
-    NTSKEM *nts_kem = NULL;
-    NTSKEM_private *priv = NULL;
     uint64_t in_cipher[NTS_KEM_PARAM_BC_VEC];
     uint64_t vec_syndromes[6][NTS_KEM_PARAM_M] = {{0}};
     uint64_t sigma[4][NTS_KEM_PARAM_M] = {{0}};
     uint64_t evals[NTS_KEM_PARAM_N_VEC][NTS_KEM_PARAM_M];
     uint64_t error[NTS_KEM_PARAM_N_VEC];
     uint64_t allones = -1;
-    uint8_t *e_prime = NULL;
+    uint8_t *e_prime = (uint8_t *)error;
+    uint8_t k_e[kNTSKEMKeysize];
     ff_unit syndromes[2*NTS_KEM_PARAM_T];
     uint8_t e[NTS_KEM_PARAM_CEIL_N_BYTE];
     uint8_t kr_in_buf[kNTSKEMKeysize + NTS_KEM_PARAM_CEIL_N_BYTE];
     
-    if (!k_r || !c_ast) {
+    if (!ctx || !k_r || !c_ast) {
         status = NTS_KEM_BAD_PARAMETERS;
         goto decapsulation_failure;
     }
     
-    /**
-     * Construct an NTS object from private key
-     **/
-    if (NTS_KEM_SUCCESS != nts_kem_init_from_private_key(&nts_kem, sk, sk_size))
-        goto decapsulation_failure;
-    
-    priv = nts_kem->priv;
-
     /**
      * Load the input ciphertext c* to a vectorised array
      **/
@@ -506,7 +635,7 @@ int nts_kem_decapsulate(const uint8_t *sk,
      * Step 1c. Compute all 2*τ syndromes of c* as s = (c_b | c_c).(H*_m)^T,
      *         see Algorithm 2 in the supporting document
      */
-    status = compute_syndrome(nts_kem, in_cipher, syndromes);
+    status = compute_syndrome(ctx, in_cipher, syndromes);
     if (status != NTS_KEM_SUCCESS)
         goto decapsulation_failure;
     status = NTS_KEM_BAD_MEMORY_ALLOCATION; /* Reset the status value */
@@ -554,7 +683,8 @@ int nts_kem_decapsulate(const uint8_t *sk,
      *
      * A countermeasure is added to prevent potential cache timing attack
      **/
-    correct_error_and_recover_ke(e_prime, priv->p, e, (uint8_t*)c_ast);
+    memcpy(k_e, c_ast, kNTSKEMKeysize);
+    correct_error_and_recover_ke(e_prime, ctx->p, e, k_e);
     
     /**
      * Step 9. Check if k_e == SHAKE256(e), if not return an error indicating
@@ -575,7 +705,7 @@ int nts_kem_decapsulate(const uint8_t *sk,
      * Verify the equality of k_e and SHAKE256(e)
      **/
     for (checksum=0,i=0; i<kNTSKEMKeysize; i++) {
-        checksum += (c_ast[i] ^ kr_in_buf[i]);
+        checksum += (k_e[i] ^ kr_in_buf[i]);
     }
     status = CT_mux(CT_is_equal_zero(checksum) && CT_is_equal(error_weight, NTS_KEM_PARAM_T),
                     NTS_KEM_SUCCESS, NTS_KEM_INVALID_CIPHERTEXT);
@@ -585,8 +715,7 @@ decapsulation_failure:
     memset(e_prime, 0, NTS_KEM_PARAM_CEIL_N_BYTE);
     memset(syndromes, 0, sizeof(syndromes));
     memset(evals, 0, sizeof(evals));
-    if (nts_kem)
-        nts_kem_release(nts_kem);
+    memset(k_e, 0, sizeof(k_e));
     
     return status;
 }
@@ -1093,31 +1222,29 @@ void fisher_yates_shuffle(ff_unit *buffer)
  *  Given the data and parity-check vectors, both of which have 
  *  been corrupted with errors, compute the syndrome vector.
  *
- *  @param[in]  nts_kem   The pointer to NTS-KEM object
+ *  @param[in]  ctx       The pointer to the decapsulation context
  *  @param[in]  c_ptr     The pointer to the inpute ciphertext
  *  @param[out] s         The computed 2*t syndromes
  *  @return NTS_KEM_SUCCESS on success, otherwise a negative status
  *  {@see nts_kem_errors.h}
  **/
-int compute_syndrome(const NTSKEM* nts_kem,
+int compute_syndrome(const NTSKEM_decaps* ctx,
                      const uint64_t *c_ptr,
                      ff_unit* s)
 {
     int32_t i, j;
-    FF2m *ff2m = NULL;
-    NTSKEM_private *priv = NULL;
-    uint64_t a[NTS_KEM_PARAM_BC_VEC][NTS_KEM_PARAM_M];
+    const FF2m *ff2m = NULL;
+    const uint64_t (*a)[NTS_KEM_PARAM_M] = NULL;
     uint64_t g[NTS_KEM_PARAM_BC_VEC][NTS_KEM_PARAM_M];
     uint64_t h[NTS_KEM_PARAM_BC_VEC][NTS_KEM_PARAM_M];
     
-    if (!nts_kem || !nts_kem->priv)
+    if (!ctx)
         return NTS_KEM_BAD_PARAMETERS;
     
-    priv = (NTSKEM_private *)nts_kem->priv;
-    ff2m = priv->ff2m;
+    ff2m = &ctx->ff2m;
+    a = ctx->a;
     
-    vector_load_2d_64(a, priv->a, NTS_KEM_PARAM_BC);
-    vector_load_2d_64(g, priv->h, NTS_KEM_PARAM_BC);
+    memcpy(g, ctx->h, sizeof(g));
     
     memset(s, 0, 2*NTS_KEM_PARAM_T*sizeof(ff_unit));
     memset(h, 0, NTS_KEM_PARAM_BC_VEC*NTS_KEM_PARAM_M*sizeof(uint64_t));
@@ -1136,7 +1263,6 @@ int compute_syndrome(const NTSKEM* nts_kem,
         s[j] ^= ff2m->vector_ff_transpose_xor(ff2m, h[i]);
     }
     
-    memset(a, 0, sizeof(a));
     memset(g, 0, sizeof(g));
     memset(h, 0, sizeof(h));
 
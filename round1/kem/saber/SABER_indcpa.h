@@ -1,6 +1,21 @@
 #ifndef INDCPA_H
 #define INDCPA_H
 
+#include "poly.h"
+#include "poly_mul_avx2.h"
+
+// Public key with the matrix expanded, for repeated encryption
+typedef struct {
+	polyvec a[SABER_K];			// A, from the seed in pk
+	uint16_t pkcl[SABER_K][SABER_N];	// b, unpacked
+} indcpa_kem_epk;
+
+// Secret key unpacked, for repeated decryption
+typedef struct {
+	uint16_t sksv[SABER_K][SABER_N];	// s, reduced mod p
+	toom4_eval_t skev[SABER_K];		// s, evaluated (with AVX2)
+} indcpa_kem_esk;
+
 void indcpa_keypair(unsigned char *pk, unsigned char *sk);
 
 void indcpa_client(unsigned char *pk, unsigned char *b_prime, unsigned char *c, unsigned char *key);
@@ -9,7 +24,11 @@ void indcpa_server(unsigned char *pk, unsigned char *b_prime, unsigned char *c,
 
 void indcpa_kem_keypair(unsigned char *pk, unsigned char *sk);
 void indcpa_kem_enc(unsigned char *message, unsigned char *noiseseed, const unsigned char *pk, unsigned char *ciphertext);
+void indcpa_kem_expand_pk(indcpa_kem_epk *epk, const unsigned char *pk);
+void indcpa_kem_enc_expanded(unsigned char *message, unsigned char *noiseseed, const indcpa_kem_epk *epk, unsigned char *ciphertext);
 void indcpa_kem_dec(const unsigned char *sk, const unsigned char *ciphertext, unsigned char *message_dec);
+void indcpa_kem_expand_sk(indcpa_kem_esk *esk, const unsigned char *sk);
+void indcpa_kem_dec_expanded(const indcpa_kem_esk *esk, const unsigned char *ciphertext, unsigned char *message_dec);
 
 
 uint64_t clock1,clock2;
@@ -0,0 +1,40 @@
+#ifndef POLY_MUL_AVX2_H
+#define POLY_MUL_AVX2_H
+
+#include <stdint.h>
+#include "SABER_params.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(SABER_MUL_REF)
+#define SABER_MUL_AVX2
+#endif
+
+// A polynomial of SABER_N coefficients evaluated for multiplication:
+// Toom-4 to 7 points of 64 coefficients, then two Karatsuba levels, gives
+// 63 pieces of 16 coefficients. Coefficient c of piece 16*b+s is v[b][c][s].
+typedef struct {
+	uint16_t v[4][16][16];
+} __attribute__ ((aligned (32))) toom4_eval_t;
+
+// A sum of products of evaluated polynomials, 31 coefficients per piece
+typedef struct {
+	uint16_t v[4][31][16];
+} __attribute__ ((aligned (32))) toom4_acc_t;
+
+#ifdef SABER_MUL_AVX2
+
+// nonzero if the CPU has AVX2
+int toom4_avx2_init(void);
+
+void toom4_eval_avx2(toom4_eval_t *e, const uint16_t *a);
+
+// acc += a * b; zero acc first
+void toom4_mac_avx2(toom4_acc_t *acc, const toom4_eval_t *a, const toom4_eval_t *b);
+
+// res = (res + acc interpolated, mod x^SABER_N + 1) & mod, for mod < SABER_Q
+void toom4_interp_avx2(uint16_t *res, const toom4_acc_t *acc, uint16_t mod);
+
+#else
+#define toom4_avx2_init() 0
+#endif
+
+#endif
@@ -0,0 +1,340 @@
+//  keccakx.c
+//  2018-05-12  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Shared Keccak-f[1600] with run-time CPU dispatch
+
+#include <string.h>
+
+#include "keccakx.h"
+
+// All widths use the same round code on GCC vector extension types; the
+// target attributes let the compiler pick AVX2 / AVX-512 instructions
+// (vprolq and vpternlogq for rotations and chi) for the wide versions.
+
+typedef uint64_t kx4_t __attribute__ ((vector_size(32)));
+typedef uint64_t kx8_t __attribute__ ((vector_size(64)));
+
+static const uint64_t kx_rc[24] = {
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808A,
+    0x8000000080008000, 0x000000000000808B, 0x0000000080000001,
+    0x8000000080008081, 0x8000000000008009, 0x000000000000008A,
+    0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+    0x000000008000808B, 0x800000000000008B, 0x8000000000008089,
+    0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+    0x000000000000800A, 0x800000008000000A, 0x8000000080008081,
+    0x8000000000008080, 0x0000000080000001, 0x8000000080008008
+};
+
+// rotation of lane x + 5*y, and its position y + 5*((2*x + 3*y) % 5)
+// after the pi step
+
+static const uint8_t kx_rho[25] = {
+     0,  1, 62, 28, 27, 36, 44,  6, 55, 20,  3, 10, 43,
+    25, 39, 41, 45, 15, 21,  8, 18,  2, 61, 56, 14
+};
+
+static const uint8_t kx_pi[25] = {
+     0, 10, 20,  5, 15, 16,  1, 11, 21,  6,  7, 17,  2,
+    12, 22, 23,  8, 18,  3, 13, 14, 24,  9, 19,  4
+};
+
+#define KX_ROL(v, n) (((v) << (n)) | ((v) >> ((64 - (n)) & 63)))
+
+// 24 rounds on a[25] of type T (uint64_t or a vector of them)
+
+#define KX_F1600(T, a) {                                            \
+    T b[25], c[5], d;                                               \
+    int r, x, y;                                                    \
+    for (r = 0; r < 24; r++) {                                      \
+        _Pragma("GCC unroll 5")                                     \
+        for (x = 0; x < 5; x++)                                     \
+            c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20]; \
+        _Pragma("GCC unroll 5")                                     \
+        for (x = 0; x < 5; x++) {                                   \
+            d = c[(x + 4) % 5] ^ KX_ROL(c[(x + 1) % 5], 1);         \
+            _Pragma("GCC unroll 5")                                 \
+            for (y = 0; y < 25; y += 5)                             \
+                a[y + x] ^= d;                                      \
+        }                                                           \
+        _Pragma("GCC unroll 25")                                    \
+        for (x = 0; x < 25; x++)                                    \
+            b[kx_pi[x]] = KX_ROL(a[x], kx_rho[x]);                  \
+        _Pragma("GCC unroll 5")                                     \
+        for (y = 0; y < 25; y += 5) {                               \
+            _Pragma("GCC unroll 5")                                 \
+            for (x = 0; x < 5; x++)                                 \
+                a[y + x] = b[y + x] ^                               \
+                    (~b[y + (x + 1) % 5] & b[y + (x + 2) % 5]);     \
+        }                                                           \
+        a[0] ^= kx_rc[r];                                           \
+    }                                                               \
+}
+
+// single state, generic and with BMI1/BMI2 (andn, rorx)
+
+static void kx_permute_gen(uint64_t st[25])
+{
+    KX_F1600(uint64_t, st)
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KX_X86
+
+__attribute__ ((target("bmi,bmi2")))
+static void kx_permute_bmi2(uint64_t st[25])
+{
+    KX_F1600(uint64_t, st)
+}
+
+#ifndef KECCAKX_NO_AVX2
+__attribute__ ((target("avx2")))
+static void kx_permute4x_avx2(uint64_t st[25 * 4])
+{
+    kx4_t a[25];
+
+    memcpy(a, st, sizeof(a));
+    KX_F1600(kx4_t, a)
+    memcpy(st, a, sizeof(a));
+}
+
+// without AVX-512 the 8-way version runs as two 4-way halves
+
+__attribute__ ((target("avx2")))
+static void kx_permute8x_avx2(uint64_t st[25 * 8])
+{
+    int h, i;
+    uint64_t t[25 * 4];
+
+    for (h = 0; h < 8; h += 4) {
+        for (i = 0; i < 25; i++)
+            memcpy(&t[4 * i], &st[8 * i + h], 4 * sizeof(uint64_t));
+        kx_permute4x_avx2(t);
+        for (i = 0; i < 25; i++)
+            memcpy(&st[8 * i + h], &t[4 * i], 4 * sizeof(uint64_t));
+    }
+}
+#endif
+
+#ifndef KECCAKX_NO_AVX512
+__attribute__ ((target("avx512f")))
+static void kx_permute8x_avx512(uint64_t st[25 * 8])
+{
+    kx8_t a[25];
+
+    memcpy(a, st, sizeof(a));
+    KX_F1600(kx8_t, a)
+    memcpy(st, a, sizeof(a));
+}
+#endif
+#endif
+
+// n independent states one at a time
+
+static void kx_permutenx_gen(uint64_t *st, int n)
+{
+    int i, j;
+    uint64_t a[25];
+
+    for (j = 0; j < n; j++) {
+        for (i = 0; i < 25; i++)
+            a[i] = st[n * i + j];
+        kx_permute_gen(a);
+        for (i = 0; i < 25; i++)
+            st[n * i + j] = a[i];
+    }
+}
+
+static void kx_permute4x_gen(uint64_t st[25 * 4])
+{
+    kx_permutenx_gen(st, 4);
+}
+
+static void kx_permute8x_gen(uint64_t st[25 * 8])
+{
+    kx_permutenx_gen(st, 8);
+}
+
+// dispatch: resolved once by a constructor before main(), and read-only
+// afterwards. Until then (e.g. from other constructors) the portable code
+// is used.
+
+static void (*kx_permute)(uint64_t *) = kx_permute_gen;
+static void (*kx_permute4x)(uint64_t *) = kx_permute4x_gen;
+static void (*kx_permute8x)(uint64_t *) = kx_permute8x_gen;
+static const char *kx_impl = "generic";
+
+__attribute__ ((constructor)) static void kx_resolve(void)
+{
+    void (*p1)(uint64_t *) = kx_permute_gen;
+    void (*p4)(uint64_t *) = kx_permute4x_gen;
+    void (*p8)(uint64_t *) = kx_permute8x_gen;
+    const char *impl = "generic";
+
+#ifdef KX_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2")) {
+        p1 = kx_permute_bmi2;
+        impl = "bmi2";
+    }
+#ifndef KECCAKX_NO_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        p4 = kx_permute4x_avx2;
+        p8 = kx_permute8x_avx2;
+        impl = "avx2";
+    }
+#endif
+#ifndef KECCAKX_NO_AVX512
+    if (__builtin_cpu_supports("avx512f")) {
+        p8 = kx_permute8x_avx512;
+        impl = "avx512";
+    }
+#endif
+#endif
+
+    kx_impl = impl;
+    kx_permute = p1;
+    kx_permute4x = p4;
+    kx_permute8x = p8;
+}
+
+void keccakx_permute(uint64_t st[25])
+{
+    kx_permute(st);
+}
+
+void keccakx_permute4x(uint64_t st[25 * 4])
+{
+    kx_permute4x(st);
+}
+
+void keccakx_permute8x(uint64_t st[25 * 8])
+{
+    kx_permute8x(st);
+}
+
+const char *keccakx_impl(void)
+{
+    return kx_impl;
+}
+
+// little-endian lanes
+
+static uint64_t kx_load64(const uint8_t *x)
+{
+    int i;
+    uint64_t r = 0;
+
+    for (i = 0; i < 8; i++)
+        r |= ((uint64_t) x[i]) << (8 * i);
+
+    return r;
+}
+
+static void kx_store64(uint8_t *x, uint64_t u)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        x[i] = u;
+        u >>= 8;
+    }
+}
+
+// last partial block with padding, as a full block
+
+static void kx_pad(uint8_t t[200], unsigned r,
+    const uint8_t *m, size_t mlen, uint8_t p)
+{
+    memset(t, 0, r);
+    memcpy(t, m, mlen);
+    t[mlen] = p;
+    t[r - 1] |= 0x80;
+}
+
+void keccakx_absorb(uint64_t s[25], unsigned r,
+    const uint8_t *m, size_t mlen, uint8_t p)
+{
+    unsigned i;
+    uint8_t t[200];
+
+    while (mlen >= r) {
+        for (i = 0; i < r / 8; i++)
+            s[i] ^= kx_load64(m + 8 * i);
+        keccakx_permute(s);
+        mlen -= r;
+        m += r;
+    }
+
+    kx_pad(t, r, m, mlen, p);
+    for (i = 0; i < r / 8; i++)
+        s[i] ^= kx_load64(t + 8 * i);
+}
+
+void keccakx_squeezeblocks(uint8_t *h, size_t nblocks,
+    uint64_t s[25], unsigned r)
+{
+    unsigned i;
+
+    while (nblocks > 0) {
+        keccakx_permute(s);
+        for (i = 0; i < r / 8; i++)
+            kx_store64(h + 8 * i, s[i]);
+        h += r;
+        nblocks--;
+    }
+}
+
+void keccakx_absorb4x(uint64_t s[25 * 4], unsigned r,
+    const uint8_t *m0, const uint8_t *m1,
+    const uint8_t *m2, const uint8_t *m3, size_t mlen, uint8_t p)
+{
+    unsigned i;
+    uint8_t t[4][200];
+
+    while (mlen >= r) {
+        for (i = 0; i < r / 8; i++) {
+            s[4 * i    ] ^= kx_load64(m0 + 8 * i);
+            s[4 * i + 1] ^= kx_load64(m1 + 8 * i);
+            s[4 * i + 2] ^= kx_load64(m2 + 8 * i);
+            s[4 * i + 3] ^= kx_load64(m3 + 8 * i);
+        }
+        keccakx_permute4x(s);
+        mlen -= r;
+        m0 += r;
+        m1 += r;
+        m2 += r;
+        m3 += r;
+    }
+
+    kx_pad(t[0], r, m0, mlen, p);
+    kx_pad(t[1], r, m1, mlen, p);
+    kx_pad(t[2], r, m2, mlen, p);
+    kx_pad(t[3], r, m3, mlen, p);
+    for (i = 0; i < r / 8; i++) {
+        s[4 * i    ] ^= kx_load64(t[0] + 8 * i);
+        s[4 * i + 1] ^= kx_load64(t[1] + 8 * i);
+        s[4 * i + 2] ^= kx_load64(t[2] + 8 * i);
+        s[4 * i + 3] ^= kx_load64(t[3] + 8 * i);
+    }
+}
+
+void keccakx_squeezeblocks4x(uint8_t *h0, uint8_t *h1,
+    uint8_t *h2, uint8_t *h3, size_t nblocks,
+    uint64_t s[25 * 4], unsigned r)
+{
+    unsigned i;
+
+    while (nblocks > 0) {
+        keccakx_permute4x(s);
+        for (i = 0; i < r / 8; i++) {
+            kx_store64(h0 + 8 * i, s[4 * i    ]);
+            kx_store64(h1 + 8 * i, s[4 * i + 1]);
+            kx_store64(h2 + 8 * i, s[4 * i + 2]);
+            kx_store64(h3 + 8 * i, s[4 * i + 3]);
+        }
+        h0 += r;
+        h1 += r;
+        h2 += r;
+        h3 += r;
+        nblocks--;
+    }
+}
@@ -0,0 +1,39 @@
+//  keccakx.h
+//  2018-05-12  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Shared Keccak-f[1600] with run-time CPU dispatch
+
+#ifndef KECCAKX_H
+#define KECCAKX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// single state; lane i = x + 5*y as in FIPS 202
+void keccakx_permute(uint64_t st[25]);
+
+// 4 or 8 independent states, lane-interleaved: lane i of state j is at
+// st[4*i + j] (or st[8*i + j]). AVX2 / AVX-512 when the CPU has it.
+void keccakx_permute4x(uint64_t st[25 * 4]);
+void keccakx_permute8x(uint64_t st[25 * 8]);
+
+// name of the implementations selected: "avx512", "avx2", "bmi2", "generic"
+const char *keccakx_impl(void);
+
+// sponge with rate r bytes and domain / padding byte p (0x1F for SHAKE,
+// 0x06 for SHA3, 0x04 for cSHAKE). absorb xors into the state as it is
+// (zero it first unless continuing after a cSHAKE prefix block) and leaves
+// it padded but not permuted; each squeezed block permutes first.
+void keccakx_absorb(uint64_t s[25], unsigned r,
+    const uint8_t *m, size_t mlen, uint8_t p);
+void keccakx_squeezeblocks(uint8_t *h, size_t nblocks,
+    uint64_t s[25], unsigned r);
+
+// the same for four inputs of equal length, in one interleaved state
+void keccakx_absorb4x(uint64_t s[25 * 4], unsigned r,
+    const uint8_t *m0, const uint8_t *m1,
+    const uint8_t *m2, const uint8_t *m3, size_t mlen, uint8_t p);
+void keccakx_squeezeblocks4x(uint8_t *h0, uint8_t *h1,
+    uint8_t *h2, uint8_t *h3, size_t nblocks,
+    uint64_t s[25 * 4], unsigned r);
+
+#endif
@@ -0,0 +1,76 @@
+//  kem_batch.h
+//  2018-04-28  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Optional batch interface next to the NIST KEM API
+
+#ifndef __KEM_BATCH_H__
+#define __KEM_BATCH_H__
+
+#include <stddef.h>
+
+// Include after api.h. Each call processes n independent operations on
+// contiguous arrays of n objects of the CRYPTO_*BYTES sizes, so that an
+// implementation can amortize matrix expansion, NTT twiddle loads, hash
+// state etc. over the batch. Return value is 0 on success.
+//
+// A candidate with native batch code defines CRYPTO_KEM_BATCH in its
+// api.h and provides the three functions; others get the generic
+// fallback below that loops over the single-shot functions.
+
+#ifdef CRYPTO_KEM_BATCH
+
+int crypto_kem_keypair_batch(unsigned char *pk, unsigned char *sk, size_t n);
+
+int crypto_kem_enc_batch(unsigned char *ct, unsigned char *ss,
+                         const unsigned char *pk, size_t n);
+
+int crypto_kem_dec_batch(unsigned char *ss, const unsigned char *ct,
+                         const unsigned char *sk, size_t n);
+
+#else
+
+static inline int
+crypto_kem_keypair_batch(unsigned char *pk, unsigned char *sk, size_t n)
+{
+    size_t i;
+    int ret = 0;
+
+    for (i = 0; i < n; i++) {
+        ret |= crypto_kem_keypair(pk + i * CRYPTO_PUBLICKEYBYTES,
+                                  sk + i * CRYPTO_SECRETKEYBYTES);
+    }
+    return ret;
+}
+
+static inline int
+crypto_kem_enc_batch(unsigned char *ct, unsigned char *ss,
+                     const unsigned char *pk, size_t n)
+{
+    size_t i;
+    int ret = 0;
+
+    for (i = 0; i < n; i++) {
+        ret |= crypto_kem_enc(ct + i * CRYPTO_CIPHERTEXTBYTES,
+                              ss + i * CRYPTO_BYTES,
+                              (unsigned char *) pk + i * CRYPTO_PUBLICKEYBYTES);
+    }
+    return ret;
+}
+
+static inline int
+crypto_kem_dec_batch(unsigned char *ss, const unsigned char *ct,
+                     const unsigned char *sk, size_t n)
+{
+    size_t i;
+    int ret = 0;
+
+    for (i = 0; i < n; i++) {
+        ret |= crypto_kem_dec(ss + i * CRYPTO_BYTES,
+                              (unsigned char *) ct + i * CRYPTO_CIPHERTEXTBYTES,
+                              (unsigned char *) sk + i * CRYPTO_SECRETKEYBYTES);
+    }
+    return ret;
+}
+
+#endif
+
+#endif /* __KEM_BATCH_H__ */
@@ -0,0 +1,134 @@
+//  kem_cache.c
+//  2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Per-thread LRU cache of expanded public keys
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "api.h"
+#include "kem_expand.h"
+
+// Compiled with the candidate (see kem_expand.h); sizes come from api.h.
+// Each thread has its own cache, so there is no locking. The entries hold
+// pk and its expansion by value (megabytes for the code-based candidates),
+// so they are allocated on the heap at a thread's first cached Encaps and
+// freed by a thread-specific data destructor when it exits; only a pointer
+// is thread-local. The tag is a fast non-cryptographic hash of pk; a hit
+// also compares the stored pk.
+
+#ifndef KEM_CACHE_WAYS
+#define KEM_CACHE_WAYS 8
+#endif
+
+typedef struct {
+    uint64_t tag;                               // hash of pk, 0 = empty
+    uint64_t used;                              // time of last use
+    unsigned char pk[CRYPTO_PUBLICKEYBYTES];
+    unsigned char epk[CRYPTO_EXPANDEDPKBYTES] __attribute__ ((aligned (64)));
+} kem_cache_t;
+
+static __thread kem_cache_t *kem_cache = NULL;
+static __thread uint64_t kem_cache_clock = 0;
+
+static pthread_key_t kem_cache_key;
+static pthread_once_t kem_cache_once = PTHREAD_ONCE_INIT;
+
+static void kem_cache_free(void *p)
+{
+    free(p);
+}
+
+static void kem_cache_key_create(void)
+{
+    pthread_key_create(&kem_cache_key, kem_cache_free);
+}
+
+// the calling thread's cache, allocated on first use; NULL if out of memory
+
+static kem_cache_t *kem_cache_get(void)
+{
+    void *p;
+
+    if (kem_cache != NULL)
+        return kem_cache;
+
+    pthread_once(&kem_cache_once, kem_cache_key_create);
+    if (posix_memalign(&p, 64, KEM_CACHE_WAYS * sizeof(kem_cache_t)) != 0)
+        return NULL;
+    memset(p, 0, KEM_CACHE_WAYS * sizeof(kem_cache_t));
+    pthread_setspecific(kem_cache_key, p);
+    kem_cache = (kem_cache_t *) p;
+
+    return kem_cache;
+}
+
+// 64-bit multiply-xor hash over words of pk; never 0
+
+static uint64_t kem_cache_tag(const unsigned char *pk)
+{
+    size_t i;
+    uint64_t h, w;
+
+    h = 0x9E3779B97F4A7C15;
+    for (i = 0; i + 8 <= CRYPTO_PUBLICKEYBYTES; i += 8) {
+        memcpy(&w, pk + i, 8);
+        h = (h ^ w) * 0x100000001B3;
+        h ^= h >> 29;
+    }
+    for (; i < CRYPTO_PUBLICKEYBYTES; i++)
+        h = (h ^ pk[i]) * 0x100000001B3;
+
+    return h | 1;
+}
+
+int crypto_kem_enc_cached(unsigned char *ct, unsigned char *ss,
+                          const unsigned char *pk)
+{
+    int i, lru;
+    uint64_t tag;
+    kem_cache_t *e;
+
+    if (kem_cache_get() == NULL)            // no cache: plain Encaps
+        return crypto_kem_enc(ct, ss, (unsigned char *) pk);
+
+    tag = kem_cache_tag(pk);
+    kem_cache_clock++;
+
+    lru = 0;
+    for (i = 0; i < KEM_CACHE_WAYS; i++) {
+        e = &kem_cache[i];
+        if (e->tag == tag &&
+            memcmp(e->pk, pk, CRYPTO_PUBLICKEYBYTES) == 0) {
+            e->used = kem_cache_clock;
+            return crypto_kem_enc_expanded(ct, ss, e->epk);
+        }
+        if (e->used < kem_cache[lru].used)
+            lru = i;
+    }
+
+    // miss: replace the least recently used (or an empty) entry
+
+    e = &kem_cache[lru];
+    e->tag = 0;
+    if (crypto_kem_expand_pk(e->epk, pk) != 0)
+        return -1;
+    memcpy(e->pk, pk, CRYPTO_PUBLICKEYBYTES);
+    e->tag = tag;
+    e->used = kem_cache_clock;
+
+    return crypto_kem_enc_expanded(ct, ss, e->epk);
+}
+
+void crypto_kem_cache_flush(void)
+{
+    int i;
+
+    if (kem_cache == NULL)
+        return;
+    for (i = 0; i < KEM_CACHE_WAYS; i++) {
+        kem_cache[i].tag = 0;
+        kem_cache[i].used = 0;
+    }
+}
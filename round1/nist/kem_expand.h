@@ -0,0 +1,94 @@
+//  kem_expand.h
+//  2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Optional expanded-key interface next to the NIST KEM API
+
+#ifndef __KEM_EXPAND_H__
+#define __KEM_EXPAND_H__
+
+#include <string.h>
+
+// Include after api.h. An expanded public key holds what crypto_kem_enc()
+// would otherwise derive from pk on every call: the unpacked public
+// polynomials, the expanded public matrix and H(pk). An expanded secret
+// key does the same for crypto_kem_dec(): the unpacked secret vector, the
+// expanded public key for the re-encryption, and the rejection value z.
+// Both are opaque arrays (CRYPTO_EXPANDEDPKBYTES, CRYPTO_EXPANDEDSKBYTES)
+// that must be 64-byte (cache line) aligned.
+//
+// A candidate that supports this defines CRYPTO_KEM_EXPAND,
+// CRYPTO_EXPANDEDPKBYTES and CRYPTO_EXPANDEDSKBYTES in its api.h,
+// provides crypto_kem_expand_pk(), crypto_kem_enc_expanded(),
+// crypto_kem_expand_sk() and crypto_kem_dec_expanded(), and compiles
+// ../../nist/kem_cache.c.
+// That gives crypto_kem_enc_cached(), which looks pk up in a small
+// per-thread LRU cache of expanded keys (KEM_CACHE_WAYS entries, keyed by
+// a hash of pk) and expands it on a miss. crypto_kem_cache_flush() empties
+// the calling thread's cache.
+//
+// Other candidates get the fallbacks below, where the "expanded" keys are
+// pk and sk themselves and nothing is cached.
+
+#ifdef CRYPTO_KEM_EXPAND
+
+int crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk);
+
+int crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss,
+                            const unsigned char *epk);
+
+int crypto_kem_enc_cached(unsigned char *ct, unsigned char *ss,
+                          const unsigned char *pk);
+
+void crypto_kem_cache_flush(void);
+
+int crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk);
+
+int crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct,
+                            const unsigned char *esk);
+
+#else
+
+#define CRYPTO_EXPANDEDPKBYTES CRYPTO_PUBLICKEYBYTES
+#define CRYPTO_EXPANDEDSKBYTES CRYPTO_SECRETKEYBYTES
+
+static inline int
+crypto_kem_expand_pk(unsigned char *epk, const unsigned char *pk)
+{
+    memcpy(epk, pk, CRYPTO_PUBLICKEYBYTES);
+    return 0;
+}
+
+static inline int
+crypto_kem_enc_expanded(unsigned char *ct, unsigned char *ss,
+                        const unsigned char *epk)
+{
+    return crypto_kem_enc(ct, ss, (unsigned char *) epk);
+}
+
+static inline int
+crypto_kem_enc_cached(unsigned char *ct, unsigned char *ss,
+                      const unsigned char *pk)
+{
+    return crypto_kem_enc(ct, ss, (unsigned char *) pk);
+}
+
+static inline void crypto_kem_cache_flush(void)
+{
+}
+
+static inline int
+crypto_kem_expand_sk(unsigned char *esk, const unsigned char *sk)
+{
+    memcpy(esk, sk, CRYPTO_SECRETKEYBYTES);
+    return 0;
+}
+
+static inline int
+crypto_kem_dec_expanded(unsigned char *ss, const unsigned char *ct,
+                        const unsigned char *esk)
+{
+    return crypto_kem_dec(ss, (unsigned char *) ct, (unsigned char *) esk);
+}
+
+#endif
+
+#endif /* __KEM_EXPAND_H__ */
@@ -2,14 +2,37 @@
 //  2018-04-28  Markku-Juhani O. Saarinen <mjos@iki.fi>
 //              Simple AES-256 CTR Generator
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <pthread.h>
 #include <openssl/aes.h>
+#include <openssl/evp.h>
 
 #include "rng.h"
 
-// state for randombytes
+// randombytes() state is thread-local and produces whole requests with
+// EVP AES-256-CTR, which runs several blocks in parallel with AES-NI.
+// The keystream is the same as from seedexpander() with the same seed:
+// randombytes_init() followed by randombytes() on one thread gives the
+// KAT output. Threads that never call randombytes_init() derive their
+// own distinct stream from the last seed given to randombytes_init().
 
-static AES_XOF_struct rb_state;
+typedef struct {
+    EVP_CIPHER_CTX  *ctx;
+    int             seeded;
+} rb_state_t;
+
+static __thread rb_state_t rb_state;
+
+// master seed for threads that have not been seeded themselves
+
+static pthread_mutex_t rb_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t rb_once = PTHREAD_ONCE_INIT;
+static pthread_key_t rb_key;
+static unsigned char rb_master[48];
+static uint32_t rb_nthreads = 0;
 
 /*
  seedexpander_init()
@@ -48,9 +71,9 @@ int
 seedexpander(AES_XOF_struct *ctx, unsigned char *x, unsigned long xlen)
 {
     int j;
-    size_t i;
+    size_t i, l;
 
-    for (i = 0; i < xlen; i++) {
+    for (i = 0; i < xlen; i += l) {
         if (ctx->ptr >= 16) {
             // increase counter
             for (j = 15; j >= 0; j--) {
@@ -64,12 +87,98 @@ seedexpander(AES_XOF_struct *ctx, unsigned char *x, unsigned long xlen)
             AES_encrypt(ctx->ctr, ctx->buf, &ctx->key);
             ctx->ptr = 0;
         }
-        x[i] = ctx->buf[ctx->ptr++];
+        l = 16 - ctx->ptr;
+        if (l > xlen - i)
+            l = xlen - i;
+        memcpy(x + i, ctx->buf + ctx->ptr, l);
+        ctx->ptr += l;
     }
 
     return RNG_SUCCESS;
 }
 
+// free the cipher context when a thread exits
+
+static void rb_free(void *ctx)
+{
+    EVP_CIPHER_CTX_free((EVP_CIPHER_CTX *) ctx);
+}
+
+static void rb_key_init(void)
+{
+    pthread_key_create(&rb_key, rb_free);
+}
+
+// (re)key the calling thread: same key and first counter as seedexpander
+
+static void rb_seed(const unsigned char *seed)
+{
+    int i;
+    unsigned char iv[16];
+
+    if (rb_state.ctx == NULL) {
+        pthread_once(&rb_once, rb_key_init);
+        if ((rb_state.ctx = EVP_CIPHER_CTX_new()) == NULL) {
+            perror("randombytes(): EVP_CIPHER_CTX_new()");
+            exit(-1);
+        }
+        pthread_setspecific(rb_key, rb_state.ctx);
+    }
+
+    memcpy(iv, seed + 32, 8);
+    memset(iv + 8, 0xFF, 4);
+    memset(iv + 12, 0x00, 4);
+    for (i = 15; i >= 0; i--) {
+        if (++iv[i] != 0x00)
+            break;
+    }
+
+    if (EVP_EncryptInit_ex(rb_state.ctx, EVP_aes_256_ctr(),
+        NULL, seed, iv) != 1) {
+        perror("randombytes(): EVP_EncryptInit_ex()");
+        exit(-1);
+    }
+    rb_state.seeded = 1;
+}
+
+// keystream into x
+
+static void rb_fill(unsigned char *x, unsigned long long xlen)
+{
+    int l, outl;
+
+    while (xlen > 0) {
+        l = xlen > 0x40000000 ? 0x40000000 : (int) xlen;
+        memset(x, 0x00, l);
+        EVP_EncryptUpdate(rb_state.ctx, x, &outl, x, l);
+        x += l;
+        xlen -= l;
+    }
+}
+
+// first use on a thread that was not seeded: the 48-byte seed is master
+// keystream from a per-thread counter block outside the main stream
+
+static void rb_derive(void)
+{
+    int i;
+    uint32_t tid;
+    unsigned char seed[48], iv[16];
+
+    pthread_mutex_lock(&rb_lock);
+    tid = ++rb_nthreads;
+    memcpy(seed, rb_master, 48);
+    pthread_mutex_unlock(&rb_lock);
+
+    rb_seed(seed);
+    memset(iv, 0x00, 16);
+    memcpy(iv, seed + 32, 8);
+    for (i = 0; i < 4; i++)
+        iv[i] ^= (tid >> (8 * i)) & 0xFF;
+    EVP_EncryptInit_ex(rb_state.ctx, NULL, NULL, NULL, iv);
+    rb_fill(seed, sizeof(seed));
+    rb_seed(seed);
+}
 
 void randombytes_init(unsigned char *entropy_input,
                  unsigned char *personalization_string,
@@ -78,19 +187,28 @@ void randombytes_init(unsigned char *entropy_input,
     int i;
     unsigned char seed[48];
 
+    (void) security_strength;
+
     memcpy(seed, entropy_input, 48);
     if (personalization_string != NULL) {
-        for (int i=0; i < 48; i++) {
+        for (i = 0; i < 48; i++) {
             seed[i] ^= personalization_string[i];
         }
     }
-    seedexpander_init(&rb_state, seed, seed + 32, 0xFFFFFFFF);
+
+    pthread_mutex_lock(&rb_lock);
+    memcpy(rb_master, seed, 48);
+    pthread_mutex_unlock(&rb_lock);
+
+    rb_seed(seed);
 }
 
 int randombytes(unsigned char *x, unsigned long long xlen)
 {
-    return seedexpander(&rb_state, x, xlen);
-}
-
+    if (!rb_state.seeded)
+        rb_derive();
+    rb_fill(x, xlen);
 
+    return RNG_SUCCESS;
+}
 
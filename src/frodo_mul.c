@@ -0,0 +1,114 @@
+// frodo_mul.c
+// 2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+
+// Generate-and-multiply micro-benchmark for the FrodoKEM candidates. Takes
+// the place of kem_test.c: in round1/kem/FrodoKEM-640 or FrodoKEM-976,
+//   XKEM_SRC=../../../src/frodo_mul.c XKEM_BIN=fmul ./build_test.sh
+// Checks the streamed A*s + e and s'*A + e' (frodo_avx2.c), also from a
+// materialized A (frodo_a_expand()), against the original code and prints
+// "MUL" lines.
+
+#include <string.h>
+
+#include "xbench.h"
+#include "api.h"
+#include "frodo_macrify.h"
+#include "frodo_avx2.h"
+
+#ifndef FRODO_AVX2
+#error "frodo_mul.c needs the AVX2 kernels (x86, no -DFRODO_MUL_REF)"
+#endif
+
+#ifndef XBENCH_MUL
+#define XBENCH_MUL 101
+#endif
+
+// secret key is s || pk || S, S being N x N_BAR 16-bit words
+#define FRODO_N ((CRYPTO_SECRETKEYBYTES - CRYPTO_PUBLICKEYBYTES - \
+    CRYPTO_BYTES) / 16)
+
+static uint16_t mul_s[FRODO_N * 8], mul_e[FRODO_N * 8];
+static uint16_t mul_x[FRODO_N * 8], mul_y[FRODO_N * 8];
+static uint16_t mul_a[FRODO_N * FRODO_N];
+static uint8_t mul_seed[16];
+static frodo_a_t mul_ctx;
+
+// with the A materialized in mul_a
+
+static int mul_as_a(uint16_t *out, const uint16_t *s, const uint16_t *e,
+    const uint8_t *seed_A)
+{
+    (void) seed_A;
+    return frodo_mul_add_as_plus_e_a(out, s, e, &mul_ctx, mul_a);
+}
+
+static int mul_sa_a(uint16_t *out, const uint16_t *s, const uint16_t *e,
+    const uint8_t *seed_A)
+{
+    (void) seed_A;
+    return frodo_mul_add_sa_plus_e_a(out, s, e, &mul_ctx, mul_a);
+}
+
+static uint64_t mul_time(int (*f)(uint16_t *, const uint16_t *,
+    const uint16_t *, const uint8_t *))
+{
+    int i;
+    uint64_t clk[XBENCH_MUL];
+
+    XBENCH_CLK(clk, XBENCH_MUL, i, (void) 0,
+        f(mul_x, mul_s, mul_e, mul_seed));
+
+    return xbench_median(clk, XBENCH_MUL);
+}
+
+static void mul_print(const char *name, uint64_t ref, uint64_t fast)
+{
+    xbench_print("MUL", name, ref, "avx2", fast, CRYPTO_ALGNAME);
+}
+
+int main()
+{
+    int i, fail[4];
+
+    if (!frodo_avx2_init()) {
+        printf("MUL no AVX2/AES-NI\t[%s]\n", CRYPTO_ALGNAME);
+        return 0;
+    }
+
+    srand(1);
+    memset(fail, 0, sizeof(fail));
+    for (i = 0; i < 10; i++) {
+        xbench_rand(mul_s, sizeof(mul_s));
+        xbench_rand(mul_e, sizeof(mul_e));
+        xbench_rand(mul_seed, sizeof(mul_seed));
+        frodo_a_init(&mul_ctx, mul_seed);
+        frodo_a_expand(mul_a, &mul_ctx);
+        frodo_mul_add_as_plus_e_ref(mul_x, mul_s, mul_e, mul_seed);
+        frodo_mul_add_as_plus_e(mul_y, mul_s, mul_e, mul_seed);
+        fail[0] += memcmp(mul_x, mul_y, sizeof(mul_x)) != 0;
+        mul_as_a(mul_y, mul_s, mul_e, NULL);
+        fail[2] += memcmp(mul_x, mul_y, sizeof(mul_x)) != 0;
+        frodo_mul_add_sa_plus_e_ref(mul_x, mul_s, mul_e, mul_seed);
+        frodo_mul_add_sa_plus_e(mul_y, mul_s, mul_e, mul_seed);
+        fail[1] += memcmp(mul_x, mul_y, sizeof(mul_x)) != 0;
+        mul_sa_a(mul_y, mul_s, mul_e, NULL);
+        fail[3] += memcmp(mul_x, mul_y, sizeof(mul_x)) != 0;
+    }
+    if (fail[0] | fail[1] | fail[2] | fail[3]) {
+        printf("MUL avx2 differs from reference: "
+            "A*s+e %d/10, s'*A+e' %d/10, with A %d/10 %d/10\t[%s]\n",
+            fail[0], fail[1], fail[2], fail[3], CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    mul_print("A*s+e", mul_time(frodo_mul_add_as_plus_e_ref),
+        mul_time(frodo_mul_add_as_plus_e));
+    mul_print("s'*A+e'", mul_time(frodo_mul_add_sa_plus_e_ref),
+        mul_time(frodo_mul_add_sa_plus_e));
+    mul_print("A*s+e A", mul_time(frodo_mul_add_as_plus_e_ref),
+        mul_time(mul_as_a));
+    mul_print("s'*A+e' A", mul_time(frodo_mul_add_sa_plus_e_ref),
+        mul_time(mul_sa_a));
+
+    return 0;
+}
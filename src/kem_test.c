@@ -1,185 +1,1728 @@
 // kem_test.c
 // 2018-03-27  Markku-Juhani O. Saarinen <mjos@iki.fi>
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <regex.h>
+#include <errno.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 // for __rdtsc()
 #include <x86intrin.h>
 
-#include "api.h"
-#include "rng.h"
+#include "xkem.h"
 
+// the multi-candidate runner gets its entries from a generated header,
+// otherwise the candidate in the build directory is the only entry
 
-#ifndef XBENCH_REPS
-#define XBENCH_REPS 20
+#ifdef XKEM_MULTI
+#include "xkem_reg.h"
+#else
+#include "xkem_entry.c"
+static const xkem_t *xkem_reg[] = { &xkem_entry, NULL };
 #endif
 
 #ifndef XBENCH_TIMEOUT
 #define XBENCH_TIMEOUT 1000000000
 #endif
 
-#ifndef CRYPTO_ALGNAME
-#define CRYPTO_ALGNAME "UNKNOWN ALGORITHM"
+// warm-up before each timed phase (TSC ticks)
+
+#ifndef XBENCH_WARMUP
+#define XBENCH_WARMUP (XBENCH_TIMEOUT / 10)
+#endif
+
+// a phase ends early when the 95% confidence interval of the median is
+// narrower than XBENCH_CI percent (-c option) after XBENCH_MIN_SAMPLES
+
+#ifndef XBENCH_CI
+#define XBENCH_CI 1.0
+#endif
+
+#ifndef XBENCH_MIN_SAMPLES
+#define XBENCH_MIN_SAMPLES 16
+#endif
+
+// core clock change (percent) over a phase that is flagged as FREQ
+
+#ifndef XBENCH_DRIFT
+#define XBENCH_DRIFT 2.0
+#endif
+
+static double xbench_ci = XBENCH_CI;
+
+// dedicated thread stack for the memory test (-m)
+
+#ifndef XBENCH_STACK
+#define XBENCH_STACK (64 << 20)
+#endif
+
+// length of each step of the multi-threaded throughput test
+
+#ifndef XBENCH_MT_MSEC
+#define XBENCH_MT_MSEC 1000
+#endif
+
+// public key fingerprints kept per thread for the duplicate check
+
+#ifndef XBENCH_MT_FPRS
+#define XBENCH_MT_FPRS 4096
 #endif
 
+// HDR-style latency histogram: values below 2*XHIST_SUB are exact, above
+// that each power of two is split into XHIST_SUB linear sub-buckets, so
+// the relative error of a reported percentile is at most 1/XHIST_SUB.
+
+#define XHIST_SUB_BITS  8
+#define XHIST_SUB       (1 << XHIST_SUB_BITS)
+#define XHIST_BUCKETS   ((64 - XHIST_SUB_BITS + 1) * XHIST_SUB)
+
+typedef struct {
+    uint64_t n, min, max;
+    double sum, sum2;
+    uint64_t cnt[XHIST_BUCKETS];
+} xhist_t;
+
+// hardware counters per call (-p): cycles, instructions, L1D misses,
+// LLC misses, branch mispredicts, dTLB misses
 
-// Gives roughly 2 microsecond precision on my system
+#define XPERF_N 6
+
+// results of one timed phase
+
+typedef struct {
+    uint64_t clk;                   // mean TSC ticks per call
+    double sec;                     // mean seconds per call
+    uint64_t n;                     // timed calls
+    uint64_t warm;                  // warm-up calls
+    uint64_t migr;                  // samples discarded for core migration
+    uint64_t outl;                  // far outliers (beyond 3 IQR)
+    double trim;                    // mean without far outliers
+    uint64_t med, ci_lo, ci_hi;     // median and its 95% CI
+    double ci;                      // CI width, percent of median
+    double drift;                   // core clock change over phase, percent
+    int conv;                       // CI target reached
+    int fails;                      // failed KEX, -1 if not tested
+    double pmu[XPERF_N];            // counters per call, < 0 if n/a
+    xhist_t h;
+} xstat_t;
+
+
+// Wall clock like the TSC, not process CPU time
 
 static double clk_now()
 {
     struct timespec ts;
 
-    // You may onsider CLOCK_MONOTONIC and CLOCK_MONOTONIC_RAW here too
-    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) != 0) {
         perror("clock_gettime()");
         exit(-1);
     }
     return ((double) ts.tv_sec) + 1E-9 * ((double) ts.tv_nsec);
 }
 
+// bucket index for a value
 
-int main(int argc, char **argv)
+static int xhist_idx(uint64_t v)
 {
-    FILE *fd;
-    uint8_t seed[48];
-    int i, fails;
-    uint64_t clk1, clk2, n;
-    double tim;
+    int shift;
 
-#if (XBENCH_REPS > 1)
-    uint8_t *pk[XBENCH_REPS], *sk[XBENCH_REPS],
-            *ct[XBENCH_REPS], *ss[XBENCH_REPS];
+    if (v < 2 * XHIST_SUB)
+        return (int) v;
+    shift = 63 - __builtin_clzll(v) - XHIST_SUB_BITS;
+
+    return ((shift + 1) << XHIST_SUB_BITS) + (int) (v >> shift) - XHIST_SUB;
+}
+
+// midpoint of the range covered by a bucket
+
+static uint64_t xhist_val(int idx)
+{
+    int shift;
+
+    if (idx < 2 * XHIST_SUB)
+        return (uint64_t) idx;
+    shift = (idx >> XHIST_SUB_BITS) - 1;
+
+    return ((uint64_t) ((idx & (XHIST_SUB - 1)) + XHIST_SUB) << shift) +
+        ((1llu << shift) >> 1);
+}
+
+static void xhist_clear(xhist_t *h)
+{
+    memset(h, 0, sizeof(xhist_t));
+    h->min = UINT64_MAX;
+}
+
+static void xhist_add(xhist_t *h, uint64_t v)
+{
+    h->cnt[xhist_idx(v)]++;
+    h->n++;
+    if (v < h->min)
+        h->min = v;
+    if (v > h->max)
+        h->max = v;
+    h->sum += (double) v;
+    h->sum2 += ((double) v) * ((double) v);
+}
+
+// value at quantile q (0 < q <= 1), clamped to observed min and max
+
+static uint64_t xhist_pct(const xhist_t *h, double q)
+{
+    int i;
+    uint64_t rank, acc, v;
+
+    if (h->n == 0)
+        return 0;
+    rank = (uint64_t) (q * ((double) h->n) + 0.5);
+    if (rank < 1)
+        rank = 1;
+    acc = 0;
+    for (i = 0; i < XHIST_BUCKETS; i++) {
+        acc += h->cnt[i];
+        if (acc >= rank)
+            break;
+    }
+    v = xhist_val(i);
+    if (v < h->min)
+        v = h->min;
+    if (v > h->max)
+        v = h->max;
+
+    return v;
+}
+
+// square root without libm (build_test.sh scripts don't link -lm)
+
+static double xsqrt(double x)
+{
+    int i;
+    double y;
+
+    if (x <= 0.0)
+        return 0.0;
+    y = x > 1.0 ? x : 1.0;
+    for (i = 0; i < 200; i++) {
+        double z = 0.5 * (y + x / y);
+        if (z >= y)
+            break;
+        y = z;
+    }
+
+    return y;
+}
+
+// mean and sample standard deviation
+
+static double xhist_avg(const xhist_t *h)
+{
+    return h->n > 0 ? h->sum / ((double) h->n) : 0.0;
+}
+
+static double xhist_sd(const xhist_t *h)
+{
+    double var;
+
+    if (h->n < 2)
+        return 0.0;
+    var = (h->sum2 - h->sum * xhist_avg(h)) / ((double) (h->n - 1));
+
+    return xsqrt(var);
+}
+
+// coefficient of variation (standard deviation / mean)
+
+static double xhist_cv(const xhist_t *h)
+{
+    if (h->n < 2)
+        return 0.0;
+
+    return xhist_sd(h) / xhist_avg(h);
+}
+
+// count of samples beyond Tukey's far fences (quartiles -+ 3 IQR) and the
+// mean of the rest, using bucket midpoints
+
+static void xhist_far(const xhist_t *h, uint64_t *outl, double *trim)
+{
+    int i;
+    uint64_t q1, q3, v, lo, hi, n;
+    double sum;
+
+    q1 = xhist_pct(h, 0.25);
+    q3 = xhist_pct(h, 0.75);
+    lo = q1 > 3 * (q3 - q1) ? q1 - 3 * (q3 - q1) : 0;
+    hi = q3 + 3 * (q3 - q1);
+
+    n = 0;
+    sum = 0.0;
+    for (i = 0; i < XHIST_BUCKETS; i++) {
+        if (h->cnt[i] == 0)
+            continue;
+        v = xhist_val(i);
+        if (v >= lo && v <= hi) {
+            n += h->cnt[i];
+            sum += ((double) h->cnt[i]) * ((double) v);
+        }
+    }
+    *outl = h->n - n;
+    *trim = n > 0 ? sum / ((double) n) : 0.0;
+}
+
+static void xhist_print(const xhist_t *h, const char *lbl, const char *name)
+{
+    printf("LAT %-7s min %lu p50 %lu p90 %lu p99 %lu p99.9 %lu max %lu "
+        "cv %.4f n %lu\t[%s]\n", lbl, h->min,
+        xhist_pct(h, 0.50), xhist_pct(h, 0.90), xhist_pct(h, 0.99),
+        xhist_pct(h, 0.999), h->max, xhist_cv(h), h->n, name);
+}
+
+
+// == hardware performance counters ==
+
+#define XPERF_CACHE(cache, res) (PERF_COUNT_HW_CACHE_##cache | \
+    (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_##res << 16))
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+    const char *name;
+} xperf_ev[XPERF_N] = {
+    { PERF_TYPE_HARDWARE,   PERF_COUNT_HW_CPU_CYCLES,       "cycles"    },
+    { PERF_TYPE_HARDWARE,   PERF_COUNT_HW_INSTRUCTIONS,     "instr"     },
+    { PERF_TYPE_HW_CACHE,   XPERF_CACHE(L1D, MISS),         "l1d_miss"  },
+    { PERF_TYPE_HW_CACHE,   XPERF_CACHE(LL, MISS),          "llc_miss"  },
+    { PERF_TYPE_HARDWARE,   PERF_COUNT_HW_BRANCH_MISSES,    "br_miss"   },
+    { PERF_TYPE_HW_CACHE,   XPERF_CACHE(DTLB, MISS),        "dtlb_miss" }
+};
+
+static int xperf_fd[XPERF_N];
+static int xperf_on = 0;
+
+// open user-space counters for this thread; ones that the CPU, kernel, or
+// perf_event_paranoid don't allow are left out. They are opened one by
+// one rather than as a single group so that a group too large for the PMU
+// doesn't lose all of them; the kernel multiplexes and we scale.
+
+static void xperf_open(void)
+{
+    int i, n;
+    struct perf_event_attr pe;
+
+    n = 0;
+    for (i = 0; i < XPERF_N; i++) {
+        memset(&pe, 0, sizeof(pe));
+        pe.size = sizeof(pe);
+        pe.type = xperf_ev[i].type;
+        pe.config = xperf_ev[i].config;
+        pe.disabled = 1;
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        pe.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+            PERF_FORMAT_TOTAL_TIME_RUNNING;
+        xperf_fd[i] = (int) syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+        if (xperf_fd[i] >= 0)
+            n++;
+    }
+    if (n == 0) {
+        perror("perf_event_open(): counters not available");
+        return;
+    }
+    xperf_on = 1;
+}
+
+static void xperf_start(void)
+{
+    int i;
+
+    for (i = 0; xperf_on && i < XPERF_N; i++) {
+        if (xperf_fd[i] >= 0) {
+            ioctl(xperf_fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(xperf_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+// counts divided by n calls; -1 if not available
+
+static void xperf_stop(double *val, uint64_t n)
+{
+    int i;
+    uint64_t rd[3];
+
+    for (i = 0; i < XPERF_N; i++) {
+        val[i] = -1.0;
+        if (!xperf_on || xperf_fd[i] < 0)
+            continue;
+        ioctl(xperf_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(xperf_fd[i], rd, sizeof(rd)) != sizeof(rd) || rd[2] == 0)
+            continue;
+        val[i] = ((double) rd[0]) * ((double) rd[1]) / ((double) rd[2]) /
+            ((double) n);
+    }
+}
+
+static void xperf_print(const double *pmu, const char *op, const char *name)
+{
+    int i;
+
+    if (!xperf_on)
+        return;
+
+    printf("PMU %-7s", op);
+    for (i = 0; i < XPERF_N; i++) {
+        if (pmu[i] >= 0.0)
+            printf(" %s %.0f", xperf_ev[i].name, pmu[i]);
+        else
+            printf(" %s -", xperf_ev[i].name);
+        if (i == 1) {
+            if (pmu[0] > 0.0 && pmu[1] >= 0.0)
+                printf(" ipc %.3f", pmu[1] / pmu[0]);
+            else
+                printf(" ipc -");
+        }
+    }
+    printf("\t[%s]\n", name);
+}
+
+// == machine-readable output (JSON Lines) ==
+
+static FILE *xjson = NULL;              // -j <file>
+static char xjson_meta[2048];           // run metadata for every record
+
+#ifndef XBENCH_COMPILER
+#if defined(__clang__)
+#define XBENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define XBENCH_COMPILER "gcc " __VERSION__
 #else
-#define XBENCH_REPS 1
-    uint8_t *pk[1], *sk[1], *ct[1], *ss[2];
+#define XBENCH_COMPILER "unknown"
+#endif
 #endif
 
-    printf("CRYPTO_PUBLICKEYBYTES\t%8d\t\t[%s]\n", 
-            CRYPTO_PUBLICKEYBYTES, CRYPTO_ALGNAME);
-    printf("CRYPTO_SECRETKEYBYTES\t%8d\t\t[%s]\n", 
-            CRYPTO_SECRETKEYBYTES, CRYPTO_ALGNAME);
-    printf("CRYPTO_CIPHERTEXTBYTES\t%8d\t\t[%s]\n", 
-            CRYPTO_CIPHERTEXTBYTES, CRYPTO_ALGNAME);
-    printf("CRYPTO_BYTES\t\t%8d\t\t[%s]\n", 
-            CRYPTO_BYTES, CRYPTO_ALGNAME);
+// append a quoted and escaped JSON string
 
-    // init random with random
+static void xjson_str(char *buf, size_t siz, const char *s)
+{
+    size_t i;
 
-    memset(seed, 0x00, sizeof(seed));
-    if ((fd = fopen("/dev/urandom", "r")) == NULL ||
-        fread(seed, 1, 48, fd) != 48)
-    {
-        perror("/dev/urandom");
-        return -1;
+    i = strlen(buf);
+    if (i + 1 < siz)
+        buf[i++] = '"';
+    for (; *s != 0 && i + 7 < siz; s++) {
+        if (*s == '"' || *s == '\\') {
+            buf[i++] = '\\';
+            buf[i++] = *s;
+        } else if ((unsigned char) *s < 0x20) {
+            i += snprintf(buf + i, siz - i, "\\u%04x", (unsigned char) *s);
+        } else {
+            buf[i++] = *s;
+        }
     }
-    fclose(fd);
+    if (i + 1 < siz)
+        buf[i++] = '"';
+    buf[i] = 0;
+}
 
-    randombytes_init(seed, NULL, 256);
+// value of "key : value" line in a text file (first line if key is NULL)
 
-    // multiple of everhthing
+static void xfile_val(const char *fn, const char *key, char *val, size_t siz)
+{
+    FILE *f;
+    size_t l;
+    char *p, buf[512];
 
-    for (i = 0; i < XBENCH_REPS; i++) {
-        pk[i] = (uint8_t *) malloc(CRYPTO_PUBLICKEYBYTES);
-        sk[i] = (uint8_t *) malloc(CRYPTO_SECRETKEYBYTES);
-        ct[i] = (uint8_t *) malloc(CRYPTO_CIPHERTEXTBYTES);
-        ss[i] = (uint8_t *) malloc(CRYPTO_BYTES);
+    snprintf(val, siz, "unknown");
+    if ((f = fopen(fn, "r")) == NULL)
+        return;
+    while (fgets(buf, sizeof(buf), f) != NULL) {
+        buf[strcspn(buf, "\n")] = 0;
+        p = buf;
+        if (key != NULL) {
+            if (strncmp(buf, key, strlen(key)) != 0 ||
+                (p = strchr(buf, ':')) == NULL)
+                continue;
+            p++;
+            while (*p == ' ' || *p == '\t')
+                p++;
+        }
+        l = strlen(p);
+        if (l >= siz)
+            l = siz - 1;
+        memcpy(val, p, l);
+        val[l] = 0;
+        break;
     }
-    if (XBENCH_REPS == 1) {
-        ss[1] = (uint8_t *) malloc(CRYPTO_BYTES);
+    fclose(f);
+}
+
+// compiler, CFLAGS, CPU model, frequency governor, git revision, ..
+
+static void xjson_init(void)
+{
+    size_t i;
+    time_t t;
+    char buf[256];
+    const char *s;
+
+    xjson_meta[0] = 0;
+
+#define XJSON_KEY(key) \
+    i = strlen(xjson_meta); \
+    snprintf(xjson_meta + i, sizeof(xjson_meta) - i, ",\"%s\":", key);
+
+    XJSON_KEY("compiler");
+    xjson_str(xjson_meta, sizeof(xjson_meta), XBENCH_COMPILER);
+    XJSON_KEY("cflags");
+#ifdef XBENCH_CFLAGS
+    s = XBENCH_CFLAGS;
+#else
+    s = getenv("CFLAGS");
+#endif
+    xjson_str(xjson_meta, sizeof(xjson_meta), s != NULL ? s : "");
+
+    XJSON_KEY("cpu");
+    xfile_val("/proc/cpuinfo", "model name", buf, sizeof(buf));
+    xjson_str(xjson_meta, sizeof(xjson_meta), buf);
+    XJSON_KEY("governor");
+    xfile_val("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor",
+        NULL, buf, sizeof(buf));
+    xjson_str(xjson_meta, sizeof(xjson_meta), buf);
+
+    XJSON_KEY("gitrev");
+    s = getenv("XKEM_GITREV");
+    xjson_str(xjson_meta, sizeof(xjson_meta), s != NULL ? s : "unknown");
+    XJSON_KEY("host");
+    if (gethostname(buf, sizeof(buf)) != 0)
+        snprintf(buf, sizeof(buf), "unknown");
+    buf[sizeof(buf) - 1] = 0;
+    xjson_str(xjson_meta, sizeof(xjson_meta), buf);
+    XJSON_KEY("date");
+    t = time(NULL);
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+    xjson_str(xjson_meta, sizeof(xjson_meta), buf);
+
+#undef XJSON_KEY
+}
+
+// common start of a record
+
+static void xjson_head(const xkem_t *k, const char *op)
+{
+    char buf[256];
+
+    buf[0] = 0;
+    xjson_str(buf, sizeof(buf), k->name);
+    fprintf(xjson, "{\"candidate\":%s,\"operation\":\"%s\","
+        "\"pk_bytes\":%d,\"sk_bytes\":%d,\"ct_bytes\":%d,\"ss_bytes\":%d,",
+        buf, op, k->pk_bytes, k->sk_bytes, k->ct_bytes, k->ss_bytes);
+}
+
+// latency record
+
+static void xjson_op(const xkem_t *k, const char *op, const xstat_t *st)
+{
+    int i;
+    const xhist_t *h = &st->h;
+
+    if (xjson == NULL)
+        return;
+
+    xjson_head(k, op);
+    fprintf(xjson, "\"cycles\":%lu,\"seconds\":%.9g,\"iterations\":%lu,"
+        "\"min\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"p999\":%lu,"
+        "\"max\":%lu,\"mean\":%.1f,\"stddev\":%.1f,\"cv\":%.6f,"
+        "\"ci_lo\":%lu,\"ci_hi\":%lu,\"ci_pct\":%.3f,\"converged\":%s,"
+        "\"trimmed_mean\":%.1f,\"outliers\":%lu,\"warmup\":%lu,"
+        "\"migrations\":%lu,\"freq_drift\":%.3f",
+        st->clk, st->sec, st->n, h->min, st->med, xhist_pct(h, 0.90),
+        xhist_pct(h, 0.99), xhist_pct(h, 0.999), h->max,
+        xhist_avg(h), xhist_sd(h), xhist_cv(h),
+        st->ci_lo, st->ci_hi, st->ci, st->conv ? "true" : "false",
+        st->trim, st->outl, st->warm, st->migr, st->drift);
+    if (st->fails >= 0)
+        fprintf(xjson, ",\"fails\":%d", st->fails);
+    for (i = 0; xperf_on && i < XPERF_N; i++) {
+        if (st->pmu[i] >= 0.0)
+            fprintf(xjson, ",\"pmu_%s\":%.1f", xperf_ev[i].name, st->pmu[i]);
     }
+    fprintf(xjson, "%s}\n", xjson_meta);
+    fflush(xjson);
+}
 
-    // test correctness at least once, or loop for a second if fast
+// memory record (xmem_t is defined with the memory test)
 
-    fails = 0;
-    n = 0;
-    tim = clk_now();
-    clk1 = __rdtsc();
+typedef struct xmem_s xmem_t;
+static void xjson_mem(const xkem_t *k, const char *op, long stk,
+    const xmem_t *m);
+
+// batch record
+
+static void xjson_batch(const xkem_t *k, const char *op, size_t n,
+    uint64_t clk, double speedup)
+{
+    if (xjson == NULL)
+        return;
+
+    xjson_head(k, op);
+    fprintf(xjson, "\"batch\":%d,\"native\":%s,\"cycles\":%lu,"
+        "\"speedup\":%.4f%s}\n", (int) n, k->batch ? "true" : "false",
+        clk, speedup, xjson_meta);
+    fflush(xjson);
+}
+
+// expanded key record
+
+static void xjson_expand(const xkem_t *k, const char *op, const char *var,
+    uint64_t clk, double speedup)
+{
+    if (xjson == NULL)
+        return;
+
+    xjson_head(k, op);
+    fprintf(xjson, "\"expand\":\"%s\",\"native\":%s,\"cycles\":%lu,"
+        "\"speedup\":%.4f%s}\n", var, k->expand ? "true" : "false",
+        clk, speedup, xjson_meta);
+    fflush(xjson);
+}
+
+// throughput record
+
+static void xjson_mt(const xkem_t *k, int nthr, double ops, double eff,
+    uint64_t fails, uint64_t dups)
+{
+    if (xjson == NULL)
+        return;
+
+    xjson_head(k, "MT");
+    fprintf(xjson, "\"threads\":%d,\"ops_per_sec\":%.1f,"
+        "\"efficiency\":%.4f,\"fails\":%lu,\"dup_pk\":%lu%s}\n",
+        nthr, ops, eff, fails, dups, xjson_meta);
+    fflush(xjson);
+}
+
+// == multi-threaded throughput test ==
+
+typedef struct {
+    pthread_t thr;
+    const xkem_t *k;
+    int cpu;
+    pthread_barrier_t *bar;
+    volatile int *stop;
+    uint64_t kex, fails, nfpr;
+    uint64_t fpr[XBENCH_MT_FPRS];
+} xmt_t;
+
+// FNV-1a over the public key
+
+static uint64_t xmt_fpr(const uint8_t *p, size_t len)
+{
+    size_t i;
+    uint64_t h = 0xCBF29CE484222325llu;
+
+    for (i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3llu;
+    }
+    return h;
+}
+
+static int xmt_cmp(const void *a, const void *b)
+{
+    uint64_t x = *((const uint64_t *) a), y = *((const uint64_t *) b);
+
+    return x < y ? -1 : x > y;
+}
+
+// worker: full KEX loop on private buffers until told to stop
+
+static void *xmt_worker(void *arg)
+{
+    xmt_t *w = (xmt_t *) arg;
+    const xkem_t *k = w->k;
+    uint8_t *pk, *sk, *ct, *ss0, *ss1;
+
+    pk = (uint8_t *) malloc(k->pk_bytes);
+    sk = (uint8_t *) malloc(k->sk_bytes);
+    ct = (uint8_t *) malloc(k->ct_bytes);
+    ss0 = (uint8_t *) malloc(k->ss_bytes);
+    ss1 = (uint8_t *) malloc(k->ss_bytes);
+    if (pk == NULL || sk == NULL || ct == NULL || ss0 == NULL || ss1 == NULL) {
+        perror("xmt_worker(): malloc()");
+        exit(-1);
+    }
+
+    pthread_barrier_wait(w->bar);
     do {
-        crypto_kem_keypair(pk[0], sk[0]);
-        crypto_kem_enc(ct[0], ss[0], pk[0]);
-        crypto_kem_dec(ss[1], ct[0], sk[0]);
+        k->keypair(pk, sk);
+        k->enc(ct, ss0, pk);
+        k->dec(ss1, ct, sk);
 
-        if (memcmp(ss[0], ss[1], CRYPTO_BYTES) != 0)
-            fails++;
-        n++;
-        clk2 = __rdtsc() - clk1;
-    } while (clk2 < XBENCH_TIMEOUT);
-    tim = (clk_now() - tim) / ((double) n);
-    clk2 /= n;
+        if (memcmp(ss0, ss1, k->ss_bytes) != 0)
+            w->fails++;
+        if (w->nfpr < XBENCH_MT_FPRS)
+            w->fpr[w->nfpr++] = xmt_fpr(pk, k->pk_bytes);
+        w->kex++;
+    } while (!__atomic_load_n(w->stop, __ATOMIC_RELAXED));
 
-    printf("KEX Total   %12lu clk  %12.8f sec\t[%s]\n",
-             clk2, tim, CRYPTO_ALGNAME);
+    free(pk);
+    free(sk);
+    free(ct);
+    free(ss0);
+    free(ss1);
 
-    if (fails > 0)
-        printf("KEM test failed %d/%d time\t[%s]\n", 
-            (int) fails, (int) n, CRYPTO_ALGNAME);
+    return NULL;
+}
+
+// the CPUs in the inherited affinity mask (e.g. taskset -c), in order
 
-    // time keygen
+static int xmt_cpus(int *cpu)
+{
+    int i, n;
+    cpu_set_t cs;
 
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &cs) != 0) {
+        cpu[0] = 0;
+        return 1;
+    }
     n = 0;
+    for (i = 0; i < CPU_SETSIZE && n < CPU_COUNT(&cs); i++) {
+        if (CPU_ISSET(i, &cs))
+            cpu[n++] = i;
+    }
+
+    return n > 0 ? n : 1;
+}
+
+// run nthr workers for XBENCH_MT_MSEC, worker i pinned to cpu[i % ncpu];
+// returns KEX/sec
+
+static double xmt_run(const xkem_t *k, int nthr, const int *cpu, int ncpu,
+    uint64_t *fails, uint64_t *dups)
+{
+    int i;
+    uint64_t j, kex, nfpr;
+    uint64_t *fpr;
+    double tim;
+    xmt_t *w;
+    cpu_set_t cs;
+    pthread_attr_t attr;
+    pthread_barrier_t bar;
+    volatile int stop = 0;
+    struct timespec ts, slp;
+
+    if ((w = (xmt_t *) calloc(nthr, sizeof(xmt_t))) == NULL) {
+        perror("xmt_run(): calloc()");
+        exit(-1);
+    }
+    pthread_barrier_init(&bar, NULL, nthr + 1);
+
+    for (i = 0; i < nthr; i++) {
+        w[i].k = k;
+        w[i].cpu = cpu[i % ncpu];
+        w[i].bar = &bar;
+        w[i].stop = &stop;
+        CPU_ZERO(&cs);
+        CPU_SET(w[i].cpu, &cs);
+        pthread_attr_init(&attr);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cs);
+        if (pthread_create(&w[i].thr, &attr, xmt_worker, &w[i]) != 0) {
+            perror("xmt_run(): pthread_create()");
+            exit(-1);
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    // wall clock here; process CPU time grows with the thread count
+
+    pthread_barrier_wait(&bar);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    tim = ((double) ts.tv_sec) + 1E-9 * ((double) ts.tv_nsec);
+    slp.tv_sec = XBENCH_MT_MSEC / 1000;
+    slp.tv_nsec = (XBENCH_MT_MSEC % 1000) * 1000000;
+    nanosleep(&slp, NULL);
+    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+
+    kex = 0;
+    nfpr = 0;
+    *fails = 0;
+    for (i = 0; i < nthr; i++) {
+        pthread_join(w[i].thr, NULL);
+        kex += w[i].kex;
+        nfpr += w[i].nfpr;
+        *fails += w[i].fails;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    tim = ((double) ts.tv_sec) + 1E-9 * ((double) ts.tv_nsec) - tim;
+    pthread_barrier_destroy(&bar);
+
+    // identical public keys mean that threads got identical "randomness"
+
+    *dups = 0;
+    if ((fpr = (uint64_t *) malloc(nfpr * sizeof(uint64_t) + 1)) == NULL) {
+        perror("xmt_run(): malloc()");
+        exit(-1);
+    }
+    nfpr = 0;
+    for (i = 0; i < nthr; i++) {
+        memcpy(&fpr[nfpr], w[i].fpr, w[i].nfpr * sizeof(uint64_t));
+        nfpr += w[i].nfpr;
+    }
+    qsort(fpr, nfpr, sizeof(uint64_t), xmt_cmp);
+    for (j = 1; j < nfpr; j++) {
+        if (fpr[j] == fpr[j - 1])
+            (*dups)++;
+    }
+    free(fpr);
+    free(w);
+
+    return ((double) kex) / tim;
+}
+
+// scaling test for N = 1, 2, 4, .. maxthr threads
+
+static void xmt_test(const xkem_t *k, int maxthr)
+{
+    int nthr, ncpu;
+    uint64_t fails, dups;
+    double ops, ops1, eff;
+    static int cpu[CPU_SETSIZE];
+
+    ncpu = xmt_cpus(cpu);
+    if (maxthr <= 0)
+        maxthr = ncpu;
+
+    ops1 = 0.0;
+    for (nthr = 1; ; nthr = nthr < maxthr && 2 * nthr > maxthr ?
+        maxthr : 2 * nthr) {
+
+        ops = xmt_run(k, nthr, cpu, ncpu, &fails, &dups);
+        if (nthr == 1)
+            ops1 = ops;
+
+        eff = ops / (ops1 * ((double) nthr));
+        printf("KEX MT %3d thr %12.1f ops/s  eff %6.3f\t[%s]\n",
+            nthr, ops, eff, k->name);
+        xjson_mt(k, nthr, ops, eff, fails, dups);
+        if (fails > 0 || dups > 0) {
+            printf("KEM MT %3d thr FAILED %lu decaps %lu duplicate pk"
+                "\t[%s]\n", nthr, fails, dups, k->name);
+        }
+        fflush(stdout);
+
+        if (nthr >= maxthr)
+            break;
+    }
+}
+
+// == latency benchmark ==
+
+// buffers for XBENCH_REPS sets of keys; ss[reps] is the decapsulated one
+
+typedef struct {
+    int reps;
+    uint8_t **pk, **sk, **ct, **ss;
+    int fails;
+} xbuf_t;
+
+// reps sets of keys (at least one), and at least two shared secrets
+
+static int xbuf_alloc(const xkem_t *k, xbuf_t *b, int reps)
+{
+    int i;
+
+    reps = reps > 1 ? reps : 1;
+    b->reps = reps;
+    b->fails = 0;
+    b->pk = (uint8_t **) calloc(reps, sizeof(uint8_t *));
+    b->sk = (uint8_t **) calloc(reps, sizeof(uint8_t *));
+    b->ct = (uint8_t **) calloc(reps, sizeof(uint8_t *));
+    b->ss = (uint8_t **) calloc(reps + 1, sizeof(uint8_t *));
+    if (b->pk == NULL || b->sk == NULL || b->ct == NULL || b->ss == NULL) {
+        perror("xbuf_alloc(): calloc()");
+        return -1;
+    }
+
+    for (i = 0; i < reps; i++) {
+        b->pk[i] = (uint8_t *) malloc(k->pk_bytes);
+        b->sk[i] = (uint8_t *) malloc(k->sk_bytes);
+        b->ct[i] = (uint8_t *) malloc(k->ct_bytes);
+        b->ss[i] = (uint8_t *) malloc(k->ss_bytes);
+    }
+    b->ss[reps] = (uint8_t *) malloc(k->ss_bytes);
+
+    return 0;
+}
+
+static void xbuf_free(xbuf_t *b)
+{
+    int i;
+
+    for (i = 0; i <= b->reps; i++) {
+        if (i < b->reps) {
+            free(b->pk[i]);
+            free(b->sk[i]);
+            free(b->ct[i]);
+        }
+        free(b->ss[i]);
+    }
+    free(b->pk);
+    free(b->sk);
+    free(b->ct);
+    free(b->ss);
+}
+
+// measured operations
+
+#define XOP_TOTAL   0
+#define XOP_KEYGEN  1
+#define XOP_ENCAPS  2
+#define XOP_DECAPS  3
+
+static void xkem_call(const xkem_t *k, xbuf_t *b, int op, int i)
+{
+    switch (op) {
+
+        case XOP_TOTAL:
+            k->keypair(b->pk[i], b->sk[i]);
+            k->enc(b->ct[i], b->ss[i], b->pk[i]);
+            k->dec(b->ss[b->reps], b->ct[i], b->sk[i]);
+            if (memcmp(b->ss[i], b->ss[b->reps], k->ss_bytes) != 0)
+                b->fails++;
+            break;
+
+        case XOP_KEYGEN:
+            k->keypair(b->pk[i], b->sk[i]);
+            break;
+
+        case XOP_ENCAPS:
+            k->enc(b->ct[i], b->ss[i], b->pk[i]);
+            break;
+
+        case XOP_DECAPS:
+            k->dec(b->ss[i], b->ct[i], b->sk[i]);
+            break;
+    }
+}
+
+// core clock probe: a dependent chain takes a fixed number of core cycles,
+// so its TSC time changes when the core frequency does
+
+static uint64_t xfreq_probe(void)
+{
+    int i, j;
+    uint64_t t, x, best;
+
+    best = UINT64_MAX;
+    for (j = 0; j < 5; j++) {
+        x = j;
+        t = __rdtsc();
+        for (i = 0; i < 200000; i++) {
+            x = x * 3 + 1;
+            __asm__ volatile ("" : "+r" (x));
+        }
+        t = __rdtsc() - t;
+        if (t < best)
+            best = t;
+    }
+    return best;
+}
+
+// 95% distribution-free confidence interval of the median from order
+// statistics: ranks n/2 -+ 0.98 sqrt(n)
+
+static void xhist_med_ci(const xhist_t *h, uint64_t *lo, uint64_t *hi)
+{
+    double n, d;
+
+    n = (double) h->n;
+    d = 0.98 * xsqrt(n);
+    *lo = xhist_pct(h, (0.5 * n - d) / n);
+    *hi = xhist_pct(h, (0.5 * n + d + 1.0) / n);
+}
+
+// warm up, then sample until the median CI is narrower than ci_pct
+// percent (at least XBENCH_MIN_SAMPLES) or XBENCH_TIMEOUT ticks pass
+
+static void xbench_run(const xkem_t *k, xbuf_t *b, int op, xstat_t *st)
+{
+    int i;
+    unsigned int cpu0, cpu1;
+    uint64_t clk1, clk2, t0, t1, chk, f0, f1;
+    double tim;
+    xhist_t *h = &st->h;
+
+    memset(st, 0, offsetof(xstat_t, h));
+    xhist_clear(h);
+
+    // warm caches and branch predictors
+
+    clk1 = __rdtsc();
+    do {
+        for (i = 0; i < b->reps; i++)
+            xkem_call(k, b, op, i);
+        st->warm += b->reps;
+    } while (__rdtsc() - clk1 < XBENCH_WARMUP);
+    b->fails = 0;
+
+    f0 = xfreq_probe();
+    chk = XBENCH_MIN_SAMPLES;
+    xperf_start();
     tim = clk_now();
     clk1 = __rdtsc();
     do {
-        for (i = 0; i < XBENCH_REPS; i++) {
-            crypto_kem_keypair(pk[i], sk[i]);
+        for (i = 0; i < b->reps; i++) {
+            t0 = __rdtscp(&cpu0);
+            xkem_call(k, b, op, i);
+            t1 = __rdtscp(&cpu1);
+
+            // discard samples where the thread moved to another core
+            if (cpu0 != cpu1)
+                st->migr++;
+            else
+                xhist_add(h, t1 - t0);
         }
+        st->n += b->reps;
         clk2 = __rdtsc() - clk1;
-        n += XBENCH_REPS;
+
+        if (h->n >= chk) {
+            st->med = xhist_pct(h, 0.5);
+            xhist_med_ci(h, &st->ci_lo, &st->ci_hi);
+            if (st->med > 0 && 100.0 * ((double) (st->ci_hi - st->ci_lo)) <
+                xbench_ci * ((double) st->med)) {
+                st->conv = 1;
+                break;
+            }
+            chk = h->n + (h->n >> 4) + 1;
+        }
     } while (clk2 < XBENCH_TIMEOUT);
-    tim = (clk_now() - tim) / ((double) n);
-    clk2 /= n;
+    tim = clk_now() - tim;
+    xperf_stop(st->pmu, st->n);
+    f1 = xfreq_probe();
 
-    printf("KEM KeyGen  %12lu clk  %12.8f sec\t[%s]\n", 
-        clk2, tim , CRYPTO_ALGNAME);
+    st->clk = clk2 / st->n;
+    st->sec = tim / ((double) st->n);
+    st->fails = op == XOP_TOTAL ? b->fails : -1;
+    st->drift = 100.0 * ((double) f0 - (double) f1) / ((double) f1);
 
+    st->med = xhist_pct(h, 0.5);
+    xhist_med_ci(h, &st->ci_lo, &st->ci_hi);
+    st->ci = st->med > 0 ? 100.0 * ((double) (st->ci_hi - st->ci_lo)) /
+        ((double) st->med) : 0.0;
+    xhist_far(h, &st->outl, &st->trim);
+}
 
-    // time Encaps
+static void xbench_print(const xkem_t *k, const char *lbl, const char *op,
+    const xstat_t *st)
+{
+    printf("%-12s%12lu clk  %12.8f sec\t[%s]\n", lbl, st->clk, st->sec,
+        k->name);
+    xhist_print(&st->h, op, k->name);
+    printf("CI  %-7s med %lu [%lu, %lu] %.2f%% trim %.0f outl %lu "
+        "warm %lu migr %lu freq %+.2f%%%s%s\t[%s]\n", op,
+        st->med, st->ci_lo, st->ci_hi, st->ci, st->trim, st->outl,
+        st->warm, st->migr, st->drift, st->conv ? "" : " UNSTABLE",
+        st->drift > XBENCH_DRIFT || -st->drift > XBENCH_DRIFT ?
+            " FREQ" : "", k->name);
+    xperf_print(st->pmu, op, k->name);
+    xjson_op(k, op, st);
+}
 
-    n = 0;
-    tim = clk_now();
+static int xkem_bench(const xkem_t *k)
+{
+    int i;
+    xbuf_t b;
+    cpu_set_t cs;
+    static xstat_t st;
+
+    // stay on the current core; migrations are still detected
+
+    if ((i = sched_getcpu()) >= 0) {
+        CPU_ZERO(&cs);
+        CPU_SET(i, &cs);
+        sched_setaffinity(0, sizeof(cpu_set_t), &cs);
+    }
+
+    // multiple of everhthing
+
+    if (xbuf_alloc(k, &b, k->reps) != 0)
+        return -1;
+
+    // test correctness at least once, or loop for a second if fast
+
+    xbench_run(k, &b, XOP_TOTAL, &st);
+    xbench_print(k, "KEX Total", "Total", &st);
+
+    if (st.fails > 0)
+        printf("KEM test failed %d/%d time\t[%s]\n",
+            (int) st.fails, (int) st.n, k->name);
+
+    // time keygen, encaps, decaps
+
+    xbench_run(k, &b, XOP_KEYGEN, &st);
+    xbench_print(k, "KEM KeyGen", "KeyGen", &st);
+
+    xbench_run(k, &b, XOP_ENCAPS, &st);
+    xbench_print(k, "KEM Encaps", "Encaps", &st);
+
+    xbench_run(k, &b, XOP_DECAPS, &st);
+    xbench_print(k, "KEM Decaps", "Decaps", &st);
+
+    xbuf_free(&b);
+
+    return 0;
+}
+
+// == memory footprint ==
+
+// counters for the interposed allocator; only the thread that has
+// xmem_on set is counted
+
+static __thread int xmem_on = 0;
+static __thread uint64_t xmem_cnt, xmem_bytes;
+static __thread int64_t xmem_live, xmem_peak;
+
+#ifndef XBENCH_NOMALLOC
+
+// glibc allocator entry points behind malloc() etc.
+
+extern void *__libc_malloc(size_t n);
+extern void *__libc_calloc(size_t n, size_t m);
+extern void *__libc_realloc(void *p, size_t n);
+extern void *__libc_memalign(size_t a, size_t n);
+extern void __libc_free(void *p);
+
+static void xmem_alloc(void *p)
+{
+    size_t n;
+
+    if (p == NULL)
+        return;
+    n = malloc_usable_size(p);
+    xmem_cnt++;
+    xmem_bytes += n;
+    xmem_live += n;
+    if (xmem_live > xmem_peak)
+        xmem_peak = xmem_live;
+}
+
+static void xmem_free(void *p)
+{
+    if (p != NULL)
+        xmem_live -= malloc_usable_size(p);
+}
+
+void *malloc(size_t n)
+{
+    void *p = __libc_malloc(n);
+
+    if (xmem_on)
+        xmem_alloc(p);
+    return p;
+}
+
+void *calloc(size_t n, size_t m)
+{
+    void *p = __libc_calloc(n, m);
+
+    if (xmem_on)
+        xmem_alloc(p);
+    return p;
+}
+
+void *realloc(void *p, size_t n)
+{
+    if (xmem_on)
+        xmem_free(p);
+    p = __libc_realloc(p, n);
+    if (xmem_on)
+        xmem_alloc(p);
+    return p;
+}
+
+void *memalign(size_t a, size_t n)
+{
+    void *p = __libc_memalign(a, n);
+
+    if (xmem_on)
+        xmem_alloc(p);
+    return p;
+}
+
+void *aligned_alloc(size_t a, size_t n)
+{
+    return memalign(a, n);
+}
+
+int posix_memalign(void **pp, size_t a, size_t n)
+{
+    if ((*pp = memalign(a, n)) == NULL)
+        return ENOMEM;
+    return 0;
+}
+
+void free(void *p)
+{
+    if (xmem_on)
+        xmem_free(p);
+    __libc_free(p);
+}
+
+#endif
+
+// stack painting pattern
+
+#define XMEM_PAINT 0x5A
+
+// one operation on a freshly painted stack
+
+struct xmem_s {
+    const xkem_t *k;
+    xbuf_t *b;
+    int op;
+    uint64_t cnt, bytes;            // heap allocations and bytes
+    int64_t peak;                   // peak live heap bytes
+    long rss0, rss1, hwm;           // resident set before, after, peak (kB)
+};
+
+static void xjson_mem(const xkem_t *k, const char *op, long stk,
+    const xmem_t *m)
+{
+    if (xjson == NULL)
+        return;
+
+    xjson_head(k, op);
+    fprintf(xjson, "\"stack_bytes\":%ld,\"heap_allocs\":%lu,"
+        "\"heap_bytes\":%lu,\"heap_peak\":%ld,\"rss_kb\":%ld,"
+        "\"rss_peak_kb\":%ld%s}\n", stk, m->cnt, m->bytes, m->peak,
+        m->rss1 - m->rss0, m->hwm - m->rss0, xjson_meta);
+    fflush(xjson);
+}
+
+// "VmRSS:" etc. from /proc/self/status, in kB
+
+static long xmem_status(const char *key)
+{
+    char buf[64];
+
+    xfile_val("/proc/self/status", key, buf, sizeof(buf));
+    return atol(buf);
+}
+
+static void *xmem_worker(void *arg)
+{
+    xmem_t *m = (xmem_t *) arg;
+    FILE *f;
+    uint8_t seed[48];
+
+    if (m->op < 0)                  // baseline: thread start only
+        return NULL;
+
+    // per-thread generator setup is not part of the operation
+
+    memset(seed, 0x00, sizeof(seed));
+    m->k->rng_init(seed, NULL, 256);
+
+    // reset the peak RSS (VmHWM) to current, if the kernel allows it
+
+    if ((f = fopen("/proc/self/clear_refs", "w")) != NULL) {
+        fputs("5", f);
+        fclose(f);
+    }
+    m->rss0 = xmem_status("VmRSS");
+
+    xmem_cnt = 0;
+    xmem_bytes = 0;
+    xmem_live = 0;
+    xmem_peak = 0;
+    xmem_on = 1;
+    xkem_call(m->k, m->b, m->op, 0);
+    xmem_on = 0;
+
+    m->rss1 = xmem_status("VmRSS");
+    m->hwm = xmem_status("VmHWM");
+    m->cnt = xmem_cnt;
+    m->bytes = xmem_bytes;
+    m->peak = xmem_peak;
+
+    return NULL;
+}
+
+// run m->op on a thread with a painted XBENCH_STACK byte stack; returns
+// the number of stack bytes touched
+
+static long xmem_run(xmem_t *m)
+{
+    long pg, i;
+    uint8_t *stk;
+    pthread_t thr;
+    pthread_attr_t attr;
+
+    // guard page below the stack
+
+    pg = sysconf(_SC_PAGESIZE);
+    stk = (uint8_t *) mmap(NULL, XBENCH_STACK + pg, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (stk == MAP_FAILED) {
+        perror("xmem_run(): mmap()");
+        return -1;
+    }
+    mprotect(stk, pg, PROT_NONE);
+    memset(stk + pg, XMEM_PAINT, XBENCH_STACK);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stk + pg, XBENCH_STACK);
+    if (pthread_create(&thr, &attr, xmem_worker, m) != 0) {
+        perror("xmem_run(): pthread_create()");
+        exit(-1);
+    }
+    pthread_join(thr, NULL);
+    pthread_attr_destroy(&attr);
+
+    for (i = 0; i < XBENCH_STACK && stk[pg + i] == XMEM_PAINT; i++)
+        ;
+    munmap(stk, XBENCH_STACK + pg);
+
+    return XBENCH_STACK - i;
+}
+
+// peak stack, heap allocations, and RSS growth of KeyGen, Encaps, Decaps
+
+static int xmem_test(const xkem_t *k)
+{
+    int op;
+    long stk, base;
+    xbuf_t b;
+    xmem_t m;
+    static const char *lbl[] = { "Total", "KeyGen", "Encaps", "Decaps" };
+
+    if (xbuf_alloc(k, &b, 1) != 0)
+        return -1;
+
+    // first calls on the main thread (one-time table setup etc.)
+
+    for (op = XOP_KEYGEN; op <= XOP_DECAPS; op++)
+        xkem_call(k, &b, op, 0);
+
+    // thread start and TLS use, subtracted from the rest
+
+    memset(&m, 0, sizeof(m));
+    m.op = -1;
+    base = xmem_run(&m);
+
+    for (op = XOP_KEYGEN; op <= XOP_DECAPS; op++) {
+
+        memset(&m, 0, sizeof(m));
+        m.k = k;
+        m.b = &b;
+        m.op = op;
+        stk = xmem_run(&m) - base;
+
+        printf("MEM %-7s stack %9ld heap %6lu allocs %9lu bytes %9ld peak  "
+            "rss %+ld kB peak %+ld kB\t[%s]\n", lbl[op], stk, m.cnt, m.bytes,
+            m.peak, m.rss1 - m.rss0, m.hwm - m.rss0, k->name);
+        xjson_mem(k, lbl[op], stk, &m);
+    }
+    fflush(stdout);
+    xbuf_free(&b);
+
+    return 0;
+}
+
+// == batch mode ==
+
+// time one batch operation at batch size n; returns median TSC ticks per
+// operation (not per call)
+
+static uint64_t xbatch_time(const xkem_t *k, int op, size_t n,
+    uint8_t *pk, uint8_t *sk, uint8_t *ct, uint8_t *ss)
+{
+    uint64_t clk1, t;
+    static xhist_t hist;
+
+    xhist_clear(&hist);
     clk1 = __rdtsc();
     do {
-        for (i = 0; i < XBENCH_REPS; i++) {
-            crypto_kem_enc(ct[i], ss[i], pk[i]);
+        t = __rdtsc();
+        switch (op) {
+            case XOP_KEYGEN:
+                k->keypair_batch(pk, sk, n);
+                break;
+            case XOP_ENCAPS:
+                k->enc_batch(ct, ss, pk, n);
+                break;
+            case XOP_DECAPS:
+                k->dec_batch(ss, ct, sk, n);
+                break;
         }
-        clk2 = __rdtsc() - clk1;
-        n += XBENCH_REPS;
-    } while (clk2 < XBENCH_TIMEOUT);
-    tim = (clk_now() - tim) / ((double) n);
-    clk2 /= n;
+        xhist_add(&hist, __rdtsc() - t);
+    } while (__rdtsc() - clk1 < XBENCH_TIMEOUT / 4 ||
+        hist.n < XBENCH_MIN_SAMPLES / 4);
 
-    printf("KEM Encaps  %12lu clk  %12.8f sec\t[%s]\n", 
-        clk2, tim, CRYPTO_ALGNAME);
+    return xhist_pct(&hist, 0.5) / n;
+}
 
-    // time Decaps
+// per-operation cost at batch sizes 1, 4, 8, 16, 64 (up to maxb)
 
-    n = 0;
-    tim = clk_now();
+static int xbatch_test(const xkem_t *k, int maxb)
+{
+    static const size_t bsz[] = { 1, 4, 8, 16, 64 };
+    static const char *lbl[] = { "Total", "KeyGen", "Encaps", "Decaps" };
+    size_t i, j, n;
+    int op, fails;
+    uint64_t clk, clk1[4];
+    uint8_t *pk, *sk, *ct, *ss, *ss2;
+
+    for (i = 0; i < sizeof(bsz) / sizeof(bsz[0]); i++) {
+
+        n = bsz[i];
+        if ((int) n > maxb)
+            break;
+
+        pk = (uint8_t *) malloc(n * k->pk_bytes);
+        sk = (uint8_t *) malloc(n * k->sk_bytes);
+        ct = (uint8_t *) malloc(n * k->ct_bytes);
+        ss = (uint8_t *) malloc(n * k->ss_bytes);
+        ss2 = (uint8_t *) malloc(n * k->ss_bytes);
+        if (pk == NULL || sk == NULL || ct == NULL || ss == NULL ||
+            ss2 == NULL) {
+            perror("xbatch_test(): malloc()");
+            return -1;
+        }
+
+        // correctness of the whole batch first
+
+        k->keypair_batch(pk, sk, n);
+        k->enc_batch(ct, ss, pk, n);
+        k->dec_batch(ss2, ct, sk, n);
+        fails = 0;
+        for (j = 0; j < n; j++) {
+            if (memcmp(ss + j * k->ss_bytes, ss2 + j * k->ss_bytes,
+                k->ss_bytes) != 0)
+                fails++;
+        }
+        if (fails > 0) {
+            printf("KEM batch %2d failed %d/%d\t[%s]\n",
+                (int) n, fails, (int) n, k->name);
+        }
+
+        for (op = XOP_KEYGEN; op <= XOP_DECAPS; op++) {
+            clk = xbatch_time(k, op, n, pk, sk, ct, ss2);
+            if (n == 1)
+                clk1[op] = clk;
+            printf("BAT %-7s %2d %12lu clk/op  x%.3f%s\t[%s]\n",
+                lbl[op], (int) n, clk, ((double) clk1[op]) / ((double) clk),
+                k->batch ? "" : " (generic)", k->name);
+            xjson_batch(k, lbl[op], n, clk, ((double) clk1[op]) /
+                ((double) clk));
+        }
+        fflush(stdout);
+
+        free(pk);
+        free(sk);
+        free(ct);
+        free(ss);
+        free(ss2);
+    }
+
+    return 0;
+}
+
+// == expanded keys ==
+
+#define XEXP_PLAIN        0
+#define XEXP_EXPAND_PK    1
+#define XEXP_EXPANDED     2
+#define XEXP_COLD         3
+#define XEXP_WARM         4
+#define XEXP_DEC          5
+#define XEXP_EXPAND_SK    6
+#define XEXP_DEC_EXPANDED 7
+#define XEXP_N            8
+
+static const char *xexp_op[XEXP_N] = { "Encaps", "Expand", "Encaps",
+    "Encaps", "Encaps", "Decaps", "Expand", "Decaps" };
+static const char *xexp_var[XEXP_N] = { "plain", "pk", "expanded",
+    "cold", "warm", "plain", "sk", "expanded" };
+
+// median TSC ticks of each kind of call from var0 on into clk[]. The
+// kinds take turns so that frequency drift affects them alike. The cache
+// is flushed (untimed) before each "cold" call, which leaves pk cached for
+// "warm". Decapsulation uses the ciphertext of the last Encaps.
+
+static void xexp_time(const xkem_t *k, int var0, uint64_t clk[XEXP_N],
+    uint8_t *pk, uint8_t *sk, uint8_t *epk, uint8_t *esk,
+    uint8_t *ct, uint8_t *ss)
+{
+    int var;
+    uint64_t clk1, t;
+    static xhist_t hist[XEXP_N];
+
+    for (var = var0; var < XEXP_N; var++)
+        xhist_clear(&hist[var]);
     clk1 = __rdtsc();
     do {
-        for (i = 0; i < XBENCH_REPS; i++) {
-            crypto_kem_dec(ss[i], ct[i], sk[i]);
+        for (var = var0; var < XEXP_N; var++) {
+            if (var == XEXP_COLD)
+                k->cache_flush();
+            t = __rdtsc();
+            switch (var) {
+                case XEXP_PLAIN:
+                    k->enc(ct, ss, pk);
+                    break;
+                case XEXP_EXPAND_PK:
+                    k->expand_pk(epk, pk);
+                    break;
+                case XEXP_EXPANDED:
+                    k->enc_expanded(ct, ss, epk);
+                    break;
+                case XEXP_COLD:
+                case XEXP_WARM:
+                    k->enc_cached(ct, ss, pk);
+                    break;
+                case XEXP_DEC:
+                    k->dec(ss, ct, sk);
+                    break;
+                case XEXP_EXPAND_SK:
+                    k->expand_sk(esk, sk);
+                    break;
+                case XEXP_DEC_EXPANDED:
+                    k->dec_expanded(ss, ct, esk);
+                    break;
+            }
+            xhist_add(&hist[var], __rdtsc() - t);
         }
-        clk2 = __rdtsc() - clk1;
-        n += XBENCH_REPS;
-    } while (clk2 < XBENCH_TIMEOUT);
-    tim = (clk_now() - tim) / ((double) n);
-    clk2 /= n;
+    } while (__rdtsc() - clk1 < XBENCH_TIMEOUT ||
+        hist[var0].n < XBENCH_MIN_SAMPLES);
+
+    for (var = var0; var < XEXP_N; var++)
+        clk[var] = xhist_pct(&hist[var], 0.5);
+}
+
+// encapsulation to a fixed public key: expanded once, and through the
+// per-thread cache with a cold and a warm cache; decapsulation with a
+// fixed secret key, plain and expanded once. With hot != 0 only the
+// latter ("hot key" decapsulation, the sk loaded once).
+
+static int xexp_test(const xkem_t *k, int hot)
+{
+    int var, var0, fails;
+    double x;
+    char lbl[20];
+    uint64_t clk[XEXP_N];
+    uint8_t *pk, *sk, *epk, *esk, *ct, *ss, *ss2;
 
-    printf("KEM Decaps  %12lu clk  %12.8f sec\t[%s]\n", 
-        clk2, tim, CRYPTO_ALGNAME);
+    // expanded keys are 64-byte (cache line) aligned
+    epk = esk = NULL;
+    if (posix_memalign((void **) &epk, 64, k->epk_bytes) != 0 ||
+        posix_memalign((void **) &esk, 64, k->esk_bytes) != 0) {
+        perror("xexp_test(): posix_memalign()");
+        return -1;
+    }
+    pk = (uint8_t *) malloc(k->pk_bytes);
+    sk = (uint8_t *) malloc(k->sk_bytes);
+    ct = (uint8_t *) malloc(k->ct_bytes);
+    ss = (uint8_t *) malloc(k->ss_bytes);
+    ss2 = (uint8_t *) malloc(k->ss_bytes);
+    if (pk == NULL || sk == NULL || ct == NULL ||
+        ss == NULL || ss2 == NULL) {
+        perror("xexp_test(): malloc()");
+        return -1;
+    }
+
+    // the expanded and cached paths must agree with decapsulation
+
+    var0 = hot ? XEXP_DEC : XEXP_PLAIN;
+    k->cache_flush();
+    k->keypair(pk, sk);
+    k->expand_pk(epk, pk);
+    fails = 0;
+    if (hot)
+        k->enc(ct, ss, pk);
+    for (var = XEXP_EXPANDED; var <= XEXP_WARM && !hot; var++) {
+        if (var == XEXP_EXPANDED)
+            k->enc_expanded(ct, ss, epk);
+        else
+            k->enc_cached(ct, ss, pk);
+        k->dec(ss2, ct, sk);
+        if (memcmp(ss, ss2, k->ss_bytes) != 0)
+            fails++;
+    }
+    if (fails > 0) {
+        printf("KEM expanded pk failed %d/3\t[%s]\n", fails, k->name);
+    }
 
-    // free it
+    // expanded decapsulation must agree with plain, also on a bad ct
+
+    k->expand_sk(esk, sk);
+    fails = 0;
+    k->dec_expanded(ss2, ct, esk);
+    if (memcmp(ss, ss2, k->ss_bytes) != 0)
+        fails++;
+    ct[k->ct_bytes / 2] ^= 0x01;
+    k->dec(ss, ct, sk);
+    k->dec_expanded(ss2, ct, esk);
+    if (memcmp(ss, ss2, k->ss_bytes) != 0)
+        fails++;
+    if (fails > 0) {
+        printf("KEM expanded sk failed %d/2\t[%s]\n", fails, k->name);
+    }
 
-    for (i = 0; i < XBENCH_REPS; i++) {
-        free(pk[i]);
-        free(sk[i]);
-        free(ct[i]);
-        free(ss[i]);
+    xexp_time(k, var0, clk, pk, sk, epk, esk, ct, ss);
+    for (var = var0; var < XEXP_N; var++) {
+        x = ((double) clk[var < XEXP_DEC ? XEXP_PLAIN : XEXP_DEC]) /
+            ((double) clk[var]);
+        snprintf(lbl, sizeof(lbl), "%s %s", xexp_op[var], xexp_var[var]);
+        printf("%s %-16s %12lu clk  x%.3f%s\t[%s]\n",
+            var < XEXP_DEC ? "EPK" : "ESK", lbl, clk[var],
+            x, k->expand ? "" : " (generic)", k->name);
+        xjson_expand(k, xexp_op[var], xexp_var[var], clk[var], x);
     }
+    fflush(stdout);
+
+    free(pk);
+    free(sk);
+    free(epk);
+    free(esk);
+    free(ct);
+    free(ss);
+    free(ss2);
+
     return 0;
 }
+
+// usage: xkem_test [-l] [-r <regex>] [-t [max threads]] [-j <json file>]
+//                  [-c <median CI target %>] [-p] [-b [max batch]] [-m] [-e]
+//                  [-k]
+
+int main(int argc, char **argv)
+{
+    FILE *fd;
+    uint8_t seed[48];
+    int i, mt, lst, pmu, bat, mem, ekey, ret;
+    const char *re;
+    regex_t rx;
+    const xkem_t *k;
+
+    mt = -1;
+    lst = 0;
+    pmu = 0;
+    bat = 0;
+    mem = 0;
+    ekey = 0;
+    re = NULL;
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0) {
+            mt = 0;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                mt = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            re = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0) {
+            lst = 1;
+        } else if (strcmp(argv[i], "-b") == 0) {
+            bat = 64;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                bat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0) {
+            mem = 1;
+        } else if (strcmp(argv[i], "-e") == 0) {
+            ekey = 1;
+        } else if (strcmp(argv[i], "-k") == 0) {
+            ekey = 2;
+        } else if (strcmp(argv[i], "-p") == 0) {
+            pmu = 1;
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            xbench_ci = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            if ((xjson = fopen(argv[++i], "a")) == NULL) {
+                perror(argv[i]);
+                return -1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [-l] [-r <regex>] [-t [threads]] "
+                "[-j <json file>] [-c <ci %%>] [-p] [-b [max batch]] [-m] "
+                "[-e] [-k]\n",
+                argv[0]);
+            return -1;
+        }
+    }
+    if (xjson != NULL)
+        xjson_init();
+    if (pmu && mt < 0)
+        xperf_open();
+    if (re != NULL && regcomp(&rx, re, REG_EXTENDED | REG_NOSUB) != 0) {
+        fprintf(stderr, "%s: bad regex '%s'\n", argv[0], re);
+        return -1;
+    }
+
+    // init random with random
+
+    memset(seed, 0x00, sizeof(seed));
+    if ((fd = fopen("/dev/urandom", "r")) == NULL ||
+        fread(seed, 1, 48, fd) != 48)
+    {
+        perror("/dev/urandom");
+        return -1;
+    }
+    fclose(fd);
+
+    ret = 0;
+    for (i = 0; xkem_reg[i] != NULL; i++) {
+
+        k = xkem_reg[i];
+        if (re != NULL && regexec(&rx, k->name, 0, NULL, 0) != 0)
+            continue;
+        if (lst) {
+            printf("%s\n", k->name);
+            continue;
+        }
+
+        printf("CRYPTO_PUBLICKEYBYTES\t%8d\t\t[%s]\n", 
+                k->pk_bytes, k->name);
+        printf("CRYPTO_SECRETKEYBYTES\t%8d\t\t[%s]\n", 
+                k->sk_bytes, k->name);
+        printf("CRYPTO_CIPHERTEXTBYTES\t%8d\t\t[%s]\n", 
+                k->ct_bytes, k->name);
+        printf("CRYPTO_BYTES\t\t%8d\t\t[%s]\n", 
+                k->ss_bytes, k->name);
+
+        k->rng_init(seed, NULL, 256);
+
+        if (mt >= 0) {
+            xmt_test(k, mt);
+        } else if (mem) {
+            if (xmem_test(k) != 0)
+                ret = -1;
+        } else if (ekey) {
+            if (xexp_test(k, ekey == 2) != 0)
+                ret = -1;
+        } else if (bat > 0) {
+            if (xbatch_test(k, bat) != 0)
+                ret = -1;
+        } else if (xkem_bench(k) != 0) {
+            ret = -1;
+        }
+        fflush(stdout);
+    }
+    if (re != NULL)
+        regfree(&rx);
+    if (xjson != NULL)
+        fclose(xjson);
+
+    return ret;
+}
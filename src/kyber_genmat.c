@@ -0,0 +1,74 @@
+// kyber_genmat.c
+// 2018-05-14  Markku-Juhani O. Saarinen <mjos@iki.fi>
+
+// gen_matrix() micro-benchmark for the Kyber candidates. Takes the place of
+// kem_test.c: in round1/kem/kyber*, run
+//   XKEM_SRC=../../../src/kyber_genmat.c XKEM_BIN=genmat ./build_test.sh
+// Checks the 4-way path against gen_matrix_ref() and prints "GEN" lines.
+
+#include <string.h>
+
+#include "xbench.h"
+#include "api.h"
+#include "polyvec.h"
+#include "keccakx.h"
+
+#ifndef XBENCH_GENMAT
+#define XBENCH_GENMAT 1001
+#endif
+
+#ifndef CRYPTO_ALGNAME
+#define CRYPTO_ALGNAME "Kyber"
+#endif
+
+void gen_matrix(polyvec *a, const unsigned char *seed, int transposed);
+void gen_matrix_ref(polyvec *a, const unsigned char *seed, int transposed);
+
+typedef void (*gen_matrix_t)(polyvec *, const unsigned char *, int);
+
+// median cycles of XBENCH_GENMAT calls, on a new seed each time
+
+static uint64_t genmat_time(gen_matrix_t f, int transposed)
+{
+    int i;
+    uint64_t clk[XBENCH_GENMAT];
+    unsigned char seed[32];
+    polyvec a[KYBER_K];
+
+    memset(seed, 0, sizeof(seed));
+    XBENCH_CLK(clk, XBENCH_GENMAT, i, memcpy(seed, &i, sizeof(i)),
+        f(a, seed, transposed));
+
+    return xbench_median(clk, XBENCH_GENMAT);
+}
+
+int main()
+{
+    int i, tr, fail;
+    unsigned char seed[32];
+    polyvec a[KYBER_K], b[KYBER_K];
+
+    fail = 0;
+    for (i = 0; i < 1000; i++) {
+        memset(seed, i & 0xFF, sizeof(seed));
+        seed[0] = i >> 8;
+        for (tr = 0; tr < 2; tr++) {
+            gen_matrix_ref(a, seed, tr);
+            gen_matrix(b, seed, tr);
+            if (memcmp(a, b, sizeof(a)) != 0)
+                fail++;
+        }
+    }
+    if (fail) {
+        printf("GEN gen_matrix differs from reference %d/2000\t[%s]\n",
+            fail, CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    for (tr = 0; tr < 2; tr++) {
+        xbench_print("GEN", tr ? "A^T" : "A", genmat_time(gen_matrix_ref, tr),
+            keccakx_impl(), genmat_time(gen_matrix, tr), CRYPTO_ALGNAME);
+    }
+
+    return 0;
+}
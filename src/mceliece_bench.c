@@ -0,0 +1,330 @@
+// mceliece_bench.c
+// 2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+
+// Decoding, encapsulation and key generation micro-benchmark for the
+// Classic McEliece candidates. Takes the place of kem_test.c: in
+// round1/kem/mceliece6960119 or mceliece8192128,
+//   XKEM_SRC=../../../src/mceliece_bench.c XKEM_BIN=mbench ./build_test.sh
+// On a fresh key, checks the bitsliced additive FFT (fft.c) against
+// eval(), and root_fft() and synd_fft() against root() and synd() ("FFT"
+// lines), then syndrome() on pk and on the expanded pk against
+// syndrome_ref() ("ENC" lines; -DENCRYPT_REF for the portable 64-bit
+// path), and pk_gen() (heap matrix) against pk_gen_ref() ("KEYGEN" lines;
+// -DPK_GEN_M4R for the m4r.c elimination, -DM4R_THREADS=n for threads).
+
+#include <string.h>
+
+#include "xbench.h"
+#include "api.h"
+#include "rng.h"
+#include "params.h"
+#include "benes.h"
+#include "root.h"
+#include "synd.h"
+#include "util.h"
+#include "fft.h"
+#include "encrypt.h"
+#include "encrypt_avx2.h"
+#include "sk_gen.h"
+#include "pk_gen.h"
+
+#ifndef XBENCH_FFT
+#define XBENCH_FFT 101
+#endif
+
+#ifndef XBENCH_ENC
+#define XBENCH_ENC 101
+#endif
+
+#ifndef XBENCH_KEYGEN
+#define XBENCH_KEYGEN 5
+#endif
+
+static unsigned char mb_pk[CRYPTO_PUBLICKEYBYTES];
+static unsigned char mb_sk[CRYPTO_SECRETKEYBYTES];
+static unsigned char mb_e[SYS_N / 8];
+
+// a random error vector of weight SYS_T
+
+static void mb_weight(unsigned char *e)
+{
+    int i, n;
+
+    memset(e, 0, SYS_N / 8);
+    for (n = 0; n < SYS_T; ) {
+        i = rand() % SYS_N;
+        if ((e[i / 8] >> (i % 8)) & 1)
+            continue;
+        e[i / 8] |= 1 << (i % 8);
+        n++;
+    }
+}
+
+// == decoding: root_fft() and synd_fft() ==
+
+static const unsigned char *fft_cond;
+static gf fft_g[SYS_T + 1], fft_f[SYS_T + 1];
+static gf fft_L[SYS_N], fft_img[SYS_N];
+static gf fft_s[2 * SYS_T], fft_t[2 * SYS_T];
+static vec fft_v[FFT_WORDS][GFBITS], fft_ginv[FFT_WORDS][GFBITS];
+static unsigned char fft_r[SYS_N / 8];
+
+// a random polynomial of degree SYS_T, or one with roots L[i] for the bits
+// of e (SYS_T of them)
+
+static void fft_rand(gf *f, const unsigned char *e)
+{
+    int i, j, n;
+
+    if (e == NULL) {
+        for (i = 0; i < SYS_T; i++)
+            f[i] = rand() & GFMASK;
+        f[SYS_T] = 1;
+        return;
+    }
+
+    memset(f, 0, (SYS_T + 1) * sizeof(gf));
+    f[0] = 1;
+    n = 0;
+    for (i = 0; i < SYS_N; i++) {
+        if (((e[i / 8] >> (i % 8)) & 1) == 0)
+            continue;
+        for (j = ++n; j > 0; j--)
+            f[j] = f[j - 1] ^ gf_mul(f[j], fft_L[i]);
+        f[0] = gf_mul(f[0], fft_L[i]);
+    }
+}
+
+static void fft_ginv_set()
+{
+    int i;
+
+    fft(fft_ginv, fft_g);
+    for (i = 0; i < FFT_WORDS; i++) {
+        vec_sq(fft_ginv[i], fft_ginv[i]);
+        vec_inv(fft_ginv[i], fft_ginv[i]);
+    }
+}
+
+// the operations timed
+
+static void root_ref_op()
+{
+    int i;
+
+    root(fft_img, fft_f, fft_L);
+    memset(fft_r, 0, sizeof(fft_r));
+    for (i = 0; i < SYS_N; i++)
+        fft_r[i / 8] |= (gf_iszero(fft_img[i]) & 1) << (i % 8);
+}
+
+static void root_fft_op()
+{
+    root_fft(fft_r, fft_f, fft_cond);
+}
+
+static void synd_ref_op()
+{
+    synd(fft_s, fft_g, fft_L, mb_e);
+}
+
+static void synd_fft_op()
+{
+    fft_ginv_set();
+    synd_fft(fft_t, fft_ginv, fft_cond, mb_e);
+}
+
+static uint64_t fft_time(void (*f)())
+{
+    int i;
+    uint64_t clk[XBENCH_FFT];
+
+    XBENCH_CLK(clk, XBENCH_FFT, i, (void) 0, f());
+
+    return xbench_median(clk, XBENCH_FFT);
+}
+
+static int fft_test(void)
+{
+    int i, j, k, fail[3];
+    gf a;
+
+    for (i = 0; i < SYS_T; i++)
+        fft_g[i] = load2(mb_sk + SYS_N / 8 + 2 * i);
+    fft_g[SYS_T] = 1;
+    fft_cond = mb_sk + SYS_N / 8 + IRR_BYTES;
+    support_gen(fft_L, fft_cond);
+    fft_ginv_set();
+
+    memset(fail, 0, sizeof(fail));
+    for (k = 0; k < 10; k++) {
+
+        // fft() at all field elements
+        fft_rand(fft_f, NULL);
+        fft(fft_v, fft_f);
+        for (i = 0; i < (1 << GFBITS); i++) {
+            a = 0;
+            for (j = 0; j < GFBITS; j++)
+                a |= ((fft_v[i / 64][j] >> (i % 64)) & 1) << j;
+            if (a != eval(fft_f, bitrev(i))) {
+                fail[0]++;
+                break;
+            }
+        }
+
+        // root_fft() with SYS_T roots in the support
+        mb_weight(mb_e);
+        fft_rand(fft_f, mb_e);
+        root_fft_op();
+        fail[1] += memcmp(fft_r, mb_e, sizeof(fft_r)) != 0;
+        root_ref_op();
+        fail[1] += memcmp(fft_r, mb_e, sizeof(fft_r)) != 0;
+
+        // synd_fft() of a random word
+        xbench_rand(mb_e, sizeof(mb_e));
+        synd_ref_op();
+        synd_fft_op();
+        fail[2] += memcmp(fft_s, fft_t, sizeof(fft_s)) != 0;
+    }
+    if (fail[0] | fail[1] | fail[2]) {
+        printf("FFT differs from reference: "
+            "fft %d/10, root %d/20, synd %d/10\t[%s]\n",
+            fail[0], fail[1], fail[2], CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    xbench_print("FFT", "root", fft_time(root_ref_op),
+        "fft", fft_time(root_fft_op), CRYPTO_ALGNAME);
+    xbench_print("FFT", "synd", fft_time(synd_ref_op),
+        "fft", fft_time(synd_fft_op), CRYPTO_ALGNAME);
+
+    return 0;
+}
+
+// == encapsulation: syndrome() ==
+
+static unsigned char enc_epk[CRYPTO_EXPANDEDPKBYTES]
+    __attribute__ ((aligned (64)));
+static unsigned char enc_s[SYND_BYTES], enc_t[SYND_BYTES];
+
+static uint64_t enc_time(void (*f)(unsigned char *, const unsigned char *,
+    unsigned char *), const unsigned char *pk)
+{
+    int i;
+    uint64_t clk[XBENCH_ENC];
+
+    XBENCH_CLK(clk, XBENCH_ENC, i, (void) 0, f(enc_s, pk, mb_e));
+
+    return xbench_median(clk, XBENCH_ENC);
+}
+
+static int enc_test(void)
+{
+    int i, fail[2];
+    const char *impl = encrypt_avx2_init() ? "avx2" : "w64";
+
+    crypto_kem_expand_pk(enc_epk, mb_pk);
+
+    memset(fail, 0, sizeof(fail));
+    for (i = 0; i < 20; i++) {
+        if (i < 10)
+            mb_weight(mb_e);
+        else
+            xbench_rand(mb_e, sizeof(mb_e));
+        syndrome_ref(enc_s, mb_pk, mb_e);
+        syndrome(enc_t, mb_pk, mb_e);
+        fail[0] += memcmp(enc_s, enc_t, SYND_BYTES) != 0;
+        syndrome_expanded(enc_t, enc_epk, mb_e);
+        fail[1] += memcmp(enc_s, enc_t, SYND_BYTES) != 0;
+    }
+    if (fail[0] | fail[1]) {
+        printf("ENC differs from reference: pk %d/20, epk %d/20\t[%s]\n",
+            fail[0], fail[1], CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    mb_weight(mb_e);
+    xbench_print("ENC", "pk", enc_time(syndrome_ref, mb_pk),
+        impl, enc_time(syndrome, mb_pk), CRYPTO_ALGNAME);
+    xbench_print("ENC", "epk", enc_time(syndrome_ref, mb_pk),
+        impl, enc_time(syndrome_expanded, enc_epk), CRYPTO_ALGNAME);
+
+    return 0;
+}
+
+// == key generation: pk_gen() ==
+
+#ifdef PK_GEN_M4R
+#define KEYGEN_IMPL "m4r"
+#else
+#define KEYGEN_IMPL "w64"
+#endif
+
+static unsigned char key_pk[CRYPTO_PUBLICKEYBYTES];
+
+// a secret key (g, controlbits) for which the public key is systematic
+
+static void key_new(void)
+{
+    do {
+        sk_gen(mb_sk);
+    } while (pk_gen_ref(mb_pk, mb_sk + SYS_N / 8) != 0);
+}
+
+static int keygen_test(void)
+{
+    int i, n, fail, nsys;
+    uint64_t t, clk[2][XBENCH_KEYGEN];
+
+    fail = 0;
+    nsys = 0;
+    for (n = 0; n < XBENCH_KEYGEN; n++) {
+        key_new();
+        t = __rdtsc();
+        pk_gen_ref(mb_pk, mb_sk + SYS_N / 8);
+        clk[0][n] = __rdtsc() - t;
+        t = __rdtsc();
+        i = pk_gen(key_pk, mb_sk + SYS_N / 8);
+        clk[1][n] = __rdtsc() - t;
+        fail += i != 0 || memcmp(mb_pk, key_pk, CRYPTO_PUBLICKEYBYTES) != 0;
+    }
+
+    // both must also agree on the keys that are not systematic
+    for (n = 0; n < 4 * XBENCH_KEYGEN; n++) {
+        sk_gen(mb_sk);
+        i = pk_gen_ref(mb_pk, mb_sk + SYS_N / 8);
+        nsys += i == 0;
+        fail += i != pk_gen(key_pk, mb_sk + SYS_N / 8);
+    }
+
+    if (fail) {
+        printf("KEYGEN pk_gen differs from pk_gen_ref: %d/%d\t[%s]\n",
+            fail, 5 * XBENCH_KEYGEN, CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    printf("KEYGEN %d/%d random keys systematic\t[%s]\n",
+        nsys, 4 * XBENCH_KEYGEN, CRYPTO_ALGNAME);
+    xbench_print("KEYGEN", "pk_gen", xbench_median(clk[0], XBENCH_KEYGEN),
+        KEYGEN_IMPL, xbench_median(clk[1], XBENCH_KEYGEN), CRYPTO_ALGNAME);
+
+    return 0;
+}
+
+int main()
+{
+    unsigned char seed[48];
+
+    memset(seed, 0, sizeof(seed));
+    randombytes_init(seed, NULL, 256);
+    if (crypto_kem_keypair(mb_pk, mb_sk) != 0) {
+        printf("keypair failed\t[%s]\n", CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    srand(1);
+    if (fft_test() != 0 || enc_test() != 0 || keygen_test() != 0)
+        return 1;
+
+    return 0;
+}
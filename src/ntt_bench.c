@@ -0,0 +1,189 @@
+// ntt_bench.c
+// 2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+
+// NTT micro-benchmark for the Kyber and NewHope candidates. Takes the place
+// of kem_test.c: in round1/kem/kyber* or round1/kem/newhope*, run
+//   XKEM_SRC=../../../src/ntt_bench.c XKEM_BIN=nttb ./build_test.sh
+// Checks the dispatched forward and inverse NTT and pointwise product
+// against the portable code (modulo q, as the portable code reduces
+// lazily) and prints "NTT" lines.
+
+#include <string.h>
+
+#include "xbench.h"
+#include "api.h"
+#include "params.h"
+#include "ntt.h"
+
+#ifndef XBENCH_NTT
+#define XBENCH_NTT 10001
+#endif
+
+#if defined(KYBER_N)
+
+#include "polyvec.h"
+
+#define NTT_N KYBER_N
+#define NTT_Q KYBER_Q
+#define NTT_VEC KYBER_K
+
+#ifndef CRYPTO_ALGNAME
+#define CRYPTO_ALGNAME "Kyber"
+#endif
+
+// r = sum a[i] * b[i], over NTT_VEC polynomials
+static void mul_fast(uint16_t *r, const uint16_t *a, const uint16_t *b)
+{
+    polyvec_pointwise_acc((poly *) r, (const polyvec *) a,
+        (const polyvec *) b);
+}
+
+static void mul_ref(uint16_t *r, const uint16_t *a, const uint16_t *b)
+{
+    polyvec_pointwise_acc_ref((poly *) r, (const polyvec *) a,
+        (const polyvec *) b);
+}
+
+#define fwd_fast ntt
+#define fwd_ref ntt_ref
+#define inv_fast invntt
+#define inv_ref invntt_ref
+
+#elif defined(NEWHOPE_N)
+
+#include "poly.h"
+
+#define NTT_N NEWHOPE_N
+#define NTT_Q NEWHOPE_Q
+#define NTT_VEC 1
+
+#ifndef CRYPTO_ALGNAME
+#define CRYPTO_ALGNAME "NewHope"
+#endif
+
+static void mul_fast(uint16_t *r, const uint16_t *a, const uint16_t *b)
+{
+    poly_mul_pointwise((poly *) r, (const poly *) a, (const poly *) b);
+}
+
+static void mul_ref(uint16_t *r, const uint16_t *a, const uint16_t *b)
+{
+    poly_mul_pointwise_ref((poly *) r, (const poly *) a, (const poly *) b);
+}
+
+#define fwd_fast ntt_forward
+#define fwd_ref ntt_forward_ref
+#define inv_fast ntt_inverse
+#define inv_ref ntt_inverse_ref
+
+#else
+#error "ntt_bench.c needs a Kyber or NewHope parameter set"
+#endif
+
+typedef void (*ntt_t)(uint16_t *);
+typedef void (*mul_t)(uint16_t *, const uint16_t *, const uint16_t *);
+
+static uint16_t ntt_a[NTT_VEC * NTT_N] __attribute__ ((aligned (32)));
+static uint16_t ntt_b[NTT_VEC * NTT_N] __attribute__ ((aligned (32)));
+static uint16_t ntt_x[NTT_VEC * NTT_N] __attribute__ ((aligned (32)));
+static uint16_t ntt_y[NTT_VEC * NTT_N] __attribute__ ((aligned (32)));
+
+// random coefficients in [0, m)
+
+static void ntt_rand(uint16_t *p, size_t n, uint32_t m)
+{
+    size_t i;
+
+    xbench_rand(p, n * sizeof(uint16_t));
+    for (i = 0; i < n; i++)
+        p[i] %= m;
+}
+
+// number of coefficients that differ modulo q
+
+static int ntt_diff(const uint16_t *x, const uint16_t *y, size_t n)
+{
+    size_t i;
+    int d = 0;
+
+    for (i = 0; i < n; i++)
+        d += (x[i] % NTT_Q) != (y[i] % NTT_Q);
+
+    return d;
+}
+
+// median cycles of XBENCH_NTT calls; f == NULL times the product g
+
+static uint64_t ntt_time(ntt_t f, mul_t g)
+{
+    int i;
+    uint64_t t, *clk;
+
+    clk = calloc(XBENCH_NTT, sizeof(uint64_t));
+    if (clk == NULL)
+        return 0;
+    ntt_rand(ntt_a, NTT_VEC * NTT_N, NTT_Q);
+    ntt_rand(ntt_b, NTT_VEC * NTT_N, NTT_Q);
+    if (f != NULL) {
+        XBENCH_CLK(clk, XBENCH_NTT, i,
+            memcpy(ntt_x, ntt_a, NTT_N * sizeof(uint16_t)), f(ntt_x));
+    } else {
+        XBENCH_CLK(clk, XBENCH_NTT, i, (void) 0, g(ntt_x, ntt_a, ntt_b));
+    }
+    t = xbench_median(clk, XBENCH_NTT);
+    free(clk);
+
+    return t;
+}
+
+static void ntt_report(const char *name, ntt_t f, ntt_t f_ref,
+    mul_t g, mul_t g_ref)
+{
+    uint64_t ref;
+
+    ref = ntt_time(f_ref, g_ref);
+    xbench_print("NTT", name, ref, ntt_impl(), ntt_time(f, g),
+        CRYPTO_ALGNAME);
+}
+
+int main()
+{
+    int i, fail[3];
+
+    srand(1);
+    memset(fail, 0, sizeof(fail));
+    for (i = 0; i < 1000; i++) {
+
+        ntt_rand(ntt_a, NTT_N, NTT_Q);
+        memcpy(ntt_x, ntt_a, NTT_N * sizeof(uint16_t));
+        memcpy(ntt_y, ntt_a, NTT_N * sizeof(uint16_t));
+        fwd_ref(ntt_x);
+        fwd_fast(ntt_y);
+        fail[0] += ntt_diff(ntt_x, ntt_y, NTT_N) != 0;
+
+        memcpy(ntt_x, ntt_a, NTT_N * sizeof(uint16_t));
+        memcpy(ntt_y, ntt_a, NTT_N * sizeof(uint16_t));
+        inv_ref(ntt_x);
+        inv_fast(ntt_y);
+        fail[1] += ntt_diff(ntt_x, ntt_y, NTT_N) != 0;
+
+        // NewHope's poly_uniform() leaves coefficients below 5q
+        ntt_rand(ntt_a, NTT_VEC * NTT_N, 5 * NTT_Q);
+        ntt_rand(ntt_b, NTT_VEC * NTT_N, NTT_Q);
+        mul_ref(ntt_x, ntt_a, ntt_b);
+        mul_fast(ntt_y, ntt_a, ntt_b);
+        fail[2] += ntt_diff(ntt_x, ntt_y, NTT_N) != 0;
+    }
+    if (fail[0] | fail[1] | fail[2]) {
+        printf("NTT %s differs from reference: "
+            "ntt %d/1000, invntt %d/1000, pointwise %d/1000\t[%s]\n",
+            ntt_impl(), fail[0], fail[1], fail[2], CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    ntt_report("ntt", fwd_fast, fwd_ref, NULL, NULL);
+    ntt_report("invntt", inv_fast, inv_ref, NULL, NULL);
+    ntt_report("pointwise", NULL, NULL, mul_fast, mul_ref);
+
+    return 0;
+}
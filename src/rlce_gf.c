@@ -0,0 +1,142 @@
+// rlce_gf.c
+// 2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+
+// GF(2^m) vector arithmetic micro-benchmark for the RLCE candidates. Takes
+// the place of kem_test.c: in round1/kem/RLCE_KEM_128A (or any RLCE_KEM_*),
+//   XKEM_SRC=../../../src/rlce_gf.c XKEM_BIN=rgf ./build_test.sh
+// Checks the VPSHUFB scalar-times-vector and vector-times-matrix products
+// (GaloisField_avx2.c) against the GFmulTable lookups of GaloisField.c,
+// for every scalar and for a public-key sized matrix, and prints "GF"
+// lines.
+
+#include <string.h>
+
+#include "xbench.h"
+#include "api.h"
+#include "rlce.h"
+
+#ifndef RLCE_GF_AVX2
+#error "rlce_gf.c needs the AVX2 kernels (x86, no -DRLCE_GF_REF)"
+#endif
+
+#ifndef XBENCH_GF
+#define XBENCH_GF 101
+#endif
+
+static unsigned int gf_m;
+static matrix_t gf_b;
+static field_t *gf_v, *gf_x, *gf_y;
+
+static void gf_rand(field_t *v, int n)
+{
+    int i;
+
+    xbench_rand(v, n * sizeof(field_t));
+    for (i = 0; i < n; i++)
+        v[i] &= fieldOrder[gf_m];
+}
+
+// the GF_mulvec() and matrix_vec_mat_mul_standard() table code
+
+static void mulvec_ref(field_t *dest)
+{
+    int i;
+
+    for (i = 0; i < gf_b->numC; i++)
+        dest[i] = GFmulTable[gf_m][gf_v[0]][gf_b->data[0][i]];
+}
+
+static void mulvec_avx2(field_t *dest)
+{
+    GF_mulvec_avx2(gf_v[0], gf_b->data[0], dest, gf_b->numC, gf_m);
+}
+
+static void vecmat_ref(field_t *dest)
+{
+    int i, j;
+    field_t *x = calloc(gf_b->numC, sizeof(field_t));
+
+    memset(dest, 0, gf_b->numC * sizeof(field_t));
+    for (i = 0; i < gf_b->numR; i++) {
+        if (gf_v[i] != 0) {
+            for (j = 0; j < gf_b->numC; j++)
+                x[j] = GFmulTable[gf_m][gf_v[i]][gf_b->data[i][j]];
+            GF_addvec(x, dest, NULL, gf_b->numC);
+        }
+    }
+    free(x);
+}
+
+static void vecmat_avx2(field_t *dest)
+{
+    GF_vecmat_avx2(gf_v, gf_b->numR, gf_b->data, dest, gf_b->numC, gf_m);
+}
+
+static uint64_t gf_time(void (*f)(field_t *))
+{
+    int i;
+    uint64_t clk[XBENCH_GF];
+
+    XBENCH_CLK(clk, XBENCH_GF, i, (void) 0, f(gf_x));
+
+    return xbench_median(clk, XBENCH_GF);
+}
+
+static void gf_print(const char *name, uint64_t ref, uint64_t fast)
+{
+    xbench_print("GF", name, ref, "avx2", fast, CRYPTO_ALGNAME);
+}
+
+int main()
+{
+    unsigned int para[PARASIZE];
+    int i, k, nc, fail[2];
+
+    if (!GF_avx2_init()) {
+        printf("GF no AVX2\t[%s]\n", CRYPTO_ALGNAME);
+        return 0;
+    }
+
+    // the public key G is k x (n + w - k)
+    getRLCEparameters(para, CRYPTO_SCHEME, CRYPTO_PADDING);
+    gf_m = para[3];
+    k = para[1];
+    nc = para[0] + para[2] - k;
+    GF_init_mult_table(gf_m);
+    gf_b = matrix_init(k, nc);
+    gf_v = calloc(k, sizeof(field_t));
+    gf_x = calloc(nc, sizeof(field_t));
+    gf_y = calloc(nc, sizeof(field_t));
+
+    srand(1);
+    memset(fail, 0, sizeof(fail));
+    for (i = 0; i < k; i++)
+        gf_rand(gf_b->data[i], nc);
+    for (i = 0; i < fieldSize[gf_m]; i++) {
+        gf_v[0] = i;
+        mulvec_ref(gf_x);
+        mulvec_avx2(gf_y);
+        fail[0] += memcmp(gf_x, gf_y, nc * sizeof(field_t)) != 0;
+    }
+    for (i = 0; i < 10; i++) {
+        gf_rand(gf_v, k);
+        vecmat_ref(gf_x);
+        vecmat_avx2(gf_y);
+        fail[1] += memcmp(gf_x, gf_y, nc * sizeof(field_t)) != 0;
+    }
+    if (fail[0] | fail[1]) {
+        printf("GF avx2 differs from reference: x*v %d/%d, v*G %d/10\t[%s]\n",
+            fail[0], fieldSize[gf_m], fail[1], CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    gf_print("x*v", gf_time(mulvec_ref), gf_time(mulvec_avx2));
+    gf_print("v*G", gf_time(vecmat_ref), gf_time(vecmat_avx2));
+
+    matrix_free(gf_b);
+    free(gf_v);
+    free(gf_x);
+    free(gf_y);
+
+    return 0;
+}
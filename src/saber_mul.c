@@ -0,0 +1,146 @@
+// saber_mul.c
+// 2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+
+// Polynomial multiplication micro-benchmark for the Saber candidates. Takes
+// the place of kem_test.c: in round1/kem/saber, light_saber or fire_saber,
+//   XKEM_SRC=../../../src/saber_mul.c XKEM_BIN=smul ./build_test.sh
+// Checks the AVX2 multiplier (poly_mul_avx2.c) against the schoolbook
+// pol_mul(), and the matrix-vector product with it against the original
+// Toom-4 code, and prints "MUL" lines.
+
+#include <string.h>
+
+#include "xbench.h"
+#include "api.h"
+#include "poly.h"
+#include "poly_mul_avx2.h"
+
+#ifndef SABER_MUL_AVX2
+#error "saber_mul.c needs the AVX2 multiplier (x86, no -DSABER_MUL_REF)"
+#endif
+
+#ifndef XBENCH_MUL
+#define XBENCH_MUL 1001
+#endif
+
+#ifndef CRYPTO_ALGNAME
+#define CRYPTO_ALGNAME "Saber"
+#endif
+
+// in SABER_indcpa.c
+void pol_mul(uint16_t* a, uint16_t* b, uint16_t* res, uint16_t p,
+    uint32_t n, uint32_t start);
+void toom_cook_4way(uint16_t* a1, uint16_t* b1, uint16_t* result,
+    uint64_t p_mod, uint16_t n);
+void MatrixVectorMul(polyvec *a, uint16_t skpv[SABER_K][SABER_N],
+    const toom4_eval_t *skev, uint16_t res[SABER_K][SABER_N],
+    uint16_t mod, int16_t transpose);
+const toom4_eval_t *EvalVector(toom4_eval_t skev[SABER_K],
+    uint16_t skpv[SABER_K][SABER_N]);
+
+static polyvec mul_a[SABER_K];
+static uint16_t mul_s[SABER_K][SABER_N];
+static toom4_eval_t mul_skev[SABER_K];
+static uint16_t mul_x[SABER_K][SABER_N], mul_y[SABER_K][SABER_N];
+
+// one product, res = a * b mod (x^n + 1, q)
+
+static void mul_ref(uint16_t *res, uint16_t *a, uint16_t *b)
+{
+    toom_cook_4way(a, b, res, SABER_Q, SABER_N);
+}
+
+static void mul_fast(uint16_t *res, uint16_t *a, uint16_t *b)
+{
+    toom4_eval_t ae, be;
+    toom4_acc_t acc;
+
+    toom4_eval_avx2(&ae, a);
+    toom4_eval_avx2(&be, b);
+    memset(&acc, 0, sizeof(acc));
+    toom4_mac_avx2(&acc, &ae, &be);
+    memset(res, 0, SABER_N * sizeof(uint16_t));
+    toom4_interp_avx2(res, &acc, SABER_Q - 1);
+}
+
+// A * s, as in key generation, with and without the evaluated s
+
+static void matvec_ref(uint16_t res[SABER_K][SABER_N])
+{
+    memset(res, 0, SABER_K * SABER_N * sizeof(uint16_t));
+    MatrixVectorMul(mul_a, mul_s, NULL, res, SABER_Q - 1, 0);
+}
+
+static void matvec_fast(uint16_t res[SABER_K][SABER_N])
+{
+    toom4_eval_t skev[SABER_K];
+
+    memset(res, 0, SABER_K * SABER_N * sizeof(uint16_t));
+    MatrixVectorMul(mul_a, mul_s, EvalVector(skev, mul_s),
+        res, SABER_Q - 1, 0);
+}
+
+static uint64_t mul_time(void (*f)(uint16_t *, uint16_t *, uint16_t *),
+    void (*g)(uint16_t [SABER_K][SABER_N]))
+{
+    int i;
+    uint64_t clk[XBENCH_MUL];
+
+    if (f != NULL) {
+        XBENCH_CLK(clk, XBENCH_MUL, i, (void) 0,
+            f(mul_x[0], mul_a[0].vec[0].coeffs, mul_s[0]));
+    } else {
+        XBENCH_CLK(clk, XBENCH_MUL, i, (void) 0, g(mul_x));
+    }
+
+    return xbench_median(clk, XBENCH_MUL);
+}
+
+int main()
+{
+    int i, j, tr, fail[3];
+
+    if (!toom4_avx2_init()) {
+        printf("MUL no AVX2\t[%s]\n", CRYPTO_ALGNAME);
+        return 0;
+    }
+
+    srand(1);
+    memset(fail, 0, sizeof(fail));
+    for (i = 0; i < 1000; i++) {
+        xbench_rand(mul_a[0].vec[0].coeffs, SABER_N * sizeof(uint16_t));
+        xbench_rand(mul_s[0], SABER_N * sizeof(uint16_t));
+        pol_mul(mul_a[0].vec[0].coeffs, mul_s[0], mul_x[0],
+            SABER_Q, SABER_N, 0);
+        mul_fast(mul_y[0], mul_a[0].vec[0].coeffs, mul_s[0]);
+        fail[0] += memcmp(mul_x[0], mul_y[0],
+            SABER_N * sizeof(uint16_t)) != 0;
+    }
+    for (i = 0; i < 100; i++) {
+        xbench_rand(mul_a, sizeof(mul_a));
+        xbench_rand(mul_s, sizeof(mul_s));
+        for (tr = 0; tr < 2; tr++) {
+            for (j = 0; j < SABER_K; j++) {
+                xbench_rand(mul_x[j], sizeof(mul_x[j]));
+                memcpy(mul_y[j], mul_x[j], sizeof(mul_y[j]));
+            }
+            MatrixVectorMul(mul_a, mul_s, NULL, mul_x, SABER_Q - 1, tr);
+            MatrixVectorMul(mul_a, mul_s, EvalVector(mul_skev, mul_s),
+                mul_y, SABER_Q - 1, tr);
+            fail[1 + tr] += memcmp(mul_x, mul_y, sizeof(mul_x)) != 0;
+        }
+    }
+    if (fail[0] | fail[1] | fail[2]) {
+        printf("MUL avx2 differs from reference: "
+            "product %d/1000, A*s %d/100, A^T*s %d/100\t[%s]\n",
+            fail[0], fail[1], fail[2], CRYPTO_ALGNAME);
+        return 1;
+    }
+
+    xbench_print("MUL", "a * b", mul_time(mul_ref, NULL),
+        "avx2", mul_time(mul_fast, NULL), CRYPTO_ALGNAME);
+    xbench_print("MUL", "A * s", mul_time(NULL, matvec_ref),
+        "avx2", mul_time(NULL, matvec_fast), CRYPTO_ALGNAME);
+
+    return 0;
+}
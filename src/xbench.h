@@ -0,0 +1,70 @@
+// xbench.h
+// 2018-05-16  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Timing for the micro-benchmarks that replace kem_test.c
+
+#ifndef _XBENCH_H_
+#define _XBENCH_H_
+
+// The micro-benchmarks in src/ that take the place of kem_test.c check
+// the fast code of a candidate against the reference on random inputs,
+// exit with 1 if they differ, and then print one line per operation with
+// the median cycles of each and the speedup. This is the timing and
+// output they share.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// for __rdtsc()
+#include <x86intrin.h>
+
+// cycles of n runs of the statement op into clk[0..n-1]; the untimed
+// statement pre comes before each run, with i the run number
+
+#define XBENCH_CLK(clk, n, i, pre, op) do {         \
+        uint64_t xb_t;                              \
+        for (i = 0; i < (n); i++) {                 \
+            pre;                                    \
+            xb_t = __rdtsc();                       \
+            op;                                     \
+            (clk)[i] = __rdtsc() - xb_t;            \
+        }                                           \
+    } while (0)
+
+static inline int xbench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *((const uint64_t *) a), y = *((const uint64_t *) b);
+
+    return x < y ? -1 : x > y;
+}
+
+// median of clk[0..n-1]; sorts clk
+
+static inline uint64_t xbench_median(uint64_t *clk, int n)
+{
+    qsort(clk, n, sizeof(uint64_t), xbench_cmp_u64);
+
+    return clk[n / 2];
+}
+
+// n bytes from rand()
+
+static inline void xbench_rand(void *p, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        ((uint8_t *) p)[i] = (uint8_t) rand();
+}
+
+// "<tag> <name> ref <cycles> clk  <impl> <cycles> clk  x<speedup>  [<alg>]"
+
+static inline void xbench_print(const char *tag, const char *name,
+    uint64_t ref, const char *impl, uint64_t fast, const char *alg)
+{
+    printf("%s %-9s ref %10llu clk  %-6s %10llu clk  x%.2f\t[%s]\n",
+        tag, name, (unsigned long long) ref, impl,
+        (unsigned long long) fast, ((double) ref) / ((double) fast), alg);
+}
+
+#endif /* _XBENCH_H_ */
@@ -0,0 +1,56 @@
+// xkem.h
+// 2018-03-27  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Registry entry for a KEM candidate
+
+#ifndef _XKEM_H_
+#define _XKEM_H_
+
+#include <stddef.h>
+
+// candidate prototypes differ in constness, so entries are cast to these
+
+typedef int (*xkem_keypair_t)(unsigned char *pk, unsigned char *sk);
+typedef int (*xkem_enc_t)(unsigned char *ct, unsigned char *ss,
+                            const unsigned char *pk);
+typedef int (*xkem_dec_t)(unsigned char *ss, const unsigned char *ct,
+                            const unsigned char *sk);
+typedef int (*xkem_keypair_batch_t)(unsigned char *pk, unsigned char *sk,
+                            size_t n);
+typedef int (*xkem_enc_batch_t)(unsigned char *ct, unsigned char *ss,
+                            const unsigned char *pk, size_t n);
+typedef int (*xkem_dec_batch_t)(unsigned char *ss, const unsigned char *ct,
+                            const unsigned char *sk, size_t n);
+typedef int (*xkem_expand_pk_t)(unsigned char *epk, const unsigned char *pk);
+typedef int (*xkem_expand_sk_t)(unsigned char *esk, const unsigned char *sk);
+typedef void (*xkem_cache_flush_t)(void);
+typedef void (*xkem_rng_init_t)(unsigned char *entropy_input,
+                            unsigned char *personalization_string,
+                            int security_strength);
+
+typedef struct {
+    const char *name;               // CRYPTO_ALGNAME
+    int pk_bytes;                   // CRYPTO_PUBLICKEYBYTES
+    int sk_bytes;                   // CRYPTO_SECRETKEYBYTES
+    int ct_bytes;                   // CRYPTO_CIPHERTEXTBYTES
+    int ss_bytes;                   // CRYPTO_BYTES
+    int reps;                       // XBENCH_REPS
+    xkem_keypair_t keypair;         // crypto_kem_keypair()
+    xkem_enc_t enc;                 // crypto_kem_enc()
+    xkem_dec_t dec;                 // crypto_kem_dec()
+    xkem_rng_init_t rng_init;       // this candidate's randombytes_init()
+    int batch;                      // native batch code (CRYPTO_KEM_BATCH)
+    xkem_keypair_batch_t keypair_batch;
+    xkem_enc_batch_t enc_batch;
+    xkem_dec_batch_t dec_batch;
+    int expand;                     // native expanded keys (CRYPTO_KEM_EXPAND)
+    int epk_bytes;                  // CRYPTO_EXPANDEDPKBYTES
+    xkem_expand_pk_t expand_pk;     // crypto_kem_expand_pk()
+    xkem_enc_t enc_expanded;        // crypto_kem_enc_expanded(), epk for pk
+    xkem_enc_t enc_cached;          // crypto_kem_enc_cached()
+    xkem_cache_flush_t cache_flush; // crypto_kem_cache_flush()
+    int esk_bytes;                  // CRYPTO_EXPANDEDSKBYTES
+    xkem_expand_sk_t expand_sk;     // crypto_kem_expand_sk()
+    xkem_dec_t dec_expanded;        // crypto_kem_dec_expanded(), esk for sk
+} xkem_t;
+
+#endif /* _XKEM_H_ */
@@ -0,0 +1,29 @@
+#!/bin/bash
+# xkem_cc.sh
+# 2018-03-27  Markku-Juhani O. Saarinen <mjos@iki.fi>
+#
+# Stands in for $CC when build_multi.sh runs a candidate's build_test.sh.
+# Instead of linking $XKEM_BIN, everything is partially linked into a
+# single relocatable object $XKEM_OBJ, and the -l libraries are written
+# to $XKEM_OBJ.libs for the final link of the runner. The registry entry
+# in xkem_entry.c is named $XKEM_ENTRY.
+
+args=()
+libs=()
+skip=0
+for a in "$@"
+do
+	if [ $skip -eq 1 ]; then
+		skip=0
+		continue
+	fi
+	case "$a" in
+		-o)	skip=1 ;;
+		-l*)	libs+=("$a") ;;
+		*)	args+=("$a") ;;
+	esac
+done
+
+echo "${libs[@]}" > "$XKEM_OBJ.libs"
+exec $XKEM_CC -fcommon -r -Wl,-d -nostdlib -DXKEM_ENTRY=$XKEM_ENTRY \
+	-o "$XKEM_OBJ" "${args[@]}"
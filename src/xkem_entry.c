@@ -0,0 +1,57 @@
+// xkem_entry.c
+// 2018-03-27  Markku-Juhani O. Saarinen <mjos@iki.fi>
+//              Registry entry for the candidate in the current directory.
+//              Compiled into each candidate library by build_multi.sh with
+//              -DXKEM_ENTRY=xkem_<name>, or included by kem_test.c.
+
+#include "api.h"
+#include "rng.h"
+#include "kem_batch.h"
+#include "kem_expand.h"
+#include "xkem.h"
+
+#ifndef XBENCH_REPS
+#define XBENCH_REPS 20
+#endif
+
+#ifndef CRYPTO_ALGNAME
+#define CRYPTO_ALGNAME "UNKNOWN ALGORITHM"
+#endif
+
+#ifndef XKEM_ENTRY
+#define XKEM_ENTRY xkem_entry
+#endif
+
+const xkem_t XKEM_ENTRY = {
+    CRYPTO_ALGNAME,
+    CRYPTO_PUBLICKEYBYTES,
+    CRYPTO_SECRETKEYBYTES,
+    CRYPTO_CIPHERTEXTBYTES,
+    CRYPTO_BYTES,
+    XBENCH_REPS,
+    (xkem_keypair_t) crypto_kem_keypair,
+    (xkem_enc_t) crypto_kem_enc,
+    (xkem_dec_t) crypto_kem_dec,
+    (xkem_rng_init_t) randombytes_init,
+#ifdef CRYPTO_KEM_BATCH
+    1,
+#else
+    0,
+#endif
+    (xkem_keypair_batch_t) crypto_kem_keypair_batch,
+    (xkem_enc_batch_t) crypto_kem_enc_batch,
+    (xkem_dec_batch_t) crypto_kem_dec_batch,
+#ifdef CRYPTO_KEM_EXPAND
+    1,
+#else
+    0,
+#endif
+    CRYPTO_EXPANDEDPKBYTES,
+    (xkem_expand_pk_t) crypto_kem_expand_pk,
+    (xkem_enc_t) crypto_kem_enc_expanded,
+    (xkem_enc_t) crypto_kem_enc_cached,
+    (xkem_cache_flush_t) crypto_kem_cache_flush,
+    CRYPTO_EXPANDEDSKBYTES,
+    (xkem_expand_sk_t) crypto_kem_expand_sk,
+    (xkem_dec_t) crypto_kem_dec_expanded
+};
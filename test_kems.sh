@@ -5,22 +5,146 @@ if [ "$#" -ne 2 ]; then
     exit
 fi
 
-export CC='gcc'
-export CFLAGS='-Ofast'
-export XKEM_BIN='./xkem_test'
-export XKEM_SRC='../../../src/kem_test.c'
+export CC=${CC:-gcc}
+export CFLAGS=${CFLAGS:-'-Ofast -pthread'}
+export XKEM_SRC=`pwd`/src/kem_test.c
 
-for x in `cat $1 | tr '\n' ' '` 
+# e.g. XKEM_ARGS='-t 64' for the multi-threaded throughput test
+XKEM_ARGS=${XKEM_ARGS:-}
+
+# parallel builds, and wall-clock limit (seconds) for each benchmark run
+XKEM_JOBS=${XKEM_JOBS:-`nproc`}
+XKEM_LIMIT=${XKEM_LIMIT:-1200}
+
+# benchmarks run pinned to the cores in XKEM_CPUS (taskset list format);
+# XKEM_PAR > 1 runs that many at a time, each on a disjoint share of them.
+# The default is one at a time on the last core.
+XKEM_CPUS=${XKEM_CPUS:-$((`nproc` - 1))}
+XKEM_PAR=${XKEM_PAR:-1}
+
+# results of successful runs are cached by source hash and settings, so a
+# rerun only builds and runs candidates that changed or did not finish
+XKEM_CACHE=${XKEM_CACHE:-.xkem_cache}
+
+# JSON Lines records go next to the text report; see compare_reports.sh
+json_out=${2%.*}.jsonl
+export XKEM_GITREV=`git rev-parse --short HEAD 2>/dev/null || echo unknown`
+git diff --quiet HEAD 2>/dev/null || XKEM_GITREV="$XKEM_GITREV-dirty"
+
+base_dir=`pwd`
+work=`mktemp -d`
+trap "rm -rf $work" EXIT
+mkdir -p $XKEM_CACHE
+
+kems=(`cat $1 | tr '\n' ' '`)
+
+# cache key: candidate directory, harness, and settings
+
+harness=`cat src/kem_test.c src/xkem.h src/xkem_entry.c \
+	round1/nist/rng.c round1/nist/rng.h \
+	round1/nist/keccakx.c round1/nist/keccakx.h \
+	round1/nist/kem_batch.h round1/nist/kem_expand.h round1/nist/kem_cache.c \
+	| sha256sum | cut -c1-64`
+
+for x in ${kems[@]}
+do
+	kem=`basename $x`
+	key=`(cd $x && find . -type f ! -name xkem_test ! -name build.err \
+		-print0 | sort -z | xargs -0 cat; \
+		echo "$harness $CC $CFLAGS $XKEM_ARGS") | sha256sum | cut -c1-64`
+	echo $key > $work/$kem.key
+done
+
+# build what is not cached, XKEM_JOBS at a time
+
+for x in ${kems[@]}
 do
 	kem=`basename $x`
-	base_dir=`pwd`
-	echo -n "== $kem ==  "
-	date
-	cd $x
-	rm -f $XKEM_BIN build.err
-	./build_test.sh 2> build.err
-	$XKEM_BIN | tee -a $base_dir/$2
-	rm -f $XKEM_BIN
-	cd $base_dir
+	key=`cat $work/$kem.key`
+	[ -s $XKEM_CACHE/$key.out ] && continue
+	while [ `jobs -rp | wc -l` -ge $XKEM_JOBS ]
+	do
+		wait -n
+	done
+	echo "== $kem ==  building"
+	(cd $x && XKEM_BIN=$work/$kem.bin ./build_test.sh 2> $work/$kem.err) &
 done
+wait
 
+# split the benchmark cores into XKEM_PAR disjoint slots
+
+cpus=()
+for r in `echo $XKEM_CPUS | tr ',' ' '`
+do
+	if [[ $r == *-* ]]; then
+		for ((c = ${r%-*}; c <= ${r#*-}; c++))
+		do
+			cpus+=($c)
+		done
+	else
+		cpus+=($r)
+	fi
+done
+[ $XKEM_PAR -gt ${#cpus[@]} ] && XKEM_PAR=${#cpus[@]}
+per=$((${#cpus[@]} / $XKEM_PAR))
+
+# run slot $1 on cores $2: every XKEM_PAR'th candidate
+
+run_slot()
+{
+	for ((i = $1; i < ${#kems[@]}; i += $XKEM_PAR))
+	do
+		x=${kems[$i]}
+		kem=`basename $x`
+		key=`cat $work/$kem.key`
+		if [ -s $XKEM_CACHE/$key.out ]; then
+			echo "== $kem ==  cached"
+			continue
+		fi
+		if [ ! -x $work/$kem.bin ]; then
+			echo "== $kem ==  build failed"
+			cp $work/$kem.err $x/build.err
+			echo -e "KEM build failed\t[$kem]" > $work/$kem.out
+			continue
+		fi
+		echo -n "== $kem ==  cores $2  "
+		date
+		(cd $x && timeout $XKEM_LIMIT taskset -c $2 \
+			$work/$kem.bin $XKEM_ARGS -j $work/$kem.jsonl > $work/$kem.out)
+		ret=$?
+		cat $work/$kem.out
+		if [ $ret -eq 0 ]; then
+			cp $work/$kem.out $XKEM_CACHE/$key.out
+			touch $work/$kem.jsonl
+			cp $work/$kem.jsonl $XKEM_CACHE/$key.jsonl
+		elif [ $ret -eq 124 ]; then
+			echo -e "KEM run timed out after $XKEM_LIMIT s\t[$kem]" |
+				tee -a $work/$kem.out
+		else
+			echo -e "KEM run failed with status $ret\t[$kem]" |
+				tee -a $work/$kem.out
+		fi
+	done
+}
+
+for ((s = 0; s < $XKEM_PAR; s++))
+do
+	slot=`echo ${cpus[@]:$(($s * $per)):$per} | tr ' ' ','`
+	run_slot $s $slot &
+done
+wait
+
+# report in list order
+
+for x in ${kems[@]}
+do
+	kem=`basename $x`
+	key=`cat $work/$kem.key`
+	if [ -s $XKEM_CACHE/$key.out ]; then
+		cat $XKEM_CACHE/$key.out >> $2
+		cat $XKEM_CACHE/$key.jsonl >> $json_out
+	else
+		cat $work/$kem.out >> $2
+		[ -f $work/$kem.jsonl ] && cat $work/$kem.jsonl >> $json_out
+	fi
+done